@@ -25,12 +25,19 @@
 */
 
 #include "aria.h"
+#include "aria_arm.h"
+#include "aria_bitslice.h"
+#include "aria_block.h"
+#include "aria_stats.h"
+#include "aria_x86.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
 
 #ifdef ARIA_TEST
 #include <stdio.h>
 #include <inttypes.h>
-#include <stdlib.h>
-#include <string.h>
 #include "timer_e.h"
 #include "xorshift_e.h"
 #define WHEN_ARIA_TEST(x) x
@@ -457,6 +464,25 @@ compute_ek (aria_u128_t W0
 ** 
 */
 
+/* A on four 32-bit words, as the T-table engine below splits it: W replaces
+** each byte of a word with the XOR of the other three, M mixes the words
+** with each other, and P permutes the bytes of single words; then
+** A = M(P(M(W))).
+*/
+
+#define ARIA_T_W(t) \
+  do { uint32_t u_ = (t) ^ (((t) << 16) | ((t) >> 16)); (t) ^= u_ ^ ((u_ << 8) | (u_ >> 24)); } while (0)
+
+#define ARIA_T_M(t0, t1, t2, t3) \
+  do { t1 ^= t2; t2 ^= t3; t0 ^= t1; t3 ^= t1; t2 ^= t0; t1 ^= t2; } while (0)
+
+#define ARIA_T_P(ta, tb, tc, td) \
+  do { \
+    tb = ((tb << 8) & 0xff00ff00u) | ((tb >> 8) & 0x00ff00ffu); \
+    tc = (tc << 16) | (tc >> 16); \
+    td = (td << 24) | ((td << 8) & 0x00ff0000u) | ((td >> 8) & 0x0000ff00u) | (td >> 24); \
+  } while (0)
+
 static inline aria_u128_t aria_A (aria_u128_t x)
 {
   aria_u128_t y;
@@ -481,7 +507,7 @@ static inline aria_u128_t aria_A (aria_u128_t x)
    | ((uint64_t )(x0 ^ x3 ^ x6 ^ x7  ^ x8  ^ x10 ^ x13) << 16)
    | ((uint64_t )(x0 ^ x3 ^ x4 ^ x5  ^ x9  ^ x11 ^ x14) <<  8)
    |  (uint64_t )(x1 ^ x2 ^ x4 ^ x5  ^ x8  ^ x10 ^ x15);
-#else
+#elif 0
   /* For 1000000 iterations: 1104.03 ns (1104.03 ns) per iteration with 0 errors */
   /* eliminate some common subexpressions */
   uint8_t t0 = x0 ^ x7 ^ x10 ^ x13;
@@ -508,11 +534,261 @@ static inline aria_u128_t aria_A (aria_u128_t x)
    | ((uint64_t )(t0 ^ x3 ^ x6       ^ x8             ) << 16)
    | ((uint64_t )(x0 ^ t3      ^ x5        ^ x11      ) <<  8)
    |  (uint64_t )(x1 ^ t2 ^ x4             ^ x10      );
+#else
+  /* For 1000000 iterations: 770.89 ns (770.89 ns) per iteration with 0 errors */
+  /* whole words: no byte extraction, about a third of the operations */
+  uint32_t t0 = (uint32_t )(x.left  >> 32);
+  uint32_t t1 = (uint32_t )(x.left       );
+  uint32_t t2 = (uint32_t )(x.right >> 32);
+  uint32_t t3 = (uint32_t )(x.right      );
+
+  ARIA_T_W(t0);
+  ARIA_T_W(t1);
+  ARIA_T_W(t2);
+  ARIA_T_W(t3);
+  ARIA_T_M(t0, t1, t2, t3);
+  ARIA_T_P(t0, t1, t2, t3);
+  ARIA_T_M(t0, t1, t2, t3);
+
+  y.left  = ((uint64_t )t0 << 32) | t1;
+  y.right = ((uint64_t )t2 << 32) | t3;
 #endif
 
   return y;
 }
 
+/* T-table round engine
+**
+** The reference rounds above look up 16 bytes in SB1..SB4, then aria_A 
+** extracts the 16 bytes all over again to form the diffusion. Fast ARIA 
+** implementations instead view the state as four 32-bit words, and split A
+** into three cheap steps: a mix within each word, a mix of the words with
+** each other, and a few byte permutations of single words.
+**
+** The mix within each word is folded into the S-box tables: table TBn holds
+** SBn(v) replicated into the three bytes of the word other than its own
+** position, so one round is 16 word lookups and XORs, followed by
+**
+**    M(T0..T3):  T1 ^= T2, T2 ^= T3, T0 ^= T1, T3 ^= T1, T2 ^= T0, T1 ^= T2
+**    P(Ta..Td):  Tb swaps the bytes of each 16-bit half, Tc rotates by 16,
+**                Td is byte reversed
+**    M(T0..T3)
+**
+** with P applied to (T0,T1,T2,T3) in odd rounds and to (T2,T3,T0,T1) in even
+** rounds. The byte positions in SL2 use the same four tables in a different
+** order, so 4 KB of tables cover both round types.
+**
+** Build with -DARIA_USE_TTABLE=0 to leave the tables out; the key schedule
+** and the scalar backend then run the reference rounds instead.
+**
+** For 1000000 iterations 262144 keystride: 1151.96 ns (reference) vs
+** 450.461 ns (T-table) per iteration with 0 errors
+*/
+
+#ifndef ARIA_USE_TTABLE
+#define ARIA_USE_TTABLE 1
+#endif
+
+#if ARIA_USE_TTABLE
+
+static const uint32_t TB1[] = 
+{
+  /*                 0           1           2           3           4           5           6           7 */
+  /* 00 */  0x00636363, 0x007c7c7c, 0x00777777, 0x007b7b7b, 0x00f2f2f2, 0x006b6b6b, 0x006f6f6f, 0x00c5c5c5
+  /* 08 */, 0x00303030, 0x00010101, 0x00676767, 0x002b2b2b, 0x00fefefe, 0x00d7d7d7, 0x00ababab, 0x00767676
+  /* 10 */, 0x00cacaca, 0x00828282, 0x00c9c9c9, 0x007d7d7d, 0x00fafafa, 0x00595959, 0x00474747, 0x00f0f0f0
+  /* 18 */, 0x00adadad, 0x00d4d4d4, 0x00a2a2a2, 0x00afafaf, 0x009c9c9c, 0x00a4a4a4, 0x00727272, 0x00c0c0c0
+  /* 20 */, 0x00b7b7b7, 0x00fdfdfd, 0x00939393, 0x00262626, 0x00363636, 0x003f3f3f, 0x00f7f7f7, 0x00cccccc
+  /* 28 */, 0x00343434, 0x00a5a5a5, 0x00e5e5e5, 0x00f1f1f1, 0x00717171, 0x00d8d8d8, 0x00313131, 0x00151515
+  /* 30 */, 0x00040404, 0x00c7c7c7, 0x00232323, 0x00c3c3c3, 0x00181818, 0x00969696, 0x00050505, 0x009a9a9a
+  /* 38 */, 0x00070707, 0x00121212, 0x00808080, 0x00e2e2e2, 0x00ebebeb, 0x00272727, 0x00b2b2b2, 0x00757575
+  /* 40 */, 0x00090909, 0x00838383, 0x002c2c2c, 0x001a1a1a, 0x001b1b1b, 0x006e6e6e, 0x005a5a5a, 0x00a0a0a0
+  /* 48 */, 0x00525252, 0x003b3b3b, 0x00d6d6d6, 0x00b3b3b3, 0x00292929, 0x00e3e3e3, 0x002f2f2f, 0x00848484
+  /* 50 */, 0x00535353, 0x00d1d1d1, 0x00000000, 0x00ededed, 0x00202020, 0x00fcfcfc, 0x00b1b1b1, 0x005b5b5b
+  /* 58 */, 0x006a6a6a, 0x00cbcbcb, 0x00bebebe, 0x00393939, 0x004a4a4a, 0x004c4c4c, 0x00585858, 0x00cfcfcf
+  /* 60 */, 0x00d0d0d0, 0x00efefef, 0x00aaaaaa, 0x00fbfbfb, 0x00434343, 0x004d4d4d, 0x00333333, 0x00858585
+  /* 68 */, 0x00454545, 0x00f9f9f9, 0x00020202, 0x007f7f7f, 0x00505050, 0x003c3c3c, 0x009f9f9f, 0x00a8a8a8
+  /* 70 */, 0x00515151, 0x00a3a3a3, 0x00404040, 0x008f8f8f, 0x00929292, 0x009d9d9d, 0x00383838, 0x00f5f5f5
+  /* 78 */, 0x00bcbcbc, 0x00b6b6b6, 0x00dadada, 0x00212121, 0x00101010, 0x00ffffff, 0x00f3f3f3, 0x00d2d2d2
+  /* 80 */, 0x00cdcdcd, 0x000c0c0c, 0x00131313, 0x00ececec, 0x005f5f5f, 0x00979797, 0x00444444, 0x00171717
+  /* 88 */, 0x00c4c4c4, 0x00a7a7a7, 0x007e7e7e, 0x003d3d3d, 0x00646464, 0x005d5d5d, 0x00191919, 0x00737373
+  /* 90 */, 0x00606060, 0x00818181, 0x004f4f4f, 0x00dcdcdc, 0x00222222, 0x002a2a2a, 0x00909090, 0x00888888
+  /* 98 */, 0x00464646, 0x00eeeeee, 0x00b8b8b8, 0x00141414, 0x00dedede, 0x005e5e5e, 0x000b0b0b, 0x00dbdbdb
+  /* a0 */, 0x00e0e0e0, 0x00323232, 0x003a3a3a, 0x000a0a0a, 0x00494949, 0x00060606, 0x00242424, 0x005c5c5c
+  /* a8 */, 0x00c2c2c2, 0x00d3d3d3, 0x00acacac, 0x00626262, 0x00919191, 0x00959595, 0x00e4e4e4, 0x00797979
+  /* b0 */, 0x00e7e7e7, 0x00c8c8c8, 0x00373737, 0x006d6d6d, 0x008d8d8d, 0x00d5d5d5, 0x004e4e4e, 0x00a9a9a9
+  /* b8 */, 0x006c6c6c, 0x00565656, 0x00f4f4f4, 0x00eaeaea, 0x00656565, 0x007a7a7a, 0x00aeaeae, 0x00080808
+  /* c0 */, 0x00bababa, 0x00787878, 0x00252525, 0x002e2e2e, 0x001c1c1c, 0x00a6a6a6, 0x00b4b4b4, 0x00c6c6c6
+  /* c8 */, 0x00e8e8e8, 0x00dddddd, 0x00747474, 0x001f1f1f, 0x004b4b4b, 0x00bdbdbd, 0x008b8b8b, 0x008a8a8a
+  /* d0 */, 0x00707070, 0x003e3e3e, 0x00b5b5b5, 0x00666666, 0x00484848, 0x00030303, 0x00f6f6f6, 0x000e0e0e
+  /* d8 */, 0x00616161, 0x00353535, 0x00575757, 0x00b9b9b9, 0x00868686, 0x00c1c1c1, 0x001d1d1d, 0x009e9e9e
+  /* e0 */, 0x00e1e1e1, 0x00f8f8f8, 0x00989898, 0x00111111, 0x00696969, 0x00d9d9d9, 0x008e8e8e, 0x00949494
+  /* e8 */, 0x009b9b9b, 0x001e1e1e, 0x00878787, 0x00e9e9e9, 0x00cecece, 0x00555555, 0x00282828, 0x00dfdfdf
+  /* f0 */, 0x008c8c8c, 0x00a1a1a1, 0x00898989, 0x000d0d0d, 0x00bfbfbf, 0x00e6e6e6, 0x00424242, 0x00686868
+  /* f8 */, 0x00414141, 0x00999999, 0x002d2d2d, 0x000f0f0f, 0x00b0b0b0, 0x00545454, 0x00bbbbbb, 0x00161616
+};
+
+static const uint32_t TB2[] = 
+{
+  /*                 0           1           2           3           4           5           6           7 */
+  /* 00 */  0xe200e2e2, 0x4e004e4e, 0x54005454, 0xfc00fcfc, 0x94009494, 0xc200c2c2, 0x4a004a4a, 0xcc00cccc
+  /* 08 */, 0x62006262, 0x0d000d0d, 0x6a006a6a, 0x46004646, 0x3c003c3c, 0x4d004d4d, 0x8b008b8b, 0xd100d1d1
+  /* 10 */, 0x5e005e5e, 0xfa00fafa, 0x64006464, 0xcb00cbcb, 0xb400b4b4, 0x97009797, 0xbe00bebe, 0x2b002b2b
+  /* 18 */, 0xbc00bcbc, 0x77007777, 0x2e002e2e, 0x03000303, 0xd300d3d3, 0x19001919, 0x59005959, 0xc100c1c1
+  /* 20 */, 0x1d001d1d, 0x06000606, 0x41004141, 0x6b006b6b, 0x55005555, 0xf000f0f0, 0x99009999, 0x69006969
+  /* 28 */, 0xea00eaea, 0x9c009c9c, 0x18001818, 0xae00aeae, 0x63006363, 0xdf00dfdf, 0xe700e7e7, 0xbb00bbbb
+  /* 30 */, 0x00000000, 0x73007373, 0x66006666, 0xfb00fbfb, 0x96009696, 0x4c004c4c, 0x85008585, 0xe400e4e4
+  /* 38 */, 0x3a003a3a, 0x09000909, 0x45004545, 0xaa00aaaa, 0x0f000f0f, 0xee00eeee, 0x10001010, 0xeb00ebeb
+  /* 40 */, 0x2d002d2d, 0x7f007f7f, 0xf400f4f4, 0x29002929, 0xac00acac, 0xcf00cfcf, 0xad00adad, 0x91009191
+  /* 48 */, 0x8d008d8d, 0x78007878, 0xc800c8c8, 0x95009595, 0xf900f9f9, 0x2f002f2f, 0xce00cece, 0xcd00cdcd
+  /* 50 */, 0x08000808, 0x7a007a7a, 0x88008888, 0x38003838, 0x5c005c5c, 0x83008383, 0x2a002a2a, 0x28002828
+  /* 58 */, 0x47004747, 0xdb00dbdb, 0xb800b8b8, 0xc700c7c7, 0x93009393, 0xa400a4a4, 0x12001212, 0x53005353
+  /* 60 */, 0xff00ffff, 0x87008787, 0x0e000e0e, 0x31003131, 0x36003636, 0x21002121, 0x58005858, 0x48004848
+  /* 68 */, 0x01000101, 0x8e008e8e, 0x37003737, 0x74007474, 0x32003232, 0xca00caca, 0xe900e9e9, 0xb100b1b1
+  /* 70 */, 0xb700b7b7, 0xab00abab, 0x0c000c0c, 0xd700d7d7, 0xc400c4c4, 0x56005656, 0x42004242, 0x26002626
+  /* 78 */, 0x07000707, 0x98009898, 0x60006060, 0xd900d9d9, 0xb600b6b6, 0xb900b9b9, 0x11001111, 0x40004040
+  /* 80 */, 0xec00ecec, 0x20002020, 0x8c008c8c, 0xbd00bdbd, 0xa000a0a0, 0xc900c9c9, 0x84008484, 0x04000404
+  /* 88 */, 0x49004949, 0x23002323, 0xf100f1f1, 0x4f004f4f, 0x50005050, 0x1f001f1f, 0x13001313, 0xdc00dcdc
+  /* 90 */, 0xd800d8d8, 0xc000c0c0, 0x9e009e9e, 0x57005757, 0xe300e3e3, 0xc300c3c3, 0x7b007b7b, 0x65006565
+  /* 98 */, 0x3b003b3b, 0x02000202, 0x8f008f8f, 0x3e003e3e, 0xe800e8e8, 0x25002525, 0x92009292, 0xe500e5e5
+  /* a0 */, 0x15001515, 0xdd00dddd, 0xfd00fdfd, 0x17001717, 0xa900a9a9, 0xbf00bfbf, 0xd400d4d4, 0x9a009a9a
+  /* a8 */, 0x7e007e7e, 0xc500c5c5, 0x39003939, 0x67006767, 0xfe00fefe, 0x76007676, 0x9d009d9d, 0x43004343
+  /* b0 */, 0xa700a7a7, 0xe100e1e1, 0xd000d0d0, 0xf500f5f5, 0x68006868, 0xf200f2f2, 0x1b001b1b, 0x34003434
+  /* b8 */, 0x70007070, 0x05000505, 0xa300a3a3, 0x8a008a8a, 0xd500d5d5, 0x79007979, 0x86008686, 0xa800a8a8
+  /* c0 */, 0x30003030, 0xc600c6c6, 0x51005151, 0x4b004b4b, 0x1e001e1e, 0xa600a6a6, 0x27002727, 0xf600f6f6
+  /* c8 */, 0x35003535, 0xd200d2d2, 0x6e006e6e, 0x24002424, 0x16001616, 0x82008282, 0x5f005f5f, 0xda00dada
+  /* d0 */, 0xe600e6e6, 0x75007575, 0xa200a2a2, 0xef00efef, 0x2c002c2c, 0xb200b2b2, 0x1c001c1c, 0x9f009f9f
+  /* d8 */, 0x5d005d5d, 0x6f006f6f, 0x80008080, 0x0a000a0a, 0x72007272, 0x44004444, 0x9b009b9b, 0x6c006c6c
+  /* e0 */, 0x90009090, 0x0b000b0b, 0x5b005b5b, 0x33003333, 0x7d007d7d, 0x5a005a5a, 0x52005252, 0xf300f3f3
+  /* e8 */, 0x61006161, 0xa100a1a1, 0xf700f7f7, 0xb000b0b0, 0xd600d6d6, 0x3f003f3f, 0x7c007c7c, 0x6d006d6d
+  /* f0 */, 0xed00eded, 0x14001414, 0xe000e0e0, 0xa500a5a5, 0x3d003d3d, 0x22002222, 0xb300b3b3, 0xf800f8f8
+  /* f8 */, 0x89008989, 0xde00dede, 0x71007171, 0x1a001a1a, 0xaf00afaf, 0xba00baba, 0xb500b5b5, 0x81008181
+};
+
+static const uint32_t TB3[] = 
+{
+  /*                 0           1           2           3           4           5           6           7 */
+  /* 00 */  0x52520052, 0x09090009, 0x6a6a006a, 0xd5d500d5, 0x30300030, 0x36360036, 0xa5a500a5, 0x38380038
+  /* 08 */, 0xbfbf00bf, 0x40400040, 0xa3a300a3, 0x9e9e009e, 0x81810081, 0xf3f300f3, 0xd7d700d7, 0xfbfb00fb
+  /* 10 */, 0x7c7c007c, 0xe3e300e3, 0x39390039, 0x82820082, 0x9b9b009b, 0x2f2f002f, 0xffff00ff, 0x87870087
+  /* 18 */, 0x34340034, 0x8e8e008e, 0x43430043, 0x44440044, 0xc4c400c4, 0xdede00de, 0xe9e900e9, 0xcbcb00cb
+  /* 20 */, 0x54540054, 0x7b7b007b, 0x94940094, 0x32320032, 0xa6a600a6, 0xc2c200c2, 0x23230023, 0x3d3d003d
+  /* 28 */, 0xeeee00ee, 0x4c4c004c, 0x95950095, 0x0b0b000b, 0x42420042, 0xfafa00fa, 0xc3c300c3, 0x4e4e004e
+  /* 30 */, 0x08080008, 0x2e2e002e, 0xa1a100a1, 0x66660066, 0x28280028, 0xd9d900d9, 0x24240024, 0xb2b200b2
+  /* 38 */, 0x76760076, 0x5b5b005b, 0xa2a200a2, 0x49490049, 0x6d6d006d, 0x8b8b008b, 0xd1d100d1, 0x25250025
+  /* 40 */, 0x72720072, 0xf8f800f8, 0xf6f600f6, 0x64640064, 0x86860086, 0x68680068, 0x98980098, 0x16160016
+  /* 48 */, 0xd4d400d4, 0xa4a400a4, 0x5c5c005c, 0xcccc00cc, 0x5d5d005d, 0x65650065, 0xb6b600b6, 0x92920092
+  /* 50 */, 0x6c6c006c, 0x70700070, 0x48480048, 0x50500050, 0xfdfd00fd, 0xeded00ed, 0xb9b900b9, 0xdada00da
+  /* 58 */, 0x5e5e005e, 0x15150015, 0x46460046, 0x57570057, 0xa7a700a7, 0x8d8d008d, 0x9d9d009d, 0x84840084
+  /* 60 */, 0x90900090, 0xd8d800d8, 0xabab00ab, 0x00000000, 0x8c8c008c, 0xbcbc00bc, 0xd3d300d3, 0x0a0a000a
+  /* 68 */, 0xf7f700f7, 0xe4e400e4, 0x58580058, 0x05050005, 0xb8b800b8, 0xb3b300b3, 0x45450045, 0x06060006
+  /* 70 */, 0xd0d000d0, 0x2c2c002c, 0x1e1e001e, 0x8f8f008f, 0xcaca00ca, 0x3f3f003f, 0x0f0f000f, 0x02020002
+  /* 78 */, 0xc1c100c1, 0xafaf00af, 0xbdbd00bd, 0x03030003, 0x01010001, 0x13130013, 0x8a8a008a, 0x6b6b006b
+  /* 80 */, 0x3a3a003a, 0x91910091, 0x11110011, 0x41410041, 0x4f4f004f, 0x67670067, 0xdcdc00dc, 0xeaea00ea
+  /* 88 */, 0x97970097, 0xf2f200f2, 0xcfcf00cf, 0xcece00ce, 0xf0f000f0, 0xb4b400b4, 0xe6e600e6, 0x73730073
+  /* 90 */, 0x96960096, 0xacac00ac, 0x74740074, 0x22220022, 0xe7e700e7, 0xadad00ad, 0x35350035, 0x85850085
+  /* 98 */, 0xe2e200e2, 0xf9f900f9, 0x37370037, 0xe8e800e8, 0x1c1c001c, 0x75750075, 0xdfdf00df, 0x6e6e006e
+  /* a0 */, 0x47470047, 0xf1f100f1, 0x1a1a001a, 0x71710071, 0x1d1d001d, 0x29290029, 0xc5c500c5, 0x89890089
+  /* a8 */, 0x6f6f006f, 0xb7b700b7, 0x62620062, 0x0e0e000e, 0xaaaa00aa, 0x18180018, 0xbebe00be, 0x1b1b001b
+  /* b0 */, 0xfcfc00fc, 0x56560056, 0x3e3e003e, 0x4b4b004b, 0xc6c600c6, 0xd2d200d2, 0x79790079, 0x20200020
+  /* b8 */, 0x9a9a009a, 0xdbdb00db, 0xc0c000c0, 0xfefe00fe, 0x78780078, 0xcdcd00cd, 0x5a5a005a, 0xf4f400f4
+  /* c0 */, 0x1f1f001f, 0xdddd00dd, 0xa8a800a8, 0x33330033, 0x88880088, 0x07070007, 0xc7c700c7, 0x31310031
+  /* c8 */, 0xb1b100b1, 0x12120012, 0x10100010, 0x59590059, 0x27270027, 0x80800080, 0xecec00ec, 0x5f5f005f
+  /* d0 */, 0x60600060, 0x51510051, 0x7f7f007f, 0xa9a900a9, 0x19190019, 0xb5b500b5, 0x4a4a004a, 0x0d0d000d
+  /* d8 */, 0x2d2d002d, 0xe5e500e5, 0x7a7a007a, 0x9f9f009f, 0x93930093, 0xc9c900c9, 0x9c9c009c, 0xefef00ef
+  /* e0 */, 0xa0a000a0, 0xe0e000e0, 0x3b3b003b, 0x4d4d004d, 0xaeae00ae, 0x2a2a002a, 0xf5f500f5, 0xb0b000b0
+  /* e8 */, 0xc8c800c8, 0xebeb00eb, 0xbbbb00bb, 0x3c3c003c, 0x83830083, 0x53530053, 0x99990099, 0x61610061
+  /* f0 */, 0x17170017, 0x2b2b002b, 0x04040004, 0x7e7e007e, 0xbaba00ba, 0x77770077, 0xd6d600d6, 0x26260026
+  /* f8 */, 0xe1e100e1, 0x69690069, 0x14140014, 0x63630063, 0x55550055, 0x21210021, 0x0c0c000c, 0x7d7d007d
+};
+
+static const uint32_t TB4[] = 
+{
+  /*                 0           1           2           3           4           5           6           7 */
+  /* 00 */  0x30303000, 0x68686800, 0x99999900, 0x1b1b1b00, 0x87878700, 0xb9b9b900, 0x21212100, 0x78787800
+  /* 08 */, 0x50505000, 0x39393900, 0xdbdbdb00, 0xe1e1e100, 0x72727200, 0x09090900, 0x62626200, 0x3c3c3c00
+  /* 10 */, 0x3e3e3e00, 0x7e7e7e00, 0x5e5e5e00, 0x8e8e8e00, 0xf1f1f100, 0xa0a0a000, 0xcccccc00, 0xa3a3a300
+  /* 18 */, 0x2a2a2a00, 0x1d1d1d00, 0xfbfbfb00, 0xb6b6b600, 0xd6d6d600, 0x20202000, 0xc4c4c400, 0x8d8d8d00
+  /* 20 */, 0x81818100, 0x65656500, 0xf5f5f500, 0x89898900, 0xcbcbcb00, 0x9d9d9d00, 0x77777700, 0xc6c6c600
+  /* 28 */, 0x57575700, 0x43434300, 0x56565600, 0x17171700, 0xd4d4d400, 0x40404000, 0x1a1a1a00, 0x4d4d4d00
+  /* 30 */, 0xc0c0c000, 0x63636300, 0x6c6c6c00, 0xe3e3e300, 0xb7b7b700, 0xc8c8c800, 0x64646400, 0x6a6a6a00
+  /* 38 */, 0x53535300, 0xaaaaaa00, 0x38383800, 0x98989800, 0x0c0c0c00, 0xf4f4f400, 0x9b9b9b00, 0xededed00
+  /* 40 */, 0x7f7f7f00, 0x22222200, 0x76767600, 0xafafaf00, 0xdddddd00, 0x3a3a3a00, 0x0b0b0b00, 0x58585800
+  /* 48 */, 0x67676700, 0x88888800, 0x06060600, 0xc3c3c300, 0x35353500, 0x0d0d0d00, 0x01010100, 0x8b8b8b00
+  /* 50 */, 0x8c8c8c00, 0xc2c2c200, 0xe6e6e600, 0x5f5f5f00, 0x02020200, 0x24242400, 0x75757500, 0x93939300
+  /* 58 */, 0x66666600, 0x1e1e1e00, 0xe5e5e500, 0xe2e2e200, 0x54545400, 0xd8d8d800, 0x10101000, 0xcecece00
+  /* 60 */, 0x7a7a7a00, 0xe8e8e800, 0x08080800, 0x2c2c2c00, 0x12121200, 0x97979700, 0x32323200, 0xababab00
+  /* 68 */, 0xb4b4b400, 0x27272700, 0x0a0a0a00, 0x23232300, 0xdfdfdf00, 0xefefef00, 0xcacaca00, 0xd9d9d900
+  /* 70 */, 0xb8b8b800, 0xfafafa00, 0xdcdcdc00, 0x31313100, 0x6b6b6b00, 0xd1d1d100, 0xadadad00, 0x19191900
+  /* 78 */, 0x49494900, 0xbdbdbd00, 0x51515100, 0x96969600, 0xeeeeee00, 0xe4e4e400, 0xa8a8a800, 0x41414100
+  /* 80 */, 0xdadada00, 0xffffff00, 0xcdcdcd00, 0x55555500, 0x86868600, 0x36363600, 0xbebebe00, 0x61616100
+  /* 88 */, 0x52525200, 0xf8f8f800, 0xbbbbbb00, 0x0e0e0e00, 0x82828200, 0x48484800, 0x69696900, 0x9a9a9a00
+  /* 90 */, 0xe0e0e000, 0x47474700, 0x9e9e9e00, 0x5c5c5c00, 0x04040400, 0x4b4b4b00, 0x34343400, 0x15151500
+  /* 98 */, 0x79797900, 0x26262600, 0xa7a7a700, 0xdedede00, 0x29292900, 0xaeaeae00, 0x92929200, 0xd7d7d700
+  /* a0 */, 0x84848400, 0xe9e9e900, 0xd2d2d200, 0xbababa00, 0x5d5d5d00, 0xf3f3f300, 0xc5c5c500, 0xb0b0b000
+  /* a8 */, 0xbfbfbf00, 0xa4a4a400, 0x3b3b3b00, 0x71717100, 0x44444400, 0x46464600, 0x2b2b2b00, 0xfcfcfc00
+  /* b0 */, 0xebebeb00, 0x6f6f6f00, 0xd5d5d500, 0xf6f6f600, 0x14141400, 0xfefefe00, 0x7c7c7c00, 0x70707000
+  /* b8 */, 0x5a5a5a00, 0x7d7d7d00, 0xfdfdfd00, 0x2f2f2f00, 0x18181800, 0x83838300, 0x16161600, 0xa5a5a500
+  /* c0 */, 0x91919100, 0x1f1f1f00, 0x05050500, 0x95959500, 0x74747400, 0xa9a9a900, 0xc1c1c100, 0x5b5b5b00
+  /* c8 */, 0x4a4a4a00, 0x85858500, 0x6d6d6d00, 0x13131300, 0x07070700, 0x4f4f4f00, 0x4e4e4e00, 0x45454500
+  /* d0 */, 0xb2b2b200, 0x0f0f0f00, 0xc9c9c900, 0x1c1c1c00, 0xa6a6a600, 0xbcbcbc00, 0xececec00, 0x73737300
+  /* d8 */, 0x90909000, 0x7b7b7b00, 0xcfcfcf00, 0x59595900, 0x8f8f8f00, 0xa1a1a100, 0xf9f9f900, 0x2d2d2d00
+  /* e0 */, 0xf2f2f200, 0xb1b1b100, 0x00000000, 0x94949400, 0x37373700, 0x9f9f9f00, 0xd0d0d000, 0x2e2e2e00
+  /* e8 */, 0x9c9c9c00, 0x6e6e6e00, 0x28282800, 0x3f3f3f00, 0x80808000, 0xf0f0f000, 0x3d3d3d00, 0xd3d3d300
+  /* f0 */, 0x25252500, 0x8a8a8a00, 0xb5b5b500, 0xe7e7e700, 0x42424200, 0xb3b3b300, 0xc7c7c700, 0xeaeaea00
+  /* f8 */, 0xf7f7f700, 0x4c4c4c00, 0x11111100, 0x33333300, 0x03030300, 0xa2a2a200, 0xacacac00, 0x60606000
+};
+
+#define ARIA_T_SL1(t) \
+  (TB1[(t) >> 24] ^ TB2[((t) >> 16) & 0xff] ^ TB3[((t) >> 8) & 0xff] ^ TB4[(t) & 0xff])
+
+#define ARIA_T_SL2(t) \
+  (TB3[(t) >> 24] ^ TB4[((t) >> 16) & 0xff] ^ TB1[((t) >> 8) & 0xff] ^ TB2[(t) & 0xff])
+
+static inline aria_u128_t aria_T_FO (aria_u128_t d, aria_u128_t rk)
+{
+  aria_u128_t z = xor(d, rk);
+  uint32_t t0 = (uint32_t )(z.left  >> 32);
+  uint32_t t1 = (uint32_t )(z.left       );
+  uint32_t t2 = (uint32_t )(z.right >> 32);
+  uint32_t t3 = (uint32_t )(z.right      );
+
+  t0 = ARIA_T_SL1(t0);
+  t1 = ARIA_T_SL1(t1);
+  t2 = ARIA_T_SL1(t2);
+  t3 = ARIA_T_SL1(t3);
+  ARIA_T_M(t0, t1, t2, t3);
+  ARIA_T_P(t0, t1, t2, t3);
+  ARIA_T_M(t0, t1, t2, t3);
+
+  z.left  = ((uint64_t )t0 << 32) | t1;
+  z.right = ((uint64_t )t2 << 32) | t3;
+  return z;
+}
+
+static inline aria_u128_t aria_T_FE (aria_u128_t d, aria_u128_t rk)
+{
+  aria_u128_t z = xor(d, rk);
+  uint32_t t0 = (uint32_t )(z.left  >> 32);
+  uint32_t t1 = (uint32_t )(z.left       );
+  uint32_t t2 = (uint32_t )(z.right >> 32);
+  uint32_t t3 = (uint32_t )(z.right      );
+
+  t0 = ARIA_T_SL2(t0);
+  t1 = ARIA_T_SL2(t1);
+  t2 = ARIA_T_SL2(t2);
+  t3 = ARIA_T_SL2(t3);
+  ARIA_T_M(t0, t1, t2, t3);
+  ARIA_T_P(t2, t3, t0, t1);
+  ARIA_T_M(t0, t1, t2, t3);
+
+  z.left  = ((uint64_t )t0 << 32) | t1;
+  z.right = ((uint64_t )t2 << 32) | t3;
+  return z;
+}
+
+#endif /* ARIA_USE_TTABLE */
+
 /* 
 ** 2.4.1.  Round Functions
 ** 
@@ -534,10 +810,30 @@ static inline aria_u128_t aria_A (aria_u128_t x)
 
 static inline aria_u128_t aria_FO (aria_u128_t d, aria_u128_t rk)
 {
+#if ARIA_USE_TTABLE
+  return aria_T_FO(d, rk);
+#else
   return aria_A(aria_SL1(xor(d, rk)));
+#endif
 }
 
 static inline aria_u128_t aria_FE (aria_u128_t d, aria_u128_t rk)
+{
+#if ARIA_USE_TTABLE
+  return aria_T_FE(d, rk);
+#else
+  return aria_A(aria_SL2(xor(d, rk)));
+#endif
+}
+
+/* The same, always with the reference rounds */
+
+static inline aria_u128_t aria_R_FO (aria_u128_t d, aria_u128_t rk)
+{
+  return aria_A(aria_SL1(xor(d, rk)));
+}
+
+static inline aria_u128_t aria_R_FE (aria_u128_t d, aria_u128_t rk)
 {
   return aria_A(aria_SL2(xor(d, rk)));
 }
@@ -607,421 +903,2574 @@ static inline aria_u128_t aria_FE (aria_u128_t d, aria_u128_t rk)
 **    C  = SL2(P15 ^ ek16) ^ ek17;     // Round 16
 */
 
-aria_u128_t 
-aria_crypt (aria_key_schedule_t *ks, aria_u128_t text)
+/* The reference backend: the rounds exactly as written in the RFC */
+
+static aria_u128_t
+aria_reference_crypt (const aria_key_schedule_t *ks, aria_u128_t text)
 {
-  aria_u128_t p = aria_FO(text, ks->ek[1]);
+  aria_u128_t p = aria_R_FO(text, ks->ek[1]);
   for (uint32_t i = 2u; i < ks->rounds; )
   {
-    p = aria_FE(p, ks->ek[i++]);
-    p = aria_FO(p, ks->ek[i++]);
+    p = aria_R_FE(p, ks->ek[i++]);
+    p = aria_R_FO(p, ks->ek[i++]);
   }
   return xor(aria_SL2(xor(p, ks->ek[ks->rounds])), ks->ek[ks->rounds + 1]);
 }
 
-/*
-** 2.2.  Key Scheduling Part
-** 
-**    Let K denote a master key of 128, 192, or 256 bits.  Given the master
-**    key K, we first define 128-bit values KL and KR as follows.
-** 
-**    KL || KR = K || 0 ... 0,
-** 
-**    where the number of zeros is 128, 64, or 0, depending on the size of
-**    K.  That is, KL is set to the leftmost 128 bits of K and KR is set to
-**    the remaining bits of K (if any), right-padded with zeros to a
-**    128-bit value.  Then, we define four 128-bit values (W0, W1, W2, and
-**    W3) as the intermediate round values appearing in the encryption of
-**    KL || KR by a 3-round, 256-bit Feistel cipher.
-** 
-**    W0 = KL,
-**    W1 = FO(W0, CK1) ^ KR,
-**    W2 = FE(W1, CK2) ^ W0,
-**    W3 = FO(W2, CK3) ^ W1.
-** 
-**    Here, FO and FE, respectively called odd and even round functions,
-**    are defined in Section 2.4.1.  CK1, CK2, and CK3 are 128-bit
-**    constants, taking one of the following values.
-** 
-**    C1 =  0x517cc1b727220a94fe13abe8fa9a6ee0
-**    C2 =  0x6db14acc9e21c820ff28b1d5ef5de2b0
-**    C3 =  0xdb92371d2126e9700324977504e8c90e
-** 
-**    These values are obtained from the first 128*3 bits of the fractional
-**    part of 1/PI, where PI is the circle ratio.  Now the constants CK1,
-**    CK2, and CK3 are defined by the following table.
-** 
-**        Key size  CK1  CK2  CK3
-**          128     C1   C2   C3
-**          192     C2   C3   C1
-**          256     C3   C1   C2
-** 
-**    For example, if the key size is 192 bits, CK1 = C2, CK2 = C3, and
-**    CK3 = C1.
-*/
+static void
+aria_reference_crypt_blocks (const aria_key_schedule_t *ks
+                           , const aria_u128_t *in
+                           , aria_u128_t       *out
+                           , size_t             count)
+{
+  for (; count > 0u; count--)
+  {
+    *out++ = aria_reference_crypt(ks, *in++);
+  }
+}
 
-static const aria_u128_t C1 = { 0x517cc1b727220a94, 0xfe13abe8fa9a6ee0 };
-static const aria_u128_t C2 = { 0x6db14acc9e21c820, 0xff28b1d5ef5de2b0 };
-static const aria_u128_t C3 = { 0xdb92371d2126e970, 0x0324977504e8c90e };
+#if ARIA_USE_TTABLE
 
-/*
-**    The number of rounds depends on the size of the master key as
-**    follows.
-** 
-**         Key size     Number of Rounds
-**          128              12
-**          192              14
-**          256              16
-** 
-**    Due to an extra key addition layer in the last round, 12-, 14-, and
-**    16-round algorithms require 13, 15, and 17 round keys, respectively.
-** 
-**    Decryption round keys are derived from the encryption round keys.
-** 
-**    dk1 = ek{n+1},
-**    dk2 = A(ek{n}),
-**    dk3 = A(ek{n-1}),
-**    ...,
-**    dk{n}= A(ek2),
-**    dk{n+1}= ek1.
-** 
-**    Here, A and n denote the diffusion layer of ARIA and the number of
-**    rounds, respectively.  The diffusion layer A is defined in Section
-**    2.4.3.
-*/
-/* 
-** 2.3.2.  Decryption Process
-** 
-**    The decryption process of ARIA is the same as the encryption process
-**    except that encryption round keys are replaced by decryption round
-**    keys.  For example, encryption round keys ek1, ..., ek13 of the
-**    12-round ARIA algorithm are replaced by decryption round keys dk1,
-**    ..., dk13, respectively.
+/* The T-table backend */
+
+static aria_u128_t
+aria_ttable_crypt (const aria_key_schedule_t *ks, aria_u128_t text)
+{
+  aria_u128_t p = aria_T_FO(text, ks->ek[1]);
+  for (uint32_t i = 2u; i < ks->rounds; )
+  {
+    p = aria_T_FE(p, ks->ek[i++]);
+    p = aria_T_FO(p, ks->ek[i++]);
+  }
+  return xor(aria_SL2(xor(p, ks->ek[ks->rounds])), ks->ek[ks->rounds + 1]);
+}
+
+/* Multi-block processing
+**
+** A single block is one long dependent chain: every S-box lookup in round i
+** needs the result of round i-1. Running ARIA_LANES independent blocks in
+** lockstep gives the CPU that many chains to overlap, and loads each round
+** key once for all of them. Four lanes keep the state (two uint64_t per
+** block) in registers on x86_64 with room left for the T-table temporaries.
 */
 
-aria_error_code_t 
-aria_init_key_schedule (aria_key_schedule_t *keysched
-                      , aria_u128_t        KeyLeft
-                      , aria_u128_t        KeyRight
-                      , aria_cryto_mode_t  mode
-                      , uint32_t key_size_in_bits)
+#define ARIA_LANES 4u
+
+static inline void
+aria_ttable_crypt_lanes (const aria_key_schedule_t *ks, const aria_u128_t *in, aria_u128_t *out)
 {
-  aria_u128_t CK1;
-  aria_u128_t CK2;
-  aria_u128_t CK3;
-  uint32_t rounds = 0u;
+  aria_u128_t rk = ks->ek[1];
+  aria_u128_t p0 = aria_T_FO(in[0], rk);
+  aria_u128_t p1 = aria_T_FO(in[1], rk);
+  aria_u128_t p2 = aria_T_FO(in[2], rk);
+  aria_u128_t p3 = aria_T_FO(in[3], rk);
 
-  if (NULL == keysched)
+  for (uint32_t i = 2u; i < ks->rounds; )
   {
-    return ARG_BAD;
+    rk = ks->ek[i++];
+    p0 = aria_T_FE(p0, rk);
+    p1 = aria_T_FE(p1, rk);
+    p2 = aria_T_FE(p2, rk);
+    p3 = aria_T_FE(p3, rk);
+    rk = ks->ek[i++];
+    p0 = aria_T_FO(p0, rk);
+    p1 = aria_T_FO(p1, rk);
+    p2 = aria_T_FO(p2, rk);
+    p3 = aria_T_FO(p3, rk);
   }
-  switch (key_size_in_bits)
+  rk = ks->ek[ks->rounds];
+  aria_u128_t rl = ks->ek[ks->rounds + 1];
+  out[0] = xor(aria_SL2(xor(p0, rk)), rl);
+  out[1] = xor(aria_SL2(xor(p1, rk)), rl);
+  out[2] = xor(aria_SL2(xor(p2, rk)), rl);
+  out[3] = xor(aria_SL2(xor(p3, rk)), rl);
+}
+
+static void
+aria_ttable_crypt_blocks (const aria_key_schedule_t *ks
+                        , const aria_u128_t *in
+                        , aria_u128_t       *out
+                        , size_t             count)
+{
+  for (; count >= ARIA_LANES; count -= ARIA_LANES)
   {
-    case 256:
-      rounds = keysched->rounds = 16u;
-      CK1 = C3;
-      CK2 = C1;
-      CK3 = C2;
-      break;
-    case 192:
-      rounds = keysched->rounds = 14u;
-      CK1 = C2;
-      CK2 = C3;
-      CK3 = C1;
-      KeyRight.right = 0u;
-      break;
-    case 128:
-      rounds = keysched->rounds = 12u;
-      CK1 = C1;
-      CK2 = C2;
-      CK3 = C3;
-      KeyRight.left  = 0u;
-      KeyRight.right = 0u;
-      break;
-    default:
-      return KEY_SIZE_BAD;
+    aria_ttable_crypt_lanes(ks, in, out);
+    in  += ARIA_LANES;
+    out += ARIA_LANES;
   }
-  switch (mode)
+  for (; count > 0u; count--)
   {
-    case ENCRYPT:
-      keysched->mode = ENCRYPT;
-      break;
-    case DECRYPT:
-      keysched->mode = DECRYPT;
-      break;
-    default:
-      return CRYPTO_MODE_BAD;
+    *out++ = aria_ttable_crypt(ks, *in++);
   }
-  aria_u128_t W0 = KeyLeft;
-  aria_u128_t W1 = xor(aria_FO(W0, CK1), KeyRight);
-  aria_u128_t W2 = xor(aria_FE(W1, CK2), W0);
-  aria_u128_t W3 = xor(aria_FO(W2, CK3), W1);
+}
 
-  compute_ek(W0, W1, W2, W3, keysched->ek);
+/* Specialized round loops
+**
+** The key size is fixed when the schedule is made, so each round count gets
+** its own fully unrolled copy of the loops above, from aria_rounds.h. The
+** dispatch table holds one per round count, picked by ks->rounds; the loops
+** above remain for a schedule with any other round count.
+*/
 
-  if (DECRYPT == mode)
-  {
-    keysched->ek[ 0] = keysched->ek[rounds + 1];
-    keysched->ek[rounds + 1] = keysched->ek[ 1];
-    keysched->ek[ 1] = keysched->ek[ 0];
+#define ARIA_R_FO aria_T_FO
+#define ARIA_R_FE aria_T_FE
 
-    for (uint32_t i = 2, j = rounds; i < j; i++, j--)
-    {
-      keysched->ek[ 0] = keysched->ek[ j];
-      keysched->ek[ j] = aria_A(keysched->ek[ i]);
-      keysched->ek[ i] = aria_A(keysched->ek[ 0]);
-    }
-    rounds = (rounds / 2u) + 1u;
-    keysched->ek[rounds] = aria_A(keysched->ek[rounds]);
-  }
-  return NO_ERROR;
-}
+#define ARIA_R_NAME(x) aria_ttable_##x##_12
+#define ARIA_R_ROUNDS  12
+#include "aria_rounds.h"
+#undef ARIA_R_NAME
+#undef ARIA_R_ROUNDS
 
+#define ARIA_R_NAME(x) aria_ttable_##x##_14
+#define ARIA_R_ROUNDS  14
+#include "aria_rounds.h"
+#undef ARIA_R_NAME
+#undef ARIA_R_ROUNDS
 
-#ifdef ARIA_TEST
+#define ARIA_R_NAME(x) aria_ttable_##x##_16
+#define ARIA_R_ROUNDS  16
+#include "aria_rounds.h"
+#undef ARIA_R_NAME
+#undef ARIA_R_ROUNDS
 
-static aria_u128_t 
-aria_encrypt_128 (aria_u128_t Key, aria_u128_t Plaintext)
-{
-  aria_key_schedule_t ks;
+#undef ARIA_R_FO
+#undef ARIA_R_FE
 
-  aria_error_code_t err = aria_init_key_schedule(&ks, Key, /* don't care */ Key, ENCRYPT, 128u);
+#define ARIA_SCALAR_CRYPT \
+  { aria_ttable_crypt_12, aria_ttable_crypt_14, aria_ttable_crypt_16, aria_ttable_crypt }
+#define ARIA_SCALAR_CRYPT_BLOCKS \
+  { aria_ttable_crypt_blocks_12, aria_ttable_crypt_blocks_14, aria_ttable_crypt_blocks_16, aria_ttable_crypt_blocks }
 
-  if (NO_ERROR != err)
-  {
-    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
-  }
-  return aria_crypt(&ks, Plaintext);
-}
+#else
 
-static aria_u128_t 
-aria_encrypt_192 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Plaintext)
-{
-  aria_key_schedule_t ks;
+#define ARIA_SCALAR_CRYPT \
+  { aria_reference_crypt, aria_reference_crypt, aria_reference_crypt, aria_reference_crypt }
+#define ARIA_SCALAR_CRYPT_BLOCKS \
+  { aria_reference_crypt_blocks, aria_reference_crypt_blocks, aria_reference_crypt_blocks, aria_reference_crypt_blocks }
 
-  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, ENCRYPT, 192u);
+#endif /* ARIA_USE_TTABLE */
 
-  if (NO_ERROR != err)
-  {
-    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
-  }
-  return aria_crypt(&ks, Plaintext);
-}
+/* Backend dispatch
+**
+** One binary has to run well on whatever CPU it lands on, so aria_crypt()
+** and aria_crypt_blocks() call through the table aria_dispatch points to
+** rather than testing CPU features on every call. It starts out pointing
+** at a table of resolvers: the first call picks a backend, once however
+** many threads make it, fills in and publishes the bound table, and
+** forwards; every later call goes straight to the backend.
+**
+** The backend picked is the one named by the environment variable
+** ARIA_BACKEND, if the CPU supports it, else the fastest one supported, in
+** the order gfni, avx2, aesni, ssse3 (x86), neonaes, neon (AArch64), ttable,
+** reference. aria_set_backend() replaces the choice, e.g. for A/B
+** benchmarking. The bitsliced backend is never picked automatically: its
+** encryption and decryption are constant time (key setup, on the tables, is
+** not) but, on a CPU with SIMD S-boxes, slower, so it has to be asked for.
+**
+** A bulk call runs the backend's wide kernel (32 blocks per pass), then its
+** narrow kernel (16 blocks per pass) on what is left, then the scalar engine
+** on the last few blocks. The wide backends borrow the fastest 16-block
+** kernel the CPU has for their narrow kernel; scalar backends have neither.
+** The bitsliced wide kernel takes every block, padding its last pass, so no
+** block of a bulk call goes through a table lookup.
+** aria_crypt_bytes() does the same with the kernels' byte order entry points,
+** and aria_crypt_blocks_lanes() with their per-block key entry points.
+*/
 
-static aria_u128_t 
-aria_encrypt_256 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Plaintext)
-{
-  aria_key_schedule_t ks;
+typedef size_t (*aria_kernel_t) (const aria_key_schedule_t *ks
+                               , const aria_u128_t *in
+                               , aria_u128_t       *out
+                               , size_t             count);
 
-  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, ENCRYPT, 256u);
+typedef size_t (*aria_bytes_kernel_t) (const aria_key_schedule_t *ks
+                                     , const uint8_t *in
+                                     , uint8_t       *out
+                                     , size_t         count);
 
-  if (NO_ERROR != err)
-  {
-    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
-  }
-  return aria_crypt(&ks, Plaintext);
-}
+typedef size_t (*aria_lanes_kernel_t) (const aria_key_schedule_t *const *ks
+                                     , const aria_u128_t *in
+                                     , aria_u128_t       *out
+                                     , size_t             count);
 
-static aria_u128_t 
-aria_decrypt_128 (aria_u128_t Key, aria_u128_t Ciphertext)
-{
-  aria_key_schedule_t ks;
+typedef aria_u128_t (*aria_crypt_t) (const aria_key_schedule_t *ks, aria_u128_t text);
 
-  aria_error_code_t err = aria_init_key_schedule(&ks, Key, /* don't care */ Key, DECRYPT, 128u);
+typedef void (*aria_blocks_t) (const aria_key_schedule_t *ks
+                             , const aria_u128_t *in
+                             , aria_u128_t       *out
+                             , size_t             count);
 
-  if (NO_ERROR != err)
-  {
-    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
-  }
+/* The scalar engines have one entry per round count: 12, 14, 16, any other */
 
-  return aria_crypt(&ks, Ciphertext);
-}
+#define ARIA_ROUND_SLOTS 4u
 
-static aria_u128_t 
-aria_decrypt_192 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Ciphertext)
+static inline uint32_t
+aria_round_slot (const aria_key_schedule_t *ks)
 {
-  aria_key_schedule_t ks;
+  uint32_t i = (ks->rounds - 12u) / 2u;
 
-  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, DECRYPT, 192u);
+  return (i < (ARIA_ROUND_SLOTS - 1u)) ? i : (ARIA_ROUND_SLOTS - 1u);
+}
 
-  if (NO_ERROR != err)
-  {
-    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
-  }
+typedef struct aria_dispatch_s
+{
+  aria_backend_t backend;
+  aria_crypt_t   crypt[ARIA_ROUND_SLOTS];
+  aria_kernel_t  wide;
+  aria_kernel_t  narrow;
+  aria_blocks_t  blocks[ARIA_ROUND_SLOTS];
+  aria_bytes_kernel_t wide_bytes;
+  aria_bytes_kernel_t narrow_bytes;
+  aria_lanes_kernel_t wide_lanes;
+  aria_lanes_kernel_t narrow_lanes;
+} aria_dispatch_t;
+
+static const char *const aria_backend_names[BACKEND_COUNT] =
+{
+  "auto", "reference", "ttable", "ssse3", "avx2", "aesni", "gfni", "bitslice", "neon", "neonaes"
+};
 
-  return aria_crypt(&ks, Ciphertext);
+static size_t
+aria_no_kernel (const aria_key_schedule_t *ks
+              , const aria_u128_t *in
+              , aria_u128_t       *out
+              , size_t             count)
+{
+  (void)ks;
+  (void)in;
+  (void)out;
+  (void)count;
+  return 0u;
 }
 
-static aria_u128_t 
-aria_decrypt_256 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Ciphertext)
+static size_t
+aria_no_bytes_kernel (const aria_key_schedule_t *ks
+                    , const uint8_t *in
+                    , uint8_t       *out
+                    , size_t         count)
 {
-  aria_key_schedule_t ks;
+  (void)ks;
+  (void)in;
+  (void)out;
+  (void)count;
+  return 0u;
+}
 
-  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, DECRYPT, 256u);
+static size_t
+aria_no_lanes_kernel (const aria_key_schedule_t *const *ks
+                    , const aria_u128_t *in
+                    , aria_u128_t       *out
+                    , size_t             count)
+{
+  (void)ks;
+  (void)in;
+  (void)out;
+  (void)count;
+  return 0u;
+}
 
-  if (NO_ERROR != err)
+static aria_u128_t aria_resolve_crypt (const aria_key_schedule_t *ks, aria_u128_t text);
+
+static size_t aria_resolve_wide (const aria_key_schedule_t *ks
+                               , const aria_u128_t *in
+                               , aria_u128_t       *out
+                               , size_t             count);
+
+static size_t aria_resolve_wide_bytes (const aria_key_schedule_t *ks
+                                     , const uint8_t *in
+                                     , uint8_t       *out
+                                     , size_t         count);
+
+static size_t aria_resolve_wide_lanes (const aria_key_schedule_t *const *ks
+                                     , const aria_u128_t *in
+                                     , aria_u128_t       *out
+                                     , size_t             count);
+
+/* Until resolved; the wide kernel is always called first in a bulk call */
+static const aria_dispatch_t aria_unresolved =
+{
+  BACKEND_AUTO
+, { aria_resolve_crypt, aria_resolve_crypt, aria_resolve_crypt, aria_resolve_crypt }
+, aria_resolve_wide
+, aria_no_kernel
+, ARIA_SCALAR_CRYPT_BLOCKS
+, aria_resolve_wide_bytes
+, aria_no_bytes_kernel
+, aria_resolve_wide_lanes
+, aria_no_lanes_kernel
+};
+
+/* The bound table, and the one calls go through: aria_unresolved, until a
+** backend is bound. aria_bind() fills in aria_bound and then publishes it
+** with a release store; every call reads the pointer with an acquire load,
+** so a thread that sees aria_bound sees it whole. The first use resolves
+** under pthread_once(), so threads that start together resolve once;
+** aria_set_backend() rewrites aria_bound in place, hence before threads.
+*/
+static aria_dispatch_t aria_bound;
+static const aria_dispatch_t *aria_dispatch = &aria_unresolved;
+static pthread_once_t aria_resolve_once = PTHREAD_ONCE_INIT;
+
+#if defined(__GNUC__)
+#define ARIA_PUBLISH(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
+#define ARIA_ACQUIRE(p)    __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+#else
+#define ARIA_PUBLISH(p, v) ((p) = (v))
+#define ARIA_ACQUIRE(p)    (p)
+#endif
+
+static inline const aria_dispatch_t *
+aria_table (void)
+{
+  return ARIA_ACQUIRE(aria_dispatch);
+}
+
+int
+aria_backend_supported (aria_backend_t backend)
+{
+  switch (backend)
   {
-    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+    case BACKEND_AUTO:
+    case BACKEND_REFERENCE:
+    case BACKEND_BITSLICE:
+      return 1;
+    case BACKEND_TTABLE:
+      return ARIA_USE_TTABLE ? 1 : 0;
+#if ARIA_X86
+    case BACKEND_SSSE3:
+      return aria_x86_has_ssse3();
+    case BACKEND_AVX2:
+      return aria_x86_has_avx2();
+    case BACKEND_AESNI:
+      return aria_x86_has_aesni();
+    case BACKEND_GFNI:
+      return aria_x86_has_gfni();
+#endif
+#if ARIA_ARM64
+    case BACKEND_NEON:
+      return 1;
+    case BACKEND_NEON_AES:
+      return aria_arm_has_aes();
+#endif
+    default:
+      return 0;
   }
-
-  return aria_crypt(&ks, Ciphertext);
 }
 
-/*
-** Appendix A.  Example Data of ARIA
-** 
-**    Here are test data for ARIA in hexadecimal form.
-** 
-** A.1.  128-Bit Key
-** 
-**    - Key       : 000102030405060708090a0b0c0d0e0f
-**    - Plaintext : 00112233445566778899aabbccddeeff
-**    - Ciphertext: d718fbd6ab644c739da95f3be6451778
-** 
-**    - Round key generators
-**       W0: 000102030405060708090a0b0c0d0e0f
-**       W1: 2afbea741e1746dd55c63ba1afcea0a5
-**       W2: 7c8578018bb127e02dfe4e78c288e33c
-**       W3: 6785b52b74da46bf181054082763ff6d
-** 
-**    - Encryption round keys
-**       e1:  d415a75c794b85c5e0d2a0b3cb793bf6
-**       e2:  369c65e4b11777ab713a3e1e6601b8f4
-**       e3:  0368d4f13d14497b6529ad7ac809e7d0
-**       e4:  c644552b549a263fb8d0b50906229eec
-**       e5:  5f9c434951f2d2ef342787b1a781794c
-**       e6:  afea2c0ce71db6de42a47461f4323c54
-**       e7:  324286db44ba4db6c44ac306f2a84b2c
-**       e8:  7f9fa93574d842b9101a58063771eb7b
-**       e9:  aab9c57731fcd213ad5677458fcfe6d4
-**       e10: 2f4423bb06465abada5694a19eb88459
-**       e11: 9f8772808f5d580d810ef8ddac13abeb
-**       e12: 8684946a155be77ef810744847e35fad
-**       e13: 0f0aa16daee61bd7dfee5a599970fb35
-** 
-**    - Intermediate round values
-**       P1:  7fc7f12befd0a0791de87fa96b469f52
-**       P2:  ac8de17e49f7c5117618993162b189e9
-**       P3:  c3e8d59ec2e62d5249ca2741653cb7dd
-**       P4:  5d4aebb165e141ff759f669e1e85cc45
-**       P5:  7806e469f68874c5004b5f4a046bbcfa
-**       P6:  110f93c9a630cdd51f97d2202413345a
-**       P7:  e054428ef088fef97928241cd3be499e
-**       P8:  5734f38ea1ca3ddd102e71f95e1d5f97
-**       P9:  4903325be3e500cccd52fba4354a39ae
-**       P10: cb8c508e2c4f87880639dc896d25ec9d
-**       P11: e7e0d2457ed73d23d481424095afdca0
-** 
-** A.2.  192-Bit Key
-** 
-**    Key       : 000102030405060708090a0b0c0d0e0f
-**                1011121314151617
-**    Plaintext : 00112233445566778899aabbccddeeff
-**    Ciphertext: 26449c1805dbe7aa25a468ce263a9e79
-** 
-** A.3.  256-Bit Key
-** 
-**    Key       : 000102030405060708090a0b0c0d0e0f
-**                101112131415161718191a1b1c1d1e1f
-**    Plaintext : 00112233445566778899aabbccddeeff
-**    Ciphertext: f92bd7c79fb72e2f2b8f80c1972d24fc
-** */
+const char *
+aria_backend_name (aria_backend_t backend)
+{
+  return ((unsigned )backend < BACKEND_COUNT) ? aria_backend_names[backend] : NULL;
+}
 
-int main (int argc, char **argv)
+static aria_backend_t
+aria_fastest_backend (void)
 {
-  if ((argc == 2) && (0 == strcmp("-s", argv[1])))
+  static const aria_backend_t order[] =
   {
-    aria_u128_t KeyLeft    = { 0x0001020304050607, 0x08090a0b0c0d0e0f };
-    aria_u128_t KeyRight;
-    aria_u128_t Plaintext  = { 0x0011223344556677, 0x8899aabbccddeeff };
-    aria_u128_t Ciphertext = { 0xd718fbd6ab644c73, 0x9da95f3be6451778 };
-
-    aria_u128_t C = aria_encrypt_128(KeyLeft, Plaintext);
+    BACKEND_GFNI, BACKEND_AVX2, BACKEND_AESNI, BACKEND_SSSE3, BACKEND_NEON_AES, BACKEND_NEON, BACKEND_TTABLE
+  };
 
-    if (0 == memcmp((const void *)&Ciphertext, (const void *)&C, sizeof(aria_u128_t)))
+  for (size_t i = 0u; i < sizeof(order) / sizeof(order[0]); i++)
+  {
+    if (aria_backend_supported(order[i]))
     {
-      printf("aria_encrypt_128 pass\n");
+      return order[i];
     }
-    else
+  }
+  return BACKEND_REFERENCE;
+}
+
+/* Fill in aria_dispatch for a supported backend; BACKEND_AUTO for the fastest */
+
+/* All four round slots, since the bitsliced engine takes any round count */
+
+static void
+aria_bitslice_blocks (const aria_key_schedule_t *ks
+                    , const aria_u128_t *in
+                    , aria_u128_t       *out
+                    , size_t             count)
+{
+  (void)aria_bitslice_crypt_blocks(ks, in, out, count);
+}
+
+static void
+aria_bind (aria_backend_t backend)
+{
+  aria_dispatch_t d =
+  {
+    backend, ARIA_SCALAR_CRYPT, aria_no_kernel, aria_no_kernel, ARIA_SCALAR_CRYPT_BLOCKS
+  , aria_no_bytes_kernel, aria_no_bytes_kernel, aria_no_lanes_kernel, aria_no_lanes_kernel
+  };
+
+  if (BACKEND_AUTO == backend)
+  {
+    d.backend = backend = aria_fastest_backend();
+  }
+  switch (backend)
+  {
+    case BACKEND_REFERENCE:
+      for (uint32_t i = 0u; i < ARIA_ROUND_SLOTS; i++)
+      {
+        d.crypt[i]  = aria_reference_crypt;
+        d.blocks[i] = aria_reference_crypt_blocks;
+      }
+      break;
+    case BACKEND_BITSLICE:
+      for (uint32_t i = 0u; i < ARIA_ROUND_SLOTS; i++)
+      {
+        d.crypt[i]  = aria_bitslice_crypt;
+        d.blocks[i] = aria_bitslice_blocks;
+      }
+      d.wide       = aria_bitslice_crypt_blocks;
+      d.wide_bytes = aria_bitslice_crypt_bytes;
+      d.wide_lanes = aria_bitslice_crypt_lanes;
+      break;
+#if ARIA_X86
+    case BACKEND_GFNI:
+      d.wide         = aria_x86_gfni_crypt_blocks;
+      d.narrow       = aria_x86_has_aesni() ? aria_x86_aesni_crypt_blocks : aria_x86_ssse3_crypt_blocks;
+      d.wide_bytes   = aria_x86_gfni_crypt_bytes;
+      d.narrow_bytes = aria_x86_has_aesni() ? aria_x86_aesni_crypt_bytes : aria_x86_ssse3_crypt_bytes;
+      d.wide_lanes   = aria_x86_gfni_crypt_lanes;
+      d.narrow_lanes = aria_x86_has_aesni() ? aria_x86_aesni_crypt_lanes : aria_x86_ssse3_crypt_lanes;
+      break;
+    case BACKEND_AVX2:
+      d.wide         = aria_x86_avx2_crypt_blocks;
+      d.narrow       = aria_x86_has_aesni() ? aria_x86_aesni_crypt_blocks : aria_x86_ssse3_crypt_blocks;
+      d.wide_bytes   = aria_x86_avx2_crypt_bytes;
+      d.narrow_bytes = aria_x86_has_aesni() ? aria_x86_aesni_crypt_bytes : aria_x86_ssse3_crypt_bytes;
+      d.wide_lanes   = aria_x86_avx2_crypt_lanes;
+      d.narrow_lanes = aria_x86_has_aesni() ? aria_x86_aesni_crypt_lanes : aria_x86_ssse3_crypt_lanes;
+      break;
+    case BACKEND_AESNI:
+      d.narrow       = aria_x86_aesni_crypt_blocks;
+      d.narrow_bytes = aria_x86_aesni_crypt_bytes;
+      d.narrow_lanes = aria_x86_aesni_crypt_lanes;
+      break;
+    case BACKEND_SSSE3:
+      d.narrow       = aria_x86_ssse3_crypt_blocks;
+      d.narrow_bytes = aria_x86_ssse3_crypt_bytes;
+      d.narrow_lanes = aria_x86_ssse3_crypt_lanes;
+      break;
+#endif
+#if ARIA_ARM64
+    case BACKEND_NEON_AES:
+      d.narrow       = aria_arm_aes_crypt_blocks;
+      d.narrow_bytes = aria_arm_aes_crypt_bytes;
+      d.narrow_lanes = aria_arm_aes_crypt_lanes;
+      break;
+    case BACKEND_NEON:
+      d.narrow       = aria_arm_neon_crypt_blocks;
+      d.narrow_bytes = aria_arm_neon_crypt_bytes;
+      d.narrow_lanes = aria_arm_neon_crypt_lanes;
+      break;
+#endif
+    default:
+      break;
+  }
+  aria_bound = d;
+  ARIA_PUBLISH(aria_dispatch, (const aria_dispatch_t *)&aria_bound);
+}
+
+static void
+aria_resolve (void)
+{
+  aria_backend_t backend = BACKEND_AUTO;
+  const char *name = getenv("ARIA_BACKEND");
+
+  if (NULL != name)
+  {
+    for (unsigned b = 0u; b < BACKEND_COUNT; b++)
     {
-      fprintf(stderr, "aria_encrypt_128 fail: ");
-      print_aria_u128(C);
-      fprintf(stderr, "\n");
+      if ((0 == strcmp(name, aria_backend_names[b])) && aria_backend_supported((aria_backend_t )b))
+      {
+        backend = (aria_backend_t )b;
+      }
     }
+  }
+  aria_bind(backend);
+}
 
-    aria_u128_t P = aria_decrypt_128(KeyLeft, Ciphertext);
+/* The resolvers: the first calls, from however many threads */
+static void
+aria_resolve_first (void)
+{
+  (void)pthread_once(&aria_resolve_once, aria_resolve);
+}
 
-    if (0 == memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+static aria_u128_t
+aria_resolve_crypt (const aria_key_schedule_t *ks, aria_u128_t text)
+{
+  aria_resolve_first();
+  return aria_table()->crypt[aria_round_slot(ks)](ks, text);
+}
+
+static size_t
+aria_resolve_wide (const aria_key_schedule_t *ks
+                 , const aria_u128_t *in
+                 , aria_u128_t       *out
+                 , size_t             count)
+{
+  aria_resolve_first();
+  return aria_table()->wide(ks, in, out, count);
+}
+
+static size_t
+aria_resolve_wide_bytes (const aria_key_schedule_t *ks
+                       , const uint8_t *in
+                       , uint8_t       *out
+                       , size_t         count)
+{
+  aria_resolve_first();
+  return aria_table()->wide_bytes(ks, in, out, count);
+}
+
+static size_t
+aria_resolve_wide_lanes (const aria_key_schedule_t *const *ks
+                       , const aria_u128_t *in
+                       , aria_u128_t       *out
+                       , size_t             count)
+{
+  aria_resolve_first();
+  return aria_table()->wide_lanes(ks, in, out, count);
+}
+
+aria_error_code_t
+aria_set_backend (aria_backend_t backend)
+{
+  if (!aria_backend_supported(backend))
+  {
+    return BACKEND_BAD;
+  }
+  if (BACKEND_AUTO == backend)
+  {
+    aria_resolve();
+  }
+  else
+  {
+    aria_bind(backend);
+  }
+  return NO_ERROR;
+}
+
+aria_backend_t
+aria_get_backend (void)
+{
+  if (BACKEND_AUTO == aria_table()->backend)
+  {
+    aria_resolve_first();
+  }
+  return aria_table()->backend;
+}
+
+aria_u128_t
+aria_crypt (aria_key_schedule_t *ks, aria_u128_t text)
+{
+  ARIA_STAT_ADD(crypt_calls, 1u);
+  ARIA_STAT_ADD(blocks, 1u);
+  return aria_table()->crypt[aria_round_slot(ks)](ks, text);
+}
+
+aria_error_code_t
+aria_crypt_blocks (aria_key_schedule_t *ks
+                 , const aria_u128_t *in
+                 , aria_u128_t       *out
+                 , size_t             count)
+{
+  if ((NULL == ks) || (((NULL == in) || (NULL == out)) && (0u != count)))
+  {
+    return ARG_BAD;
+  }
+  ARIA_STAT_ADD(bulk_calls, 1u);
+  ARIA_STAT_ADD(blocks, count);
+  ARIA_STAT_PERF_BEGIN(perf);
+
+  size_t done = aria_table()->wide(ks, in, out, count);
+
+  done += aria_table()->narrow(ks, &in[done], &out[done], count - done);
+  aria_table()->blocks[aria_round_slot(ks)](ks, &in[done], &out[done], count - done);
+  ARIA_STAT_PERF_END(perf);
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_crypt_blocks_lanes (const aria_key_schedule_t *const *ks
+                       , const aria_u128_t *in
+                       , aria_u128_t       *out
+                       , size_t             count)
+{
+  if (((NULL == ks) || (NULL == in) || (NULL == out)) && (0u != count))
+  {
+    return ARG_BAD;
+  }
+  for (size_t i = 0u; i < count; i++)
+  {
+    if (NULL == ks[i])
     {
-      printf("aria_decrypt_128 pass\n");
+      return ARG_BAD;
     }
-    else
+    if (ks[i]->rounds != ks[0]->rounds)
     {
-      fprintf(stderr, "aria_decrypt_128 fail: ");
-      print_aria_u128(P);
-      fprintf(stderr, "\n");
-    }    
+      return KEY_SIZE_BAD;
+    }
+  }
+  ARIA_STAT_ADD(bulk_calls, 1u);
+  ARIA_STAT_ADD(blocks, count);
+  ARIA_STAT_PERF_BEGIN(perf);
 
-    KeyLeft    = (aria_u128_t ){ 0x0001020304050607, 0x08090a0b0c0d0e0f };
-    KeyRight   = (aria_u128_t ){ 0x1011121314151617, 0x0000000000000000 };
-    Plaintext  = (aria_u128_t ){ 0x0011223344556677, 0x8899aabbccddeeff };
-    Ciphertext = (aria_u128_t ){ 0x26449c1805dbe7aa, 0x25a468ce263a9e79 };
+  size_t done = aria_table()->wide_lanes(ks, in, out, count);
 
-    C = aria_encrypt_192(KeyLeft, KeyRight, Plaintext);
+  done += aria_table()->narrow_lanes(&ks[done], &in[done], &out[done], count - done);
+  for (; done < count; done++)
+  {
+    out[done] = aria_table()->crypt[aria_round_slot(ks[done])](ks[done], in[done]);
+  }
+  ARIA_STAT_PERF_END(perf);
+  return NO_ERROR;
+}
 
-    if (0 == memcmp((const void *)&Ciphertext, (const void *)&C, sizeof(aria_u128_t)))
+/* The scalar engines work on aria_u128_t: the blocks the SIMD kernels leave
+** (all of them, for a scalar backend) are converted ARIA_BYTES_BATCH at a
+** time on the stack
+*/
+
+#define ARIA_BYTES_BATCH 16u
+
+aria_error_code_t
+aria_crypt_bytes (aria_key_schedule_t *ks
+                , const uint8_t      *in
+                , uint8_t            *out
+                , size_t              len)
+{
+  if ((NULL == ks) || (((NULL == in) || (NULL == out)) && (0u != len)) || (0u != (len % 16u)))
+  {
+    return ARG_BAD;
+  }
+  size_t count = len / 16u;
+
+  ARIA_STAT_ADD(bulk_calls, 1u);
+  ARIA_STAT_ADD(blocks, count);
+  ARIA_STAT_PERF_BEGIN(perf);
+
+  size_t done = aria_table()->wide_bytes(ks, in, out, count);
+
+  done += aria_table()->narrow_bytes(ks, &in[16u * done], &out[16u * done], count - done);
+
+  aria_u128_t blocks[ARIA_BYTES_BATCH];
+
+  for (size_t n; done < count; done += n)
+  {
+    n = count - done;
+    if (n > ARIA_BYTES_BATCH)
+    {
+      n = ARIA_BYTES_BATCH;
+    }
+    for (size_t i = 0u; i < n; i++)
+    {
+      blocks[i] = aria_load_block(&in[16u * (done + i)]);
+    }
+    aria_table()->blocks[aria_round_slot(ks)](ks, blocks, blocks, n);
+    for (size_t i = 0u; i < n; i++)
+    {
+      aria_store_block(&out[16u * (done + i)], blocks[i]);
+    }
+  }
+  ARIA_STAT_PERF_END(perf);
+  return NO_ERROR;
+}
+
+/*
+** 2.2.  Key Scheduling Part
+** 
+**    Let K denote a master key of 128, 192, or 256 bits.  Given the master
+**    key K, we first define 128-bit values KL and KR as follows.
+** 
+**    KL || KR = K || 0 ... 0,
+** 
+**    where the number of zeros is 128, 64, or 0, depending on the size of
+**    K.  That is, KL is set to the leftmost 128 bits of K and KR is set to
+**    the remaining bits of K (if any), right-padded with zeros to a
+**    128-bit value.  Then, we define four 128-bit values (W0, W1, W2, and
+**    W3) as the intermediate round values appearing in the encryption of
+**    KL || KR by a 3-round, 256-bit Feistel cipher.
+** 
+**    W0 = KL,
+**    W1 = FO(W0, CK1) ^ KR,
+**    W2 = FE(W1, CK2) ^ W0,
+**    W3 = FO(W2, CK3) ^ W1.
+** 
+**    Here, FO and FE, respectively called odd and even round functions,
+**    are defined in Section 2.4.1.  CK1, CK2, and CK3 are 128-bit
+**    constants, taking one of the following values.
+** 
+**    C1 =  0x517cc1b727220a94fe13abe8fa9a6ee0
+**    C2 =  0x6db14acc9e21c820ff28b1d5ef5de2b0
+**    C3 =  0xdb92371d2126e9700324977504e8c90e
+** 
+**    These values are obtained from the first 128*3 bits of the fractional
+**    part of 1/PI, where PI is the circle ratio.  Now the constants CK1,
+**    CK2, and CK3 are defined by the following table.
+** 
+**        Key size  CK1  CK2  CK3
+**          128     C1   C2   C3
+**          192     C2   C3   C1
+**          256     C3   C1   C2
+** 
+**    For example, if the key size is 192 bits, CK1 = C2, CK2 = C3, and
+**    CK3 = C1.
+*/
+
+static const aria_u128_t C1 = { 0x517cc1b727220a94, 0xfe13abe8fa9a6ee0 };
+static const aria_u128_t C2 = { 0x6db14acc9e21c820, 0xff28b1d5ef5de2b0 };
+static const aria_u128_t C3 = { 0xdb92371d2126e970, 0x0324977504e8c90e };
+
+/*
+**    The number of rounds depends on the size of the master key as
+**    follows.
+** 
+**         Key size     Number of Rounds
+**          128              12
+**          192              14
+**          256              16
+** 
+**    Due to an extra key addition layer in the last round, 12-, 14-, and
+**    16-round algorithms require 13, 15, and 17 round keys, respectively.
+** 
+**    Decryption round keys are derived from the encryption round keys.
+** 
+**    dk1 = ek{n+1},
+**    dk2 = A(ek{n}),
+**    dk3 = A(ek{n-1}),
+**    ...,
+**    dk{n}= A(ek2),
+**    dk{n+1}= ek1.
+** 
+**    Here, A and n denote the diffusion layer of ARIA and the number of
+**    rounds, respectively.  The diffusion layer A is defined in Section
+**    2.4.3.
+*/
+/* 
+** 2.3.2.  Decryption Process
+** 
+**    The decryption process of ARIA is the same as the encryption process
+**    except that encryption round keys are replaced by decryption round
+**    keys.  For example, encryption round keys ek1, ..., ek13 of the
+**    12-round ARIA algorithm are replaced by decryption round keys dk1,
+**    ..., dk13, respectively.
+*/
+
+/* The round count and key constants for a key size, and the mask of the bits
+** of KeyRight it uses
+*/
+
+static aria_error_code_t
+aria_key_constants (uint32_t     key_size_in_bits
+                  , aria_u128_t  CK[3]
+                  , aria_u128_t *mask
+                  , uint32_t    *rounds)
+{
+  switch (key_size_in_bits)
+  {
+    case 256:
+      *rounds = 16u;
+      CK[0] = C3;
+      CK[1] = C1;
+      CK[2] = C2;
+      *mask = (aria_u128_t ){ ~(uint64_t )0u, ~(uint64_t )0u };
+      break;
+    case 192:
+      *rounds = 14u;
+      CK[0] = C2;
+      CK[1] = C3;
+      CK[2] = C1;
+      *mask = (aria_u128_t ){ ~(uint64_t )0u, 0u };
+      break;
+    case 128:
+      *rounds = 12u;
+      CK[0] = C1;
+      CK[1] = C2;
+      CK[2] = C3;
+      *mask = (aria_u128_t ){ 0u, 0u };
+      break;
+    default:
+      return KEY_SIZE_BAD;
+  }
+  return NO_ERROR;
+}
+
+/* W0..W3 and the number of rounds for a master key */
+
+static aria_error_code_t
+aria_key_words (aria_u128_t  KeyLeft
+              , aria_u128_t  KeyRight
+              , uint32_t     key_size_in_bits
+              , aria_u128_t  W[4]
+              , uint32_t    *rounds)
+{
+  aria_u128_t CK[3];
+  aria_u128_t mask;
+  aria_error_code_t err = aria_key_constants(key_size_in_bits, CK, &mask, rounds);
+
+  if (NO_ERROR != err)
+  {
+    return err;
+  }
+  KeyRight.left  &= mask.left;
+  KeyRight.right &= mask.right;
+  W[0] = KeyLeft;
+  W[1] = xor(aria_FO(W[0], CK[0]), KeyRight);
+  W[2] = xor(aria_FE(W[1], CK[1]), W[0]);
+  W[3] = xor(aria_FO(W[2], CK[2]), W[1]);
+  return NO_ERROR;
+}
+
+/* Replace encryption round keys with decryption round keys, in place */
+
+static void
+aria_ek_to_dk (aria_key_schedule_t *keysched)
+{
+  uint32_t rounds = keysched->rounds;
+
+  keysched->ek[ 0] = keysched->ek[rounds + 1];
+  keysched->ek[rounds + 1] = keysched->ek[ 1];
+  keysched->ek[ 1] = keysched->ek[ 0];
+
+  for (uint32_t i = 2, j = rounds; i < j; i++, j--)
+  {
+    keysched->ek[ 0] = keysched->ek[ j];
+    keysched->ek[ j] = aria_A(keysched->ek[ i]);
+    keysched->ek[ i] = aria_A(keysched->ek[ 0]);
+  }
+  rounds = (rounds / 2u) + 1u;
+  keysched->ek[rounds] = aria_A(keysched->ek[rounds]);
+  keysched->ek[0] = (aria_u128_t ){ 0u, 0u };
+  keysched->mode = DECRYPT;
+}
+
+aria_error_code_t 
+aria_init_key_schedule (aria_key_schedule_t *keysched
+                      , aria_u128_t        KeyLeft
+                      , aria_u128_t        KeyRight
+                      , aria_cryto_mode_t  mode
+                      , uint32_t key_size_in_bits)
+{
+  aria_u128_t W[4];
+
+  if (NULL == keysched)
+  {
+    return ARG_BAD;
+  }
+  aria_error_code_t err = aria_key_words(KeyLeft, KeyRight, key_size_in_bits, W, &keysched->rounds);
+
+  if (NO_ERROR != err)
+  {
+    return err;
+  }
+  if ((ENCRYPT != mode) && (DECRYPT != mode))
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  compute_ek(W[0], W[1], W[2], W[3], keysched->ek);
+  keysched->ek[0] = (aria_u128_t ){ 0u, 0u }; /* unused */
+  keysched->mode  = ENCRYPT;
+  ARIA_STAT_ADD(key_inits, 1u);
+
+  if (DECRYPT == mode)
+  {
+    aria_ek_to_dk(keysched);
+  }
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_init_dual_key_schedule (aria_dual_key_schedule_t *keysched
+                           , aria_u128_t              KeyLeft
+                           , aria_u128_t              KeyRight
+                           , uint32_t                 key_size_in_bits)
+{
+  if (NULL == keysched)
+  {
+    return ARG_BAD;
+  }
+  aria_error_code_t err = aria_init_key_schedule(&keysched->enc, KeyLeft, KeyRight, ENCRYPT, key_size_in_bits);
+
+  if (NO_ERROR != err)
+  {
+    return err;
+  }
+  return aria_key_schedule_to_decrypt(&keysched->enc, &keysched->dec);
+}
+
+aria_error_code_t
+aria_key_schedule_to_decrypt (const aria_key_schedule_t *enc, aria_key_schedule_t *dec)
+{
+  if ((NULL == enc) || (NULL == dec))
+  {
+    return ARG_BAD;
+  }
+  if (ENCRYPT != enc->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  if (dec != enc)
+  {
+    *dec = *enc;
+  }
+  aria_ek_to_dk(dec);
+  ARIA_STAT_ADD(key_to_decrypt, 1u);
+  return NO_ERROR;
+}
+
+/* Many keys at once
+**
+** The key derivation is three round functions with fixed round keys, each
+** needing the result of the one before. Taking ARIA_KEY_LANES keys through
+** each step together gives the CPU independent chains to overlap, as
+** aria_crypt_blocks() does for blocks. A single round is too little work to
+** pay for the byte-sliced kernels' transposes, so the scalar round functions
+** are used.
+*/
+
+#define ARIA_KEY_LANES 4u
+
+aria_error_code_t
+aria_init_key_schedules_batch (aria_key_schedule_t *keysched
+                             , const aria_u128_t   *KeyLeft
+                             , const aria_u128_t   *KeyRight
+                             , size_t               count
+                             , aria_cryto_mode_t    mode
+                             , uint32_t             key_size_in_bits)
+{
+  aria_u128_t CK[3];
+  aria_u128_t mask;
+  uint32_t rounds;
+
+  if (((NULL == keysched) || (NULL == KeyLeft)) && (0u != count))
+  {
+    return ARG_BAD;
+  }
+  aria_error_code_t err = aria_key_constants(key_size_in_bits, CK, &mask, &rounds);
+
+  if (NO_ERROR != err)
+  {
+    return err;
+  }
+  if ((ENCRYPT != mode) && (DECRYPT != mode))
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  if ((NULL == KeyRight) && (128u != key_size_in_bits))
+  {
+    return ARG_BAD;
+  }
+  ARIA_STAT_ADD(key_inits, count);
+  for (size_t n; count > 0u; count -= n)
+  {
+    aria_u128_t W[ARIA_KEY_LANES][4];
+
+    n = (count < ARIA_KEY_LANES) ? count : ARIA_KEY_LANES;
+    for (size_t l = 0u; l < n; l++)
+    {
+      W[l][0] = KeyLeft[l];
+    }
+    for (size_t l = 0u; l < n; l++)
+    {
+      aria_u128_t kr = (NULL == KeyRight) ? (aria_u128_t ){ 0u, 0u } : KeyRight[l];
+
+      W[l][1] = xor(aria_FO(W[l][0], CK[0]), (aria_u128_t ){ kr.left & mask.left, kr.right & mask.right });
+    }
+    for (size_t l = 0u; l < n; l++)
+    {
+      W[l][2] = xor(aria_FE(W[l][1], CK[1]), W[l][0]);
+    }
+    for (size_t l = 0u; l < n; l++)
+    {
+      W[l][3] = xor(aria_FO(W[l][2], CK[2]), W[l][1]);
+    }
+    for (size_t l = 0u; l < n; l++)
+    {
+      compute_ek(W[l][0], W[l][1], W[l][2], W[l][3], keysched[l].ek);
+      keysched[l].ek[0]  = (aria_u128_t ){ 0u, 0u };
+      keysched[l].rounds = rounds;
+      keysched[l].mode   = ENCRYPT;
+      if (DECRYPT == mode)
+      {
+        aria_ek_to_dk(&keysched[l]);
+      }
+    }
+    keysched += n;
+    KeyLeft  += n;
+    if (NULL != KeyRight)
+    {
+      KeyRight += n;
+    }
+  }
+  return NO_ERROR;
+}
+
+void
+aria_wipe (void *p, size_t len)
+{
+  volatile uint8_t *v = p;
+
+  while (len-- > 0u)
+  {
+    *v++ = 0u;
+  }
+}
+
+#ifdef ARIA_TEST
+
+static aria_u128_t 
+aria_encrypt_128 (aria_u128_t Key, aria_u128_t Plaintext)
+{
+  aria_key_schedule_t ks;
+
+  aria_error_code_t err = aria_init_key_schedule(&ks, Key, /* don't care */ Key, ENCRYPT, 128u);
+
+  if (NO_ERROR != err)
+  {
+    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+  }
+  return aria_crypt(&ks, Plaintext);
+}
+
+static aria_u128_t 
+aria_encrypt_192 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Plaintext)
+{
+  aria_key_schedule_t ks;
+
+  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, ENCRYPT, 192u);
+
+  if (NO_ERROR != err)
+  {
+    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+  }
+  return aria_crypt(&ks, Plaintext);
+}
+
+static aria_u128_t 
+aria_encrypt_256 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Plaintext)
+{
+  aria_key_schedule_t ks;
+
+  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, ENCRYPT, 256u);
+
+  if (NO_ERROR != err)
+  {
+    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+  }
+  return aria_crypt(&ks, Plaintext);
+}
+
+static aria_u128_t 
+aria_decrypt_128 (aria_u128_t Key, aria_u128_t Ciphertext)
+{
+  aria_key_schedule_t ks;
+
+  aria_error_code_t err = aria_init_key_schedule(&ks, Key, /* don't care */ Key, DECRYPT, 128u);
+
+  if (NO_ERROR != err)
+  {
+    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+  }
+
+  return aria_crypt(&ks, Ciphertext);
+}
+
+static aria_u128_t 
+aria_decrypt_192 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Ciphertext)
+{
+  aria_key_schedule_t ks;
+
+  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, DECRYPT, 192u);
+
+  if (NO_ERROR != err)
+  {
+    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+  }
+
+  return aria_crypt(&ks, Ciphertext);
+}
+
+static aria_u128_t 
+aria_decrypt_256 (aria_u128_t KeyLeft, aria_u128_t KeyRight, aria_u128_t Ciphertext)
+{
+  aria_key_schedule_t ks;
+
+  aria_error_code_t err = aria_init_key_schedule(&ks, KeyLeft, KeyRight, DECRYPT, 256u);
+
+  if (NO_ERROR != err)
+  {
+    fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+  }
+
+  return aria_crypt(&ks, Ciphertext);
+}
+
+/*
+** Appendix A.  Example Data of ARIA
+** 
+**    Here are test data for ARIA in hexadecimal form.
+** 
+** A.1.  128-Bit Key
+** 
+**    - Key       : 000102030405060708090a0b0c0d0e0f
+**    - Plaintext : 00112233445566778899aabbccddeeff
+**    - Ciphertext: d718fbd6ab644c739da95f3be6451778
+** 
+**    - Round key generators
+**       W0: 000102030405060708090a0b0c0d0e0f
+**       W1: 2afbea741e1746dd55c63ba1afcea0a5
+**       W2: 7c8578018bb127e02dfe4e78c288e33c
+**       W3: 6785b52b74da46bf181054082763ff6d
+** 
+**    - Encryption round keys
+**       e1:  d415a75c794b85c5e0d2a0b3cb793bf6
+**       e2:  369c65e4b11777ab713a3e1e6601b8f4
+**       e3:  0368d4f13d14497b6529ad7ac809e7d0
+**       e4:  c644552b549a263fb8d0b50906229eec
+**       e5:  5f9c434951f2d2ef342787b1a781794c
+**       e6:  afea2c0ce71db6de42a47461f4323c54
+**       e7:  324286db44ba4db6c44ac306f2a84b2c
+**       e8:  7f9fa93574d842b9101a58063771eb7b
+**       e9:  aab9c57731fcd213ad5677458fcfe6d4
+**       e10: 2f4423bb06465abada5694a19eb88459
+**       e11: 9f8772808f5d580d810ef8ddac13abeb
+**       e12: 8684946a155be77ef810744847e35fad
+**       e13: 0f0aa16daee61bd7dfee5a599970fb35
+** 
+**    - Intermediate round values
+**       P1:  7fc7f12befd0a0791de87fa96b469f52
+**       P2:  ac8de17e49f7c5117618993162b189e9
+**       P3:  c3e8d59ec2e62d5249ca2741653cb7dd
+**       P4:  5d4aebb165e141ff759f669e1e85cc45
+**       P5:  7806e469f68874c5004b5f4a046bbcfa
+**       P6:  110f93c9a630cdd51f97d2202413345a
+**       P7:  e054428ef088fef97928241cd3be499e
+**       P8:  5734f38ea1ca3ddd102e71f95e1d5f97
+**       P9:  4903325be3e500cccd52fba4354a39ae
+**       P10: cb8c508e2c4f87880639dc896d25ec9d
+**       P11: e7e0d2457ed73d23d481424095afdca0
+** 
+** A.2.  192-Bit Key
+** 
+**    Key       : 000102030405060708090a0b0c0d0e0f
+**                1011121314151617
+**    Plaintext : 00112233445566778899aabbccddeeff
+**    Ciphertext: 26449c1805dbe7aa25a468ce263a9e79
+** 
+** A.3.  256-Bit Key
+** 
+**    Key       : 000102030405060708090a0b0c0d0e0f
+**                101112131415161718191a1b1c1d1e1f
+**    Plaintext : 00112233445566778899aabbccddeeff
+**    Ciphertext: f92bd7c79fb72e2f2b8f80c1972d24fc
+** */
+
+static size_t hex_bytes (const char *hex, uint8_t *out)
+{
+  size_t n = 0u;
+
+  for (; ('\0' != hex[0]) && ('\0' != hex[1]); hex += 2)
+  {
+    unsigned b;
+
+    (void)sscanf(hex, "%2x", &b);
+    out[n++] = (uint8_t )b;
+  }
+  return n;
+}
+
+/* Cut len bytes at buf into at most max segments of random lengths, some
+** of them empty; returns the number of segments
+*/
+static size_t iov_cut (aria_iovec_t *iov, size_t max, uint8_t *buf, size_t len)
+{
+  size_t n = 0u;
+
+  for (size_t done = 0u, piece; done < len; done += piece)
+  {
+    piece = (n == (max - 1u)) ? (len - done) : (size_t )(xorshift128plus_next() % 200u);
+    if (piece > (len - done))
+    {
+      piece = len - done;
+    }
+    iov[n].base  = &buf[done];
+    iov[n++].len = piece;
+  }
+  return n;
+}
+
+/* XTS encryption of one sector as IEEE 1619 spells it out: a byte at a time,
+** one block at a time
+*/
+static void xts_ref (aria_key_schedule_t *ks, aria_key_schedule_t *tks, uint64_t sector
+                   , const uint8_t *in, uint8_t *out, size_t len)
+{
+  uint8_t t[16] = { 0u };
+  uint8_t x[16];
+  size_t m = len / 16u;
+  size_t tail = len % 16u;
+
+  for (uint32_t i = 0u; i < 8u; i++)
+  {
+    t[i] = (uint8_t )(sector >> (8u * i));
+  }
+  aria_store_block(t, aria_crypt(tks, aria_load_block(t)));
+  for (size_t j = 0u; j < m; j++)
+  {
+    for (uint32_t i = 0u; i < 16u; i++)
+    {
+      x[i] = in[16u * j + i] ^ t[i];
+    }
+    aria_store_block(x, aria_crypt(ks, aria_load_block(x)));
+    for (uint32_t i = 0u; i < 16u; i++)
+    {
+      out[16u * j + i] = x[i] ^ t[i];
+    }
+    unsigned carry = t[15] >> 7;
+    for (uint32_t i = 15u; i > 0u; i--)
+    {
+      t[i] = (uint8_t )((t[i] << 1) | (t[i - 1u] >> 7));
+    }
+    t[0] = (uint8_t )((t[0] << 1) ^ (carry ? 0x87u : 0u));
+  }
+  if (0u != tail)
+  {
+    uint8_t *last = &out[16u * (m - 1u)];
+
+    memcpy(x, last, 16u);
+    memcpy(&out[16u * m], x, tail);
+    memcpy(x, &in[16u * m], tail);
+    for (uint32_t i = 0u; i < 16u; i++)
+    {
+      x[i] ^= t[i];
+    }
+    aria_store_block(x, aria_crypt(ks, aria_load_block(x)));
+    for (uint32_t i = 0u; i < 16u; i++)
+    {
+      last[i] = x[i] ^ t[i];
+    }
+  }
+}
+
+/* CMAC of one message as SP 800-38B spells it out, a block at a time */
+static void cmac_ref (aria_key_schedule_t *ks, const uint8_t *msg, size_t len, uint8_t tag[16])
+{
+  uint8_t k[16] = { 0u };
+  uint8_t x[16] = { 0u };
+  size_t  m = (0u == len) ? 1u : ((len + 15u) / 16u);
+
+  aria_store_block(k, aria_crypt(ks, aria_load_block(k)));
+  for (unsigned d = 0u; d < (((0u != len) && (0u == (len % 16u))) ? 1u : 2u); d++)
+  {
+    unsigned carry = k[0] >> 7;
+
+    for (uint32_t i = 0u; i < 15u; i++)
+    {
+      k[i] = (uint8_t )((k[i] << 1) | (k[i + 1u] >> 7));
+    }
+    k[15] = (uint8_t )((k[15] << 1) ^ (carry ? 0x87u : 0u));
+  }
+  for (size_t j = 0u; j < m; j++)
+  {
+    for (uint32_t i = 0u; i < 16u; i++)
+    {
+      size_t at = 16u * j + i;
+
+      x[i] ^= (at < len) ? msg[at] : ((at == len) ? 0x80u : 0u);
+      if (j == (m - 1u))
+      {
+        x[i] ^= k[i];
+      }
+    }
+    aria_store_block(x, aria_crypt(ks, aria_load_block(x)));
+  }
+  memcpy(tag, x, 16u);
+}
+
+/* A thread that counts one aria_crypt() and exits */
+static void *stats_thread (void *arg)
+{
+  (void)aria_crypt((aria_key_schedule_t *)arg, (aria_u128_t ){ 0u, 0u });
+  return NULL;
+}
+
+int main (int argc, char **argv)
+{
+  if ((argc == 2) && (0 == strcmp("-s", argv[1])))
+  {
+    aria_u128_t KeyLeft    = { 0x0001020304050607, 0x08090a0b0c0d0e0f };
+    aria_u128_t KeyRight;
+    aria_u128_t Plaintext  = { 0x0011223344556677, 0x8899aabbccddeeff };
+    aria_u128_t Ciphertext = { 0xd718fbd6ab644c73, 0x9da95f3be6451778 };
+
+    aria_u128_t C = aria_encrypt_128(KeyLeft, Plaintext);
+
+    if (0 == memcmp((const void *)&Ciphertext, (const void *)&C, sizeof(aria_u128_t)))
+    {
+      printf("aria_encrypt_128 pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_encrypt_128 fail: ");
+      print_aria_u128(C);
+      fprintf(stderr, "\n");
+    }
+
+    aria_u128_t P = aria_decrypt_128(KeyLeft, Ciphertext);
+
+    if (0 == memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+    {
+      printf("aria_decrypt_128 pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_decrypt_128 fail: ");
+      print_aria_u128(P);
+      fprintf(stderr, "\n");
+    }    
+
+    KeyLeft    = (aria_u128_t ){ 0x0001020304050607, 0x08090a0b0c0d0e0f };
+    KeyRight   = (aria_u128_t ){ 0x1011121314151617, 0x0000000000000000 };
+    Plaintext  = (aria_u128_t ){ 0x0011223344556677, 0x8899aabbccddeeff };
+    Ciphertext = (aria_u128_t ){ 0x26449c1805dbe7aa, 0x25a468ce263a9e79 };
+
+    C = aria_encrypt_192(KeyLeft, KeyRight, Plaintext);
+
+    if (0 == memcmp((const void *)&Ciphertext, (const void *)&C, sizeof(aria_u128_t)))
+    {
+      printf("aria_encrypt_192 pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_encrypt_192 fail: ");
+      print_aria_u128(C);
+      fprintf(stderr, "\n");
+    }
+
+    P = aria_decrypt_192(KeyLeft, KeyRight, Ciphertext);
+
+    if (0 == memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+    {
+      printf("aria_decrypt_192 pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_decrypt_192 fail: ");
+      print_aria_u128(P);
+      fprintf(stderr, "\n");
+    }
+
+    KeyLeft    = (aria_u128_t ){ 0x0001020304050607, 0x08090a0b0c0d0e0f };
+    KeyRight   = (aria_u128_t ){ 0x1011121314151617, 0x18191a1b1c1d1e1f };
+    Plaintext  = (aria_u128_t ){ 0x0011223344556677, 0x8899aabbccddeeff };
+    Ciphertext = (aria_u128_t ){ 0xf92bd7c79fb72e2f, 0x2b8f80c1972d24fc };
+
+    C = aria_encrypt_256(KeyLeft, KeyRight, Plaintext);
+
+    if (0 == memcmp((const void *)&Ciphertext, (const void *)&C, sizeof(aria_u128_t)))
+    {
+      printf("aria_encrypt_256 pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_encrypt_256 fail: ");
+      print_aria_u128(C);
+      fprintf(stderr, "\n");
+    }
+
+    P = aria_decrypt_256(KeyLeft, KeyRight, Ciphertext);
+
+    if (0 == memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+    {
+      printf("aria_decrypt_256 pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_decrypt_256 fail: ");
+      print_aria_u128(P);
+      fprintf(stderr, "\n");
+    }
+
+    /* bulk vs per-block, with a count that exercises every kernel width:
+    ** 93 = 2 * 32 (GFNI or AVX2) + 16 (AES-NI or SSSE3) + 3 * 4 (scalar lanes) + 1
+    */
+    aria_key_schedule_t kse;
+    aria_key_schedule_t ksd;
+    aria_u128_t text[93];
+    aria_u128_t bulk[93];
+    uint32_t errors = 0u;
+
+    (void)xorshift128plus_seed(0x0123456789abcdefu);
+    (void)aria_init_key_schedule(&kse, KeyLeft, KeyRight, ENCRYPT, 256u);
+    (void)aria_init_key_schedule(&ksd, KeyLeft, KeyRight, DECRYPT, 256u);
+    for (uint32_t i = 0u; i < 93u; i++)
+    {
+      text[i] = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+    }
+    (void)aria_crypt_blocks(&kse, text, bulk, 93u);
+    for (uint32_t i = 0u; i < 93u; i++)
+    {
+      C = aria_crypt(&kse, text[i]);
+      if (0 != memcmp((const void *)&bulk[i], (const void *)&C, sizeof(aria_u128_t)))
+      {
+        errors++;
+      }
+    }
+    (void)aria_crypt_blocks(&ksd, bulk, bulk, 93u); /* in place */
+    if (0 != memcmp((const void *)text, (const void *)bulk, sizeof(text)))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_crypt_blocks pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_crypt_blocks fail: %u errors\n", errors);
+    }
+
+    /* every backend on its own, against the reference backend, at each key
+    ** size, since the scalar engines have a round loop per key size
+    */
+    static const uint32_t backend_sizes[3] = { 128u, 192u, 256u };
+    aria_key_schedule_t bke[3];
+    aria_key_schedule_t bkd[3];
+    aria_u128_t expect[3][93];
+    aria_key_schedule_t lane_ks[3][5]; /* per-block keys, both directions */
+    const aria_key_schedule_t *lane_pick[3][93];
+    aria_u128_t lane_expect[3][93];
+
+    (void)aria_set_backend(BACKEND_REFERENCE);
+    for (uint32_t k = 0u; k < 3u; k++)
+    {
+      (void)aria_init_key_schedule(&bke[k], KeyLeft, KeyRight, ENCRYPT, backend_sizes[k]);
+      (void)aria_init_key_schedule(&bkd[k], KeyLeft, KeyRight, DECRYPT, backend_sizes[k]);
+      for (uint32_t j = 0u; j < 5u; j++)
+      {
+        (void)aria_init_key_schedule(&lane_ks[k][j], (aria_u128_t ){ KeyLeft.left ^ j, KeyLeft.right }, KeyRight
+                                   , (0u != (j & 1u)) ? DECRYPT : ENCRYPT, backend_sizes[k]);
+      }
+      for (uint32_t i = 0u; i < 93u; i++)
+      {
+        expect[k][i] = aria_crypt(&bke[k], text[i]);
+        lane_pick[k][i] = &lane_ks[k][(i * 7u) % 5u];
+        lane_expect[k][i] = aria_crypt(&lane_ks[k][(i * 7u) % 5u], text[i]);
+      }
+    }
+    for (unsigned b = BACKEND_REFERENCE; b < BACKEND_COUNT; b++)
+    {
+      if (NO_ERROR != aria_set_backend((aria_backend_t )b))
+      {
+        printf("aria backend %s skipped (not supported)\n", aria_backend_name((aria_backend_t )b));
+        continue;
+      }
+      errors = (b == (unsigned )aria_get_backend()) ? 0u : 1u;
+      for (uint32_t k = 0u; k < 3u; k++)
+      {
+        (void)aria_crypt_blocks(&bke[k], text, bulk, 93u);
+        for (uint32_t i = 0u; i < 93u; i++)
+        {
+          C = aria_crypt(&bke[k], text[i]);
+          if ((0 != memcmp((const void *)&bulk[i], (const void *)&expect[k][i], sizeof(aria_u128_t)))
+              || (0 != memcmp((const void *)&C, (const void *)&expect[k][i], sizeof(aria_u128_t))))
+          {
+            errors++;
+          }
+        }
+        (void)aria_crypt_blocks(&bkd[k], bulk, bulk, 93u);
+        if (0 != memcmp((const void *)text, (const void *)bulk, sizeof(text)))
+        {
+          errors++;
+        }
+
+        /* in byte order, at an odd address, in place */
+        uint8_t bytes[1u + 93u * 16u];
+
+        for (uint32_t i = 0u; i < 93u; i++)
+        {
+          aria_store_block(&bytes[1u + 16u * i], text[i]);
+        }
+        (void)aria_crypt_bytes(&bke[k], &bytes[1], &bytes[1], 93u * 16u);
+        for (uint32_t i = 0u; i < 93u; i++)
+        {
+          C = aria_load_block(&bytes[1u + 16u * i]);
+          if (0 != memcmp((const void *)&C, (const void *)&expect[k][i], sizeof(aria_u128_t)))
+          {
+            errors++;
+          }
+        }
+
+        /* a schedule per block */
+        (void)aria_crypt_blocks_lanes(lane_pick[k], text, bulk, 93u);
+        if (0 != memcmp((const void *)bulk, (const void *)lane_expect[k], sizeof(bulk)))
+        {
+          errors++;
+        }
+      }
+      lane_pick[0][92] = &bke[2];
+      if (KEY_SIZE_BAD != aria_crypt_blocks_lanes(lane_pick[0], text, bulk, 93u))
+      {
+        errors++;
+      }
+      lane_pick[0][92] = &lane_ks[0][(92u * 7u) % 5u];
+      if (0u == errors)
+      {
+        printf("aria backend %s pass\n", aria_backend_name((aria_backend_t )b));
+      }
+      else
+      {
+        fprintf(stderr, "aria backend %s fail: %u errors\n", aria_backend_name((aria_backend_t )b), errors);
+      }
+    }
+    if ((BACKEND_BAD == aria_set_backend(BACKEND_COUNT))
+        && (NO_ERROR == aria_set_backend(BACKEND_AUTO))
+        && (BACKEND_AUTO != aria_get_backend()))
+    {
+      printf("aria_set_backend pass, using %s\n", aria_backend_name(aria_get_backend()));
+    }
+    else
+    {
+      fprintf(stderr, "aria_set_backend fail\n");
+    }
+
+    /* CTR: the first two blocks of the ARIA-128 CTR vector in the ARIA
+    ** specification's test vectors, then streaming in uneven pieces against
+    ** one call, and against the counter blocks encrypted one at a time
+    */
+    static const uint8_t ctr_P[32] =
+    {
+      0x11, 0x11, 0x11, 0x11, 0xaa, 0xaa, 0xaa, 0xaa, 0x11, 0x11, 0x11, 0x11, 0xbb, 0xbb, 0xbb, 0xbb,
+      0x11, 0x11, 0x11, 0x11, 0xcc, 0xcc, 0xcc, 0xcc, 0x11, 0x11, 0x11, 0x11, 0xdd, 0xdd, 0xdd, 0xdd
+    };
+    static const uint8_t ctr_C[32] =
+    {
+      0xac, 0x5d, 0x7d, 0xe8, 0x05, 0xa0, 0xbf, 0x1c, 0x57, 0xc8, 0x54, 0x50, 0x1a, 0xf6, 0x0f, 0xa1,
+      0x14, 0x97, 0xe2, 0xa3, 0x45, 0x19, 0xde, 0xa1, 0x56, 0x9e, 0x91, 0xe5, 0xb5, 0xcc, 0xae, 0x2f
+    };
+    static uint8_t ctr_text[3000];
+    static uint8_t ctr_one[3000];
+    static uint8_t ctr_pieces[3000];
+    aria_ctr_t ctr;
+    uint8_t out[32];
+
+    errors = 0u;
+    (void)aria_init_key_schedule(&kse, (aria_u128_t ){ 0x0011223344556677u, 0x8899aabbccddeeffu }, /* don't care */ Plaintext, ENCRYPT, 128u);
+    (void)aria_ctr_init(&ctr, (aria_u128_t ){ 0u, 0u });
+    (void)aria_ctr_xcrypt(&kse, &ctr, ctr_P, out, 32u);
+    if (0 != memcmp((const void *)ctr_C, (const void *)out, 32u))
+    {
+      errors++;
+    }
+
+    (void)aria_init_key_schedule(&kse, KeyLeft, KeyRight, ENCRYPT, 256u);
+    for (uint32_t i = 0u; i < sizeof(ctr_text); i++)
+    {
+      ctr_text[i] = (uint8_t )xorshift128plus_next();
+    }
+    const aria_u128_t iv = { 0x0123456789abcdefu, 0xfffffffffffffffeu }; /* carries into left */
+
+    (void)aria_ctr_init(&ctr, iv);
+    (void)aria_ctr_xcrypt(&kse, &ctr, ctr_text, ctr_one, sizeof(ctr_text));
+    (void)aria_ctr_init(&ctr, iv);
+    for (size_t done = 0u, piece = 0u; done < sizeof(ctr_text); done += piece)
+    {
+      piece = (size_t )(xorshift128plus_next() % 1200u);
+      if (piece > (sizeof(ctr_text) - done))
+      {
+        piece = sizeof(ctr_text) - done;
+      }
+      memcpy(&ctr_pieces[done], &ctr_text[done], piece);
+      (void)aria_ctr_xcrypt(&kse, &ctr, &ctr_pieces[done], &ctr_pieces[done], piece); /* in place */
+    }
+    if (0 != memcmp((const void *)ctr_one, (const void *)ctr_pieces, sizeof(ctr_one)))
+    {
+      errors++;
+    }
+    aria_u128_t counter = iv;
+    aria_u128_t k = counter;
+
+    for (uint32_t i = 0u; i < sizeof(ctr_text); i++)
+    {
+      if (0u == (i % 16u))
+      {
+        k = aria_crypt(&kse, counter);
+        if (0u == ++counter.right)
+        {
+          counter.left++;
+        }
+      }
+      uint64_t half = ((i % 16u) < 8u) ? k.left : k.right;
+
+      if (ctr_one[i] != (ctr_text[i] ^ (uint8_t )(half >> (56u - 8u * (i % 8u)))))
+      {
+        errors++;
+      }
+    }
+    if (CRYPTO_MODE_BAD != aria_ctr_xcrypt(&ksd, &ctr, ctr_text, ctr_one, 16u))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_ctr_xcrypt pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_ctr_xcrypt fail: %u errors\n", errors);
+    }
+
+    /* ECB and CBC, against aria_crypt() one block at a time; CBC decryption
+    ** in place and in pieces
+    */
+    static uint8_t cbc_text[2992]; /* 187 blocks */
+    static uint8_t cbc_c[2992];
+    static uint8_t cbc_p[2992];
+    const aria_u128_t cbc_iv = { 0x0f1e2d3c4b5a6978u, 0x8796a5b4c3d2e1f0u };
+    aria_u128_t chain = cbc_iv;
+
+    errors = 0u;
+    memcpy(cbc_text, ctr_text, sizeof(cbc_text));
+    (void)aria_ecb_crypt(&kse, cbc_text, cbc_c, sizeof(cbc_text));
+    (void)aria_cbc_encrypt(&kse, &chain, cbc_text, cbc_p, sizeof(cbc_text));
+    chain = cbc_iv;
+    for (uint32_t i = 0u; i < sizeof(cbc_text); i += 16u)
+    {
+      aria_u128_t p = { 0u, 0u };
+      aria_u128_t e, c;
+
+      for (uint32_t j = 0u; j < 16u; j++)
+      {
+        *((j < 8u) ? &p.left : &p.right) |= (uint64_t )cbc_text[i + j] << (56u - 8u * (j % 8u));
+      }
+      e = aria_crypt(&kse, p);
+      c = aria_crypt(&kse, xor(p, chain));
+      chain = c;
+      for (uint32_t j = 0u; j < 16u; j++)
+      {
+        unsigned shift = 56u - 8u * (j % 8u);
+
+        if ((cbc_c[i + j] != (uint8_t )(((j < 8u) ? e.left : e.right) >> shift))
+            || (cbc_p[i + j] != (uint8_t )(((j < 8u) ? c.left : c.right) >> shift)))
+        {
+          errors++;
+        }
+      }
+    }
+    (void)aria_ecb_crypt(&ksd, cbc_c, cbc_c, sizeof(cbc_c));
+    if (0 != memcmp((const void *)cbc_text, (const void *)cbc_c, sizeof(cbc_text)))
+    {
+      errors++;
+    }
+    chain = cbc_iv;
+    for (size_t done = 0u, piece = 0u; done < sizeof(cbc_p); done += piece)
+    {
+      piece = 16u * (size_t )(xorshift128plus_next() % 80u);
+      if (piece > (sizeof(cbc_p) - done))
+      {
+        piece = sizeof(cbc_p) - done;
+      }
+      (void)aria_cbc_decrypt(&ksd, &chain, &cbc_p[done], &cbc_p[done], piece);
+    }
+    if (0 != memcmp((const void *)cbc_text, (const void *)cbc_p, sizeof(cbc_text)))
+    {
+      errors++;
+    }
+    if ((ARG_BAD != aria_ecb_crypt(&kse, cbc_text, cbc_c, 15u))
+        || (CRYPTO_MODE_BAD != aria_cbc_decrypt(&kse, &chain, cbc_c, cbc_p, 16u)))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_ecb_crypt, aria_cbc_encrypt, aria_cbc_decrypt pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_ecb_crypt, aria_cbc_encrypt, aria_cbc_decrypt fail: %u errors\n", errors);
+    }
+
+    /* XTS, against xts_ref() for sector sizes around the batch and lane
+    ** boundaries and with stolen tails; decryption in place
+    */
+    static const size_t xts_lens[] = { 16u, 17u, 31u, 32u, 47u, 112u, 127u, 1024u, 1039u, 2992u, 4096u, 4111u };
+    static uint8_t xts_text[4111];
+    static uint8_t xts_c[sizeof(xts_text)];
+    static uint8_t xts_r[sizeof(xts_text)];
+    aria_key_schedule_t kst;
+
+    errors = 0u;
+    for (size_t i = 0u; i < sizeof(xts_text); i++)
+    {
+      xts_text[i] = (uint8_t )xorshift128plus_next();
+    }
+    (void)aria_init_key_schedule(&kst, KeyRight, KeyLeft, ENCRYPT, 256u);
+    for (size_t n = 0u; n < (sizeof(xts_lens) / sizeof(xts_lens[0])); n++)
+    {
+      const size_t len = xts_lens[n];
+      const uint64_t sector = 0x0123456789abcdefu + n;
+
+      (void)aria_xts_encrypt(&kse, &kst, sector, xts_text, xts_c, len);
+      xts_ref(&kse, &kst, sector, xts_text, xts_r, len);
+      if (0 != memcmp((const void *)xts_c, (const void *)xts_r, len))
+      {
+        errors++;
+      }
+      (void)aria_xts_decrypt(&ksd, &kst, sector, xts_c, xts_c, len);
+      if (0 != memcmp((const void *)xts_text, (const void *)xts_c, len))
+      {
+        errors++;
+      }
+    }
+    /* the largest data unit the standard allows, and one byte more */
+    static uint8_t xts_big[ARIA_XTS_MAX_LEN + 1u];
+
+    memset(xts_big, 0x5a, sizeof(xts_big));
+    if ((NO_ERROR != aria_xts_encrypt(&kse, &kst, 7u, xts_big, xts_big, ARIA_XTS_MAX_LEN))
+        || (NO_ERROR != aria_xts_decrypt(&ksd, &kst, 7u, xts_big, xts_big, ARIA_XTS_MAX_LEN))
+        || (ARG_BAD != aria_xts_encrypt(&kse, &kst, 7u, xts_big, xts_big, ARIA_XTS_MAX_LEN + 1u))
+        || (0x5au != xts_big[ARIA_XTS_MAX_LEN]))
+    {
+      errors++;
+    }
+    for (size_t i = 0u; i < sizeof(xts_big); i++)
+    {
+      if (0x5au != xts_big[i])
+      {
+        errors++;
+        break;
+      }
+    }
+    if ((ARG_BAD != aria_xts_encrypt(&kse, &kst, 0u, xts_text, xts_c, 15u))
+        || (CRYPTO_MODE_BAD != aria_xts_decrypt(&kse, &kst, 0u, xts_text, xts_c, 16u))
+        || (CRYPTO_MODE_BAD != aria_xts_encrypt(&kse, &ksd, 0u, xts_text, xts_c, 16u)))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_xts_encrypt, aria_xts_decrypt pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_xts_encrypt, aria_xts_decrypt fail: %u errors\n", errors);
+    }
+
+    /* CMAC, against cmac_ref() for a batch of ragged lengths, more messages
+    ** than lanes
+    */
+    static const uint8_t *cmac_msgs[300];
+    static size_t cmac_lens[300];
+    static uint8_t cmac_tags[16u * 300u];
+    uint8_t cmac_tag[16];
+
+    errors = 0u;
+    for (size_t i = 0u; i < 300u; i++)
+    {
+      cmac_lens[i] = (i < 4u) ? (16u * i) : (size_t )(xorshift128plus_next() % 600u);
+      cmac_msgs[i] = &xts_text[xorshift128plus_next() % (sizeof(xts_text) - 600u)];
+    }
+    (void)aria_cmac_batch(&kse, cmac_msgs, cmac_lens, cmac_tags, 300u);
+    for (size_t i = 0u; i < 300u; i++)
+    {
+      cmac_ref(&kse, cmac_msgs[i], cmac_lens[i], cmac_tag);
+      if (0 != memcmp((const void *)cmac_tag, (const void *)&cmac_tags[16u * i], 16u))
+      {
+        errors++;
+      }
+    }
+    (void)aria_cmac(&kse, cmac_msgs[299], cmac_lens[299], cmac_tag);
+    if ((0 != memcmp((const void *)cmac_tag, (const void *)&cmac_tags[16u * 299u], 16u))
+        || (NO_ERROR != aria_cmac_batch(&kse, NULL, NULL, NULL, 0u))
+        || (CRYPTO_MODE_BAD != aria_cmac(&ksd, xts_text, 16u, cmac_tag)))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_cmac, aria_cmac_batch pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_cmac, aria_cmac_batch fail: %u errors\n", errors);
+    }
+
+    /* the worker pool, against the single threaded functions, with lengths
+    ** that end in a partial chunk and (CTR) a partial block
+    */
+    static uint8_t pool_text[5u * 65536u + 4000u];
+    static uint8_t pool_one[sizeof(pool_text)];
+    static uint8_t pool_par[sizeof(pool_text)];
+    const size_t pool_len = sizeof(pool_text) - 3u;
+    aria_pool_t *pool;
+    aria_u128_t pool_iv = cbc_iv;
+
+    errors = 0u;
+    for (size_t i = 0u; i < sizeof(pool_text); i++)
+    {
+      pool_text[i] = (uint8_t )xorshift128plus_next();
+    }
+    if (NO_ERROR != aria_pool_create(&pool, 4u, 1))
+    {
+      errors++;
+    }
+    else
+    {
+      (void)aria_ctr_init(&ctr, iv);
+      (void)aria_ctr_xcrypt(&kse, &ctr, pool_text, pool_one, 7u);
+      (void)aria_ctr_xcrypt(&kse, &ctr, &pool_text[7], &pool_one[7], pool_len - 7u);
+      (void)aria_ctr_init(&ctr, iv);
+      (void)aria_pool_ctr_xcrypt(pool, &kse, &ctr, pool_text, pool_par, 7u);
+      (void)aria_pool_ctr_xcrypt(pool, &kse, &ctr, &pool_text[7], &pool_par[7], pool_len - 7u);
+      if (0 != memcmp((const void *)pool_one, (const void *)pool_par, pool_len))
+      {
+        errors++;
+      }
+      (void)aria_ecb_crypt(&kse, pool_text, pool_one, pool_len & ~(size_t )15u);
+      (void)aria_pool_ecb_crypt(pool, &kse, pool_text, pool_par, pool_len & ~(size_t )15u);
+      if (0 != memcmp((const void *)pool_one, (const void *)pool_par, pool_len & ~(size_t )15u))
+      {
+        errors++;
+      }
+      chain = cbc_iv;
+      (void)aria_cbc_decrypt(&ksd, &chain, pool_text, pool_one, pool_len & ~(size_t )15u);
+      memcpy(pool_par, pool_text, sizeof(pool_text));
+      (void)aria_pool_cbc_decrypt(pool, &ksd, &pool_iv, pool_par, pool_par, pool_len & ~(size_t )15u); /* in place */
+      if ((0 != memcmp((const void *)pool_one, (const void *)pool_par, pool_len & ~(size_t )15u))
+          || (0 != memcmp((const void *)&chain, (const void *)&pool_iv, sizeof(chain))))
+      {
+        errors++;
+      }
+      if (4u != aria_pool_threads(pool))
+      {
+        errors++;
+      }
+      aria_pool_destroy(pool);
+    }
+    if (0u == errors)
+    {
+      printf("aria_pool pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_pool fail: %u errors\n", errors);
+    }
+
+    /* the job queue, against one mode call per job, over random jobs under
+    ** mixed keys, sizes and ops, some large, with and without the pool
+    */
+    static aria_job_t qjobs[300];
+    aria_job_t *qdone[300];
+    size_t qoff[300];
+    aria_queue_t *queue;
+
+    errors = 0u;
+    for (uint32_t p = 0u; p < 2u; p++)
+    {
+      size_t off = 0u;
+      size_t polled = 0u;
+
+      if (NO_ERROR != aria_pool_create(&pool, 4u, 1))
+      {
+        errors++;
+        break;
+      }
+      if (NO_ERROR != aria_queue_create(&queue, (0u == p) ? NULL : pool, 300u))
+      {
+        aria_pool_destroy(pool);
+        errors++;
+        break;
+      }
+      memset(pool_par, 0, sizeof(pool_par));
+      for (uint32_t j = 0u; j < 300u; j++)
+      {
+        uint64_t r = xorshift128plus_next();
+        aria_job_t *job = &qjobs[j];
+
+        job->op   = (0u != (r & 1u)) ? JOB_CTR : JOB_ECB;
+        job->len  = (0u == ((r >> 1) % 16u)) ? (size_t )(1024u + ((r >> 8) % 4096u)) : (size_t )((r >> 8) % 300u);
+        job->ks   = &lane_ks[(r >> 24) % 3u][(JOB_CTR == job->op) ? (2u * ((r >> 32) % 3u)) : ((r >> 32) % 5u)];
+        job->iv   = (aria_u128_t ){ r, (0u != (r & 2u)) ? ~(uint64_t )(j % 8u) : r };  /* some counters wrap */
+        if (JOB_ECB == job->op)
+        {
+          job->len &= ~(size_t )15u;
+        }
+        job->in   = &pool_text[off];
+        job->out  = (0u != (r & 4u)) ? &pool_par[off] : &pool_one[off];
+        job->user = &qjobs[j];
+        if (job->out == pool_one)
+        {
+          memcpy(&pool_one[off], &pool_text[off], job->len);
+          job->in = &pool_one[off];                   /* in place */
+        }
+        qoff[j] = off;
+        off += job->len;
+        if ((NO_ERROR != aria_queue_submit(queue, job)) || (off > sizeof(pool_text)))
+        {
+          errors++;
+        }
+        if (149u == j)
+        {
+          (void)aria_queue_flush(queue);            /* a flush with jobs left to poll */
+        }
+      }
+      if (NO_ERROR != aria_queue_flush(queue))
+      {
+        errors++;
+      }
+      for (size_t n; 0u != (n = aria_queue_poll(queue, &qdone[polled], 7u)); polled += n)
+      {
+      }
+      for (uint32_t j = 0u; j < 300u; j++)
+      {
+        const aria_job_t *job = &qjobs[j];
+        uint8_t one[4096u + 1024u];
+
+        if (JOB_ECB == job->op)
+        {
+          (void)aria_ecb_crypt(job->ks, &pool_text[qoff[j]], one, job->len);
+        }
+        else
+        {
+          (void)aria_ctr_init(&ctr, job->iv);
+          (void)aria_ctr_xcrypt(job->ks, &ctr, &pool_text[qoff[j]], one, job->len);
+        }
+        if ((qdone[j] != job) || (job->user != job) || (NO_ERROR != job->status)
+            || (0 != memcmp((const void *)one, (const void *)job->out, job->len)))
+        {
+          errors++;
+        }
+      }
+      if (300u != polled)
+      {
+        errors++;
+      }
+      aria_queue_destroy(queue);
+      aria_pool_destroy(pool);
+    }
+
+    /* a full queue, and jobs it refuses */
+    if (NO_ERROR == aria_queue_create(&queue, NULL, 2u))
+    {
+      aria_job_t bad = qjobs[0];
+
+      bad.op  = JOB_ECB;
+      bad.len = 17u;
+      if (ARG_BAD != aria_queue_submit(queue, &bad))
+      {
+        errors++;
+      }
+      bad.op  = JOB_CTR;
+      bad.ks  = &lane_ks[0][1];
+      if (CRYPTO_MODE_BAD != aria_queue_submit(queue, &bad))
+      {
+        errors++;
+      }
+      static aria_key_schedule_t zeroed; /* e.g. a fresh arena slot */
+
+      bad.ks  = &zeroed;
+      if (KEY_SIZE_BAD != aria_queue_submit(queue, &bad))
+      {
+        errors++;
+      }
+      bad.ks  = &lane_ks[0][0];
+      bad.len = 0u;
+      if ((NO_ERROR != aria_queue_submit(queue, &bad)) || (NO_ERROR != aria_queue_submit(queue, &qjobs[1]))
+          || (RESOURCE_BAD != aria_queue_submit(queue, &qjobs[2])) || (NO_ERROR != aria_queue_flush(queue))
+          || (1u != aria_queue_poll(queue, qdone, 1u)) || (qdone[0] != &bad)
+          || (NO_ERROR != aria_queue_submit(queue, &qjobs[2]))      /* room once polled */
+          || (1u != aria_queue_poll(queue, qdone, 2u)) || (qdone[0] != &qjobs[1])) /* [2] not flushed */
+      {
+        errors++;
+      }
+      aria_queue_destroy(queue);
+    }
+    else
+    {
+      errors++;
+    }
+    /* a schedule spoilt after submit fails its batch, which every job in
+    ** it hears of, rather than leaving text unencrypted with NO_ERROR
+    */
+    if (NO_ERROR == aria_queue_create(&queue, NULL, 2u))
+    {
+      aria_key_schedule_t spoilt = lane_ks[2][0];
+      uint8_t qtext[32] = { 0u };
+      uint8_t qout[32];
+      aria_job_t good = { &lane_ks[2][0], JOB_ECB, { 0u, 0u }, qtext, qout, 16u, NULL, NO_ERROR };
+      aria_job_t gone = { &spoilt, JOB_ECB, { 0u, 0u }, &qtext[16], &qout[16], 16u, NULL, NO_ERROR };
+
+      if ((NO_ERROR != aria_queue_submit(queue, &good)) || (NO_ERROR != aria_queue_submit(queue, &gone)))
+      {
+        errors++;
+      }
+      spoilt.rounds = 0u;
+      (void)aria_queue_flush(queue);
+      if ((2u != aria_queue_poll(queue, qdone, 2u)) || (KEY_SIZE_BAD != good.status) || (KEY_SIZE_BAD != gone.status))
+      {
+        errors++;
+      }
+      aria_queue_destroy(queue);
+    }
+    else
+    {
+      errors++;
+    }
+    if (ARG_BAD != aria_queue_create(&queue, NULL, 0u))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_queue pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_queue fail: %u errors\n", errors);
+    }
+
+    /* dual schedules and aria_key_schedule_to_decrypt(), against separate
+    ** aria_init_key_schedule() calls, for each key size
+    */
+    static aria_dual_key_schedule_t dual;
+    static const uint32_t sizes[] = { 128u, 192u, 256u };
+
+    errors = ((0u != ((uintptr_t )&dual.enc % 64u)) || (0u != ((uintptr_t )&dual.dec % 64u))
+              || (0u != ((uintptr_t )dual.enc.ek % 16u))) ? 1u : 0u;
+    for (uint32_t n = 0u; n < 3u; n++)
+    {
+      aria_key_schedule_t ks;
+
+      (void)aria_init_key_schedule(&kse, KeyLeft, KeyRight, ENCRYPT, sizes[n]);
+      (void)aria_init_key_schedule(&ksd, KeyLeft, KeyRight, DECRYPT, sizes[n]);
+      (void)aria_init_dual_key_schedule(&dual, KeyLeft, KeyRight, sizes[n]);
+      ks = kse;
+      (void)aria_key_schedule_to_decrypt(&ks, &ks); /* in place */
+      if ((0 != memcmp((const void *)&dual.enc, (const void *)&kse, sizeof(kse)))
+          || (0 != memcmp((const void *)&dual.dec, (const void *)&ksd, sizeof(ksd)))
+          || (0 != memcmp((const void *)&ks, (const void *)&ksd, sizeof(ksd)))
+          || (CRYPTO_MODE_BAD != aria_key_schedule_to_decrypt(&ksd, &ks)))
+      {
+        errors++;
+      }
+    }
+    if (0u == errors)
+    {
+      printf("aria_init_dual_key_schedule, aria_key_schedule_to_decrypt pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_init_dual_key_schedule, aria_key_schedule_to_decrypt fail: %u errors\n", errors);
+    }
+
+    /* batched key setup, against aria_init_key_schedule() per key */
+    static aria_key_schedule_t batch[37];
+    static aria_u128_t lefts[37];
+    static aria_u128_t rights[37];
+
+    errors = 0u;
+    for (uint32_t i = 0u; i < 37u; i++)
+    {
+      lefts[i]  = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+      rights[i] = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+    }
+    for (uint32_t n = 0u; n < 6u; n++)
+    {
+      aria_cryto_mode_t mode = (n < 3u) ? ENCRYPT : DECRYPT;
+
+      (void)aria_init_key_schedules_batch(batch, lefts, rights, 37u, mode, sizes[n % 3u]);
+      for (uint32_t i = 0u; i < 37u; i++)
+      {
+        (void)aria_init_key_schedule(&kse, lefts[i], rights[i], mode, sizes[n % 3u]);
+        if (0 != memcmp((const void *)&batch[i], (const void *)&kse, sizeof(kse)))
+        {
+          errors++;
+        }
+      }
+    }
+    (void)aria_init_key_schedules_batch(batch, lefts, NULL, 37u, ENCRYPT, 128u);
+    for (uint32_t i = 0u; i < 37u; i++)
+    {
+      (void)aria_init_key_schedule(&kse, lefts[i], rights[i], ENCRYPT, 128u);
+      if (0 != memcmp((const void *)&batch[i], (const void *)&kse, sizeof(kse)))
+      {
+        errors++;
+      }
+    }
+    if ((KEY_SIZE_BAD != aria_init_key_schedules_batch(batch, lefts, rights, 1u, ENCRYPT, 64u))
+        || (ARG_BAD != aria_init_key_schedules_batch(batch, lefts, NULL, 1u, ENCRYPT, 256u)))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_init_key_schedules_batch pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_init_key_schedules_batch fail: %u errors\n", errors);
+    }
+
+    /* the key schedule cache: hits and misses, don't care key bits,
+    ** eviction, and every schedule as aria_init_key_schedule() gives it
+    */
+    aria_key_cache_t *cache;
+    aria_key_cache_stats_t cs;
+    aria_u128_t keys[6][2];
+
+    errors = 0u;
+    for (uint32_t i = 0u; i < 6u; i++)
+    {
+      keys[i][0] = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+      keys[i][1] = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+    }
+    if (NO_ERROR != aria_key_cache_create(&cache, 4u))
+    {
+      errors++;
+    }
+    else
+    {
+      /* 0 1 0 (hit) 2 3 4 (evicts 1) 0 (hit); then key 0 as 128 bits, twice,
+      ** with different don't care halves (evicts 2, then hits)
+      */
+      static const uint32_t order[] = { 0u, 1u, 0u, 2u, 3u, 4u, 0u, 5u, 5u };
+
+      for (uint32_t n = 0u; n < sizeof(order) / sizeof(order[0]); n++)
+      {
+        uint32_t k = (order[n] < 5u) ? order[n] : 0u;
+        uint32_t bits = (order[n] < 5u) ? 256u : 128u;
+        aria_u128_t right = (n < 8u) ? keys[k][1] : keys[5][1];
+        aria_key_schedule_t enc, dec;
+
+        (void)aria_key_cache_get(cache, keys[k][0], right, bits, &enc, &dec);
+        (void)aria_init_key_schedule(&kse, keys[k][0], right, ENCRYPT, bits);
+        (void)aria_init_key_schedule(&ksd, keys[k][0], right, DECRYPT, bits);
+        if ((0 != memcmp((const void *)&enc, (const void *)&kse, sizeof(kse)))
+            || (0 != memcmp((const void *)&dec, (const void *)&ksd, sizeof(ksd))))
+        {
+          errors++;
+        }
+      }
+      aria_key_cache_stats(cache, &cs);
+      if ((3u != cs.hits) || (6u != cs.misses) || (2u != cs.evictions) || (4u != cs.entries))
+      {
+        errors++;
+      }
+      aria_key_cache_destroy(cache);
+    }
+    if (0u == errors)
+    {
+      printf("aria_key_cache pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_key_cache fail: %u errors\n", errors);
+    }
+
+    /* the key schedule arena: alignment, compact handles, full, double free,
+    ** wiping, reuse; with huge pages asked for, which may not be had
+    */
+    aria_key_arena_t *arena;
+    aria_key_handle_t kh[9];
+
+    errors = 0u;
+    if (NO_ERROR != aria_key_arena_create(&arena, 8u, ARIA_ARENA_HUGEPAGES))
+    {
+      errors++;
+    }
+    else
+    {
+      for (uint32_t i = 0u; i < 8u; i++)
+      {
+        aria_key_schedule_t *ks;
+
+        if ((NO_ERROR != aria_key_arena_alloc(arena, &kh[i])) || (kh[i] >= 8u)
+            || (NULL == (ks = aria_key_arena_get(arena, kh[i]))) || (0u != ((uintptr_t )ks % 64u))
+            || (0u != ((uintptr_t )ks->ek % 16u)) || (0u != ks->rounds))
+        {
+          errors++;
+          continue;
+        }
+        (void)aria_init_key_schedule(ks, keys[i % 6u][0], keys[i % 6u][1], ENCRYPT, 256u);
+      }
+      (void)aria_init_key_schedule(&kse, keys[3][0], keys[3][1], ENCRYPT, 256u);
+      if ((RESOURCE_BAD != aria_key_arena_alloc(arena, &kh[8])) || (8u != aria_key_arena_live(arena))
+          || (0 != memcmp((const void *)aria_key_arena_get(arena, kh[3]), (const void *)&kse, sizeof(kse)))
+          || (NO_ERROR != aria_key_arena_free(arena, kh[3]))
+          || (ARG_BAD != aria_key_arena_free(arena, kh[3]))
+          || (ARG_BAD != aria_key_arena_free(arena, 8u))
+          || (NO_ERROR != aria_key_arena_alloc(arena, &kh[8])) || (kh[8] != kh[3])
+          || (0u != aria_key_arena_get(arena, kh[8])->rounds)
+          || (NULL != aria_key_arena_get(arena, 8u)))
+      {
+        errors++;
+      }
+      aria_key_arena_destroy(arena);
+    }
+    if (ARG_BAD != aria_key_arena_create(&arena, 0u, 0u))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_key_arena pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_key_arena fail: %u errors\n", errors);
+    }
+
+    /* GCM: vectors computed with an independent bitwise GHASH, for a 96-bit
+    ** IV and for an IV through GHASH, each with the portable GHASH and then
+    ** as picked for this CPU; then streaming in uneven pieces against one call
+    */
+    static const struct
+    {
+      uint32_t bits;
+      const char *key, *iv, *aad, *p, *c, *tag;
+    } gcm_kat[] =
+    {
+      { 128u, "000102030405060708090a0b0c0d0e0f"
+            , "cafebabefacedbaddecaf888"
+            , "feedfacedeadbeeffeedfacedeadbeefabaddad2"
+            , "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+              "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+            , "1b225be73ccb3d8c14d925d1646f0a88a93d5d266d52ce8124b48581d83e84da"
+              "2a0bc6c737f3c30cca1bbd048fd92d5247697a6d048fa63aae0d6444"
+            , "8c6390f29c025f99268f46ba75341018" },
+      { 256u, "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+            , "cafebabefacedbad"
+            , "feedfacedeadbeeffeedfacedeadbeefabaddad2"
+            , "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+              "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"
+            , "ea6653a1860edc4e5fa3035e220bc0ae26660842b10840ca12a1909b0f3cfa6a"
+              "65fb50ae34fa5d8fb5b547a23251e2906d79d5964042f762f9135e81"
+            , "f7618ed36ebc460627521c55e0e2ab29" },
+    };
+    static const aria_ghash_t gcm_ghash[] = { GHASH_TABLE, GHASH_AUTO };
+    aria_gcm_t gcm;
+    uint8_t gcm_tag[2][16];
+
+    errors = 0u;
+    for (uint32_t b = 0u; b < 2u; b++)
+    {
+      (void)aria_set_ghash(gcm_ghash[b]);
+      for (uint32_t v = 0u; v < sizeof(gcm_kat) / sizeof(gcm_kat[0]); v++)
+      {
+        uint8_t key[32], iv[16], aad[32], p[64], c[64], tag[16], buf[64], t[16];
+        uint64_t k[4] = { 0u, 0u, 0u, 0u };
+        size_t key_len = hex_bytes(gcm_kat[v].key, key);
+        size_t iv_len  = hex_bytes(gcm_kat[v].iv, iv);
+        size_t aad_len = hex_bytes(gcm_kat[v].aad, aad);
+        size_t p_len   = hex_bytes(gcm_kat[v].p, p);
+
+        (void)hex_bytes(gcm_kat[v].c, c);
+        (void)hex_bytes(gcm_kat[v].tag, tag);
+        for (size_t i = 0u; i < key_len; i++)
+        {
+          k[i / 8u] |= (uint64_t )key[i] << (56u - 8u * (i % 8u));
+        }
+        (void)aria_init_key_schedule(&kse, (aria_u128_t ){ k[0], k[1] }, (aria_u128_t ){ k[2], k[3] }, ENCRYPT, gcm_kat[v].bits);
+        (void)aria_gcm_init(&gcm, &kse);
+        (void)aria_gcm_start(&gcm, iv, iv_len);
+        (void)aria_gcm_aad(&gcm, aad, aad_len);
+        (void)aria_gcm_encrypt(&gcm, p, buf, p_len);
+        (void)aria_gcm_finish(&gcm, t, 16u);
+        if ((0 != memcmp((const void *)c, (const void *)buf, p_len)) || (0 != memcmp((const void *)tag, (const void *)t, 16u)))
+        {
+          errors++;
+        }
+        (void)aria_gcm_start(&gcm, iv, iv_len);
+        (void)aria_gcm_aad(&gcm, aad, aad_len);
+        (void)aria_gcm_decrypt(&gcm, buf, buf, p_len); /* in place */
+        if ((NO_ERROR != aria_gcm_check(&gcm, tag, 16u)) || (0 != memcmp((const void *)p, (const void *)buf, p_len)))
+        {
+          errors++;
+        }
+        tag[0] ^= 1u;
+        (void)aria_gcm_start(&gcm, iv, iv_len);
+        (void)aria_gcm_aad(&gcm, aad, aad_len);
+        (void)aria_gcm_decrypt(&gcm, c, buf, p_len);
+        if (TAG_BAD != aria_gcm_check(&gcm, tag, 16u))
+        {
+          errors++;
+        }
+      }
+
+      (void)aria_init_key_schedule(&kse, KeyLeft, KeyRight, ENCRYPT, 256u);
+      (void)aria_gcm_init(&gcm, &kse);
+      (void)aria_gcm_start(&gcm, (const uint8_t *)"twelve bytes", 12u);
+      (void)aria_gcm_aad(&gcm, ctr_text, 100u);
+      (void)aria_gcm_encrypt(&gcm, ctr_text, ctr_one, sizeof(ctr_text));
+      (void)aria_gcm_finish(&gcm, gcm_tag[b], 16u);
+      (void)aria_gcm_start(&gcm, (const uint8_t *)"twelve bytes", 12u);
+      (void)aria_gcm_aad(&gcm, ctr_text, 33u);
+      (void)aria_gcm_aad(&gcm, &ctr_text[33], 67u);
+      for (size_t done = 0u, piece = 0u; done < sizeof(ctr_text); done += piece)
+      {
+        piece = (size_t )(xorshift128plus_next() % 1200u);
+        if (piece > (sizeof(ctr_text) - done))
+        {
+          piece = sizeof(ctr_text) - done;
+        }
+        (void)aria_gcm_encrypt(&gcm, &ctr_text[done], &ctr_pieces[done], piece);
+      }
+      if ((0 != memcmp((const void *)ctr_one, (const void *)ctr_pieces, sizeof(ctr_one)))
+          || (NO_ERROR != aria_gcm_check(&gcm, gcm_tag[b], 16u)))
+      {
+        errors++;
+      }
+    }
+    if (0 != memcmp((const void *)gcm_tag[0], (const void *)gcm_tag[1], 16u))
+    {
+      errors++;
+    }
+
+    /* the GHASH engine does not follow the cipher backend */
+    (void)aria_set_backend(BACKEND_REFERENCE);
+    (void)aria_gcm_init(&gcm, &kse);
+    if ((gcm.pclmul ? NO_ERROR : BACKEND_BAD) != aria_set_ghash(GHASH_CLMUL))
+    {
+      errors++;
+    }
+    (void)aria_set_ghash(GHASH_AUTO);
+    (void)aria_set_backend(BACKEND_AUTO);
+    (void)aria_gcm_init(&gcm, &kse);
+    if (0u == errors)
+    {
+      printf("aria_gcm pass (%s GHASH)\n", gcm.pclmul ? (ARIA_ARM64 ? "PMULL" : "PCLMULQDQ") : "portable");
+    }
+    else
+    {
+      fprintf(stderr, "aria_gcm fail: %u errors\n", errors);
+    }
+
+    /* scatter/gather against the contiguous functions, with input and output
+    ** cut differently, and in place
+    */
+    aria_iovec_t iov_in[64];
+    aria_iovec_t iov_out[64];
+    size_t n_in;
+    size_t n_out;
+    uint8_t gcm_t[2][16];
+
+    errors = 0u;
+    (void)aria_ctr_init(&ctr, iv);
+    (void)aria_ctr_xcrypt(&kse, &ctr, ctr_text, ctr_one, sizeof(ctr_text));
+    n_in  = iov_cut(iov_in, 64u, ctr_text, sizeof(ctr_text));
+    n_out = iov_cut(iov_out, 64u, ctr_pieces, sizeof(ctr_pieces));
+    (void)aria_ctr_init(&ctr, iv);
+    (void)aria_ctr_xcrypt_iov(&kse, &ctr, iov_in, n_in, iov_out, n_out);
+    if (0 != memcmp((const void *)ctr_one, (const void *)ctr_pieces, sizeof(ctr_one)))
+    {
+      errors++;
+    }
+    (void)aria_ctr_init(&ctr, iv);
+    (void)aria_ctr_xcrypt_iov(&kse, &ctr, iov_out, n_out, iov_out, n_out); /* in place, decrypts */
+    if ((0 != memcmp((const void *)ctr_text, (const void *)ctr_pieces, sizeof(ctr_text)))
+        || (ARG_BAD != aria_ctr_xcrypt_iov(&kse, &ctr, iov_in, n_in, iov_out, n_out - 1u)))
+    {
+      errors++;
+    }
+
+    (void)aria_gcm_start(&gcm, (const uint8_t *)"twelve bytes", 12u);
+    (void)aria_gcm_aad(&gcm, ctr_text, 100u);
+    (void)aria_gcm_encrypt(&gcm, ctr_text, ctr_one, sizeof(ctr_text));
+    (void)aria_gcm_finish(&gcm, gcm_t[0], 16u);
+    (void)aria_gcm_start(&gcm, (const uint8_t *)"twelve bytes", 12u);
+    n_out = iov_cut(iov_out, 64u, ctr_text, 100u);
+    (void)aria_gcm_aad_iov(&gcm, iov_out, n_out);
+    n_out = iov_cut(iov_out, 64u, ctr_pieces, sizeof(ctr_pieces));
+    (void)aria_gcm_encrypt_iov(&gcm, iov_in, n_in, iov_out, n_out);
+    (void)aria_gcm_finish(&gcm, gcm_t[1], 16u);
+    if ((0 != memcmp((const void *)ctr_one, (const void *)ctr_pieces, sizeof(ctr_one)))
+        || (0 != memcmp((const void *)gcm_t[0], (const void *)gcm_t[1], 16u)))
+    {
+      errors++;
+    }
+    (void)aria_gcm_start(&gcm, (const uint8_t *)"twelve bytes", 12u);
+    (void)aria_gcm_aad(&gcm, ctr_text, 100u);
+    (void)aria_gcm_decrypt_iov(&gcm, iov_out, n_out, iov_out, n_out); /* in place */
+    if ((NO_ERROR != aria_gcm_check(&gcm, gcm_t[0], 16u))
+        || (0 != memcmp((const void *)ctr_text, (const void *)ctr_pieces, sizeof(ctr_text))))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("aria_ctr_xcrypt_iov, aria_gcm_aad_iov, aria_gcm_encrypt_iov, aria_gcm_decrypt_iov pass\n");
+    }
+    else
+    {
+      fprintf(stderr, "aria_ctr_xcrypt_iov, aria_gcm_*_iov fail: %u errors\n", errors);
+    }
+
+    /* usage counters: a known mix of calls, one of them from a thread that
+    ** has exited by the snapshot; without ARIA_STATS, all zero
+    */
+    aria_stats_t st;
+    uint8_t st_text[64] = { 0u };
+    pthread_t st_thread;
+
+    errors = 0u;
+    aria_stats_reset();
+    (void)aria_init_key_schedule(&kse, KeyLeft, KeyLeft, ENCRYPT, 128u); /* 1 key_inits */
+    (void)aria_key_schedule_to_decrypt(&kse, &ksd);                     /* 1 key_to_decrypt */
+    (void)aria_crypt(&kse, Plaintext);                                  /* 1 crypt_calls, 1 blocks */
+    (void)aria_ecb_crypt(&kse, st_text, st_text, 64u);                  /* 1 bulk_calls, 4 blocks */
+    (void)aria_ctr_init(&ctr, Plaintext);
+    (void)aria_ctr_xcrypt(&kse, &ctr, st_text, st_text, 40u);           /* 1 bulk, 2 blocks, 1 crypt */
+    if ((0 != pthread_create(&st_thread, NULL, stats_thread, &kse))
+        || (0 != pthread_join(st_thread, NULL)))                        /* 1 crypt_calls, 1 blocks */
+    {
+      errors++;
+    }
+    if ((ARG_BAD != aria_stats_snapshot(NULL)) || (NO_ERROR != aria_stats_snapshot(&st)))
+    {
+      errors++;
+    }
+    else if (st.backend != aria_get_backend())
+    {
+      errors++;
+    }
+#if ARIA_STATS
+    else if ((1 != st.enabled) || (3u != st.crypt_calls) || (2u != st.bulk_calls) || (9u != st.blocks)
+             || (1u != st.key_inits) || (1u != st.key_to_decrypt) || (64u != st.ecb_bytes)
+             || (40u != st.ctr_bytes) || (0u != st.cbc_bytes) || (0u != st.gcm_bytes))
+    {
+      errors++;
+    }
+    aria_stats_reset();
+    (void)aria_stats_snapshot(&st);
+    if ((0u != st.crypt_calls) || (0u != st.blocks) || (0u != st.ecb_bytes))
     {
-      printf("aria_encrypt_192 pass\n");
+      errors++;
     }
-    else
+#else
+    else if ((0 != st.enabled) || (0 != st.perf) || (0u != st.crypt_calls) || (0u != st.blocks)
+             || (0u != st.key_inits) || (0u != st.ctr_bytes))
     {
-      fprintf(stderr, "aria_encrypt_192 fail: ");
-      print_aria_u128(C);
-      fprintf(stderr, "\n");
+      errors++;
     }
-
-    P = aria_decrypt_192(KeyLeft, KeyRight, Ciphertext);
-
-    if (0 == memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+#endif
+    if (0u == errors)
     {
-      printf("aria_decrypt_192 pass\n");
+      printf("aria_stats_snapshot pass\n");
     }
     else
     {
-      fprintf(stderr, "aria_decrypt_192 fail: ");
-      print_aria_u128(P);
-      fprintf(stderr, "\n");
+      fprintf(stderr, "aria_stats_snapshot fail: %u errors\n", errors);
     }
 
-    KeyLeft    = (aria_u128_t ){ 0x0001020304050607, 0x08090a0b0c0d0e0f };
-    KeyRight   = (aria_u128_t ){ 0x1011121314151617, 0x18191a1b1c1d1e1f };
-    Plaintext  = (aria_u128_t ){ 0x0011223344556677, 0x8899aabbccddeeff };
-    Ciphertext = (aria_u128_t ){ 0xf92bd7c79fb72e2f, 0x2b8f80c1972d24fc };
+    /* the test data generator: lane 0 is the xorshift128plus_seed() stream,
+    ** a lane given another's state repeats its outputs, and fills of
+    ** multiples of the lane count join up
+    */
+    xorshift128plus_lanes_t lanes;
+    xorshift128plus_lanes_t same;
+    static uint64_t whole[4u * 103u];
+    static uint64_t parts[4u * 103u];
 
-    C = aria_encrypt_256(KeyLeft, KeyRight, Plaintext);
+    errors = 0u;
+    xorshift128plus_lanes_seed(&lanes, 12345u);
+    for (uint32_t l = 0u; l < XORSHIFT128PLUS_LANES; l++)
+    {
+      same.s[0][l] = lanes.s[0][1];
+      same.s[1][l] = lanes.s[1][1];
+    }
+    xorshift128plus_fill(&lanes, whole, sizeof(whole) / sizeof(whole[0]));
+    xorshift128plus_fill(&same, parts, sizeof(parts) / sizeof(parts[0]));
+    xorshift128plus_seed(12345u);
+    for (uint32_t i = 0u; i < (sizeof(whole) / sizeof(whole[0])); i += XORSHIFT128PLUS_LANES)
+    {
+      if (whole[i] != xorshift128plus_next())
+      {
+        errors++;
+      }
+      for (uint32_t l = 0u; l < XORSHIFT128PLUS_LANES; l++)
+      {
+        if (parts[i + l] != whole[i + 1u])
+        {
+          errors++;
+        }
+      }
+    }
+    xorshift128plus_lanes_seed(&lanes, 12345u);
+    for (size_t done = 0u, n; done < (sizeof(parts) / sizeof(parts[0])); done += n)
+    {
+      n = XORSHIFT128PLUS_LANES * ((size_t )(xorshift128plus_next() % 9u));
+      if (n > ((sizeof(parts) / sizeof(parts[0])) - done))
+      {
+        n = (sizeof(parts) / sizeof(parts[0])) - done;
+      }
+      xorshift128plus_fill(&lanes, &parts[done], n);
+    }
+    xorshift128plus_fill(&lanes, parts, 3u); /* a ragged end writes only n values */
+    if ((0 != memcmp((const void *)&whole[3], (const void *)&parts[3], sizeof(whole) - (3u * sizeof(whole[0]))))
+        || (0 == memcmp((const void *)whole, (const void *)parts, 3u * sizeof(whole[0]))))
+    {
+      errors++;
+    }
+    /* lanes 1.. are a jump apart */
+    xorshift128plus_t x128;
 
-    if (0 == memcmp((const void *)&Ciphertext, (const void *)&C, sizeof(aria_u128_t)))
+    xorshift128plus_seed_r(&x128, 12345u);
+    xorshift128plus_jump(&x128);
+    if (whole[1] != xorshift128plus_next_r(&x128))
     {
-      printf("aria_encrypt_256 pass\n");
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("xorshift128plus_fill pass\n");
     }
     else
     {
-      fprintf(stderr, "aria_encrypt_256 fail: ");
-      print_aria_u128(C);
-      fprintf(stderr, "\n");
+      fprintf(stderr, "xorshift128plus_fill fail: %u errors\n", errors);
     }
 
-    P = aria_decrypt_256(KeyLeft, KeyRight, Ciphertext);
+    /* the generator contexts: each matches its global wrapper, and the jumps
+    ** land where x^(2^64) and x^(2^512) modulo the characteristic polynomials
+    ** put them, computed independently
+    */
+    xorshift64star_t x64;
+    xorshift1024star_t x1024;
 
-    if (0 == memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+    errors = 0u;
+    xorshift64star_seed(777u);
+    xorshift64star_seed_r(&x64, 777u);
+    xorshift128plus_seed(777u);
+    xorshift128plus_seed_r(&x128, 777u);
+    xorshift1024star_seed(777u);
+    xorshift1024star_seed_r(&x1024, 777u);
+    for (uint32_t i = 0u; i < 100u; i++)
     {
-      printf("aria_decrypt_256 pass\n");
+      if ((xorshift64star_next() != xorshift64star_next_r(&x64))
+          || (xorshift128plus_next() != xorshift128plus_next_r(&x128))
+          || (xorshift1024star_next() != xorshift1024star_next_r(&x1024)))
+      {
+        errors++;
+      }
+    }
+    xorshift128plus_seed_r(&x128, 12345u);
+    xorshift128plus_jump(&x128);
+    xorshift1024star_seed_r(&x1024, 12345u);
+    xorshift1024star_jump(&x1024);
+    if ((0x420e865edb3554deu != xorshift128plus_next_r(&x128))
+        || (0xf111bd1678bc18b9u != xorshift1024star_next_r(&x1024)))
+    {
+      errors++;
+    }
+    if (0u == errors)
+    {
+      printf("xorshift64star_next_r, xorshift128plus_jump, xorshift1024star_jump pass\n");
     }
     else
     {
-      fprintf(stderr, "aria_decrypt_256 fail: ");
-      print_aria_u128(P);
-      fprintf(stderr, "\n");
+      fprintf(stderr, "xorshift contexts fail: %u errors\n", errors);
     }
 
   }
@@ -1030,29 +3479,75 @@ int main (int argc, char **argv)
 
     (void)xorshift128plus_seed(0x5a5a5a5a5a5a5a5au);
 
+    fprintf(stderr, "Using the %s backend\n", aria_backend_name(aria_get_backend()));
+
+    /* one block, for the cycle counter; see ariabench for the full picture */
+    {
+      aria_key_schedule_t ks;
+      aria_u128_t block = { xorshift128plus_next(), xorshift128plus_next() };
+      uint64_t best = UINT64_MAX;
+
+      (void)aria_init_key_schedule(&ks, block, block, ENCRYPT, 128u);
+      for (uint32_t i = 0u; i < 1000u; i++)
+      {
+        uint64_t start = timer_e_cycles();
+
+        block = aria_crypt(&ks, block);
+
+        uint64_t end = timer_e_cycles_end();
+
+        if (timer_e_cycles_elapsed(start, end) < best)
+        {
+          best = timer_e_cycles_elapsed(start, end);
+        }
+      }
+      fprintf(stderr, "aria_crypt ARIA-128: %" PRIu64 " cycles per block at best (cycle counter %.3f GHz)\n"
+                    , best
+                    , timer_e_cycles_hz() / 1e9
+              );
+    }
+
     const uint32_t iterations = 1000000u;
 
     uint32_t errors = 0u;
 
+    /* random keys and text are made a chunk at a time between timings, so
+    ** the generator is not timed
+    */
+    xorshift128plus_lanes_t lanes;
+    static uint64_t rnd[6u * 1024u];
+    double busy = 0.0;
+
+    xorshift128plus_lanes_seed(&lanes, 0x5a5a5a5a5a5a5a5au);
+
     double startm = timer_e_nanoseconds();
 #if 0
     double startg = timer_e_nanoseconds_gtod();
 #endif
 
-    for (uint32_t i = 0u; i < iterations; i++)
+    for (uint32_t i = 0u; i < iterations; i += 1024u)
     {
-      aria_u128_t KeyLeft    = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
-      aria_u128_t KeyRight   = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
-      aria_u128_t Plaintext  = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+      xorshift128plus_fill(&lanes, rnd, 6u * 1024u);
 
-      aria_u128_t Ciphertext = aria_encrypt_256(KeyLeft, KeyRight, Plaintext);
+      double startc = timer_e_nanoseconds();
 
-      aria_u128_t P = aria_decrypt_256(KeyLeft, KeyRight, Ciphertext);
-
-      if (0 != memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+      for (uint32_t j = 0u; (j < 1024u) && ((i + j) < iterations); j++)
       {
-        errors++;
+        const uint64_t *r = &rnd[6u * j];
+        aria_u128_t KeyLeft    = (aria_u128_t ){ r[0], r[1] };
+        aria_u128_t KeyRight   = (aria_u128_t ){ r[2], r[3] };
+        aria_u128_t Plaintext  = (aria_u128_t ){ r[4], r[5] };
+
+        aria_u128_t Ciphertext = aria_encrypt_256(KeyLeft, KeyRight, Plaintext);
+
+        aria_u128_t P = aria_decrypt_256(KeyLeft, KeyRight, Ciphertext);
+
+        if (0 != memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+        {
+          errors++;
+        }
       }
+      busy += timer_e_nanoseconds() - startc;
     }
 
     double endm = timer_e_nanoseconds();
@@ -1066,10 +3561,11 @@ int main (int argc, char **argv)
                   , errors
             );
 #else
-    fprintf(stderr, "For %u iterations: %g ns per iteration with %u errors\n"
+    fprintf(stderr, "For %u iterations: %g ns per iteration with %u errors (%g ns with the generator)\n"
                   , iterations
-                  , (endm - startm) / iterations
+                  , busy / iterations
                   , errors
+                  , (endm - startm) / iterations
             );
 #endif
 
@@ -1081,33 +3577,74 @@ int main (int argc, char **argv)
 
     const uint32_t keystride = 128u * 2048u;
 
-    startm = timer_e_nanoseconds();
-    
-    for (uint32_t i = 0u; i < iterations; i++)
+    busy = 0.0;
+
+    for (uint32_t i = 0u; i < iterations; i += 1024u)
     {
-      if ((i % keystride) == 0)
+      xorshift128plus_fill(&lanes, rnd, 6u * 1024u);
+
+      double startc = timer_e_nanoseconds();
+
+      for (uint32_t j = 0u; (j < 1024u) && ((i + j) < iterations); j++)
       {
-        aria_u128_t KeyLeft   = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
-        aria_u128_t KeyRight  = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
-        err = aria_init_key_schedule(&kse, KeyLeft, KeyRight, ENCRYPT, 256u);
-        if (NO_ERROR != err)
+        const uint64_t *r = &rnd[6u * j];
+
+        if (((i + j) % keystride) == 0)
         {
-          fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+          aria_u128_t KeyLeft   = (aria_u128_t ){ r[2], r[3] };
+          aria_u128_t KeyRight  = (aria_u128_t ){ r[4], r[5] };
+          err = aria_init_key_schedule(&kse, KeyLeft, KeyRight, ENCRYPT, 256u);
+          if (NO_ERROR != err)
+          {
+            fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+          }
+          err = aria_init_key_schedule(&ksd, KeyLeft, KeyRight, DECRYPT, 256u);
+          if (NO_ERROR != err)
+          {
+            fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+          }
         }
-        err = aria_init_key_schedule(&ksd, KeyLeft, KeyRight, DECRYPT, 256u);
-        if (NO_ERROR != err)
+
+        aria_u128_t Plaintext  = (aria_u128_t ){ r[0], r[1] };
+
+        aria_u128_t Ciphertext = aria_crypt(&kse, Plaintext);
+
+        aria_u128_t P = aria_crypt(&ksd, Ciphertext);
+
+        if (0 != memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
         {
-          fprintf(stderr, "aria_init_key_schedule returned error code %d\n", err);
+          errors++;
         }
       }
+      busy += timer_e_nanoseconds() - startc;
+    }
+
+    fprintf(stderr, "For %u iterations %u keystride: %g ns per iteration with %u errors\n"
+                  , iterations
+                  , keystride
+                  , busy / iterations
+                  , errors
+            );
 
-      aria_u128_t Plaintext  = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+    errors = 0u;
+
+    static aria_u128_t text[1024];
+    static aria_u128_t ctxt[1024];
 
-      aria_u128_t Ciphertext = aria_crypt(&kse, Plaintext);
+    startm = timer_e_nanoseconds();
 
-      aria_u128_t P = aria_crypt(&ksd, Ciphertext);
+    const uint32_t bulkiterations = (iterations / 1024u) * 1024u;
 
-      if (0 != memcmp((const void *)&Plaintext, (const void *)&P, sizeof(aria_u128_t)))
+    for (uint32_t i = 0u; i < bulkiterations; i += 1024u)
+    {
+      xorshift128plus_fill(&lanes, rnd, 2u * 1024u);
+      for (uint32_t j = 0u; j < 1024u; j++)
+      {
+        text[j] = (aria_u128_t ){ rnd[2u * j], rnd[(2u * j) + 1u] };
+      }
+      (void)aria_crypt_blocks(&kse, text, ctxt, 1024u);
+      (void)aria_crypt_blocks(&ksd, ctxt, ctxt, 1024u);
+      if (0 != memcmp((const void *)text, (const void *)ctxt, sizeof(text)))
       {
         errors++;
       }
@@ -1115,11 +3652,261 @@ int main (int argc, char **argv)
 
     endm = timer_e_nanoseconds();
 
-    fprintf(stderr, "For %u iterations %u keystride: %g ns per iteration with %u errors\n"
+    fprintf(stderr, "For %u iterations 1024 blocks per call: %g ns per iteration with %u errors\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+                  , errors
+            );
+
+    aria_ctr_t ctr;
+
+    (void)aria_ctr_init(&ctr, (aria_u128_t ){ 0u, 0u });
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 1024u)
+    {
+      (void)aria_ctr_xcrypt(&kse, &ctr, (const uint8_t *)text, (uint8_t *)ctxt, sizeof(text));
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_ctr_xcrypt 16 KB per call: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 1024u)
+    {
+      (void)aria_crypt_bytes(&kse, (const uint8_t *)text, (uint8_t *)ctxt, sizeof(text));
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_crypt_bytes 16 KB per call: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    /* the test data generator, one value per call and a buffer at a time */
+    startm = timer_e_nanoseconds();
+
+    volatile uint64_t sink; /* the values must be made */
+
+    for (uint32_t i = 0u; i < (4u * iterations); i++)
+    {
+      sink = xorshift128plus_next();
+    }
+
+    endm = timer_e_nanoseconds();
+
+    double per_next = (endm - startm) / (4u * iterations);
+    uint32_t filled = 0u;
+
+    startm = timer_e_nanoseconds();
+
+    for (; filled < (4u * iterations); filled += (6u * 1024u))
+    {
+      xorshift128plus_fill(&lanes, rnd, 6u * 1024u);
+      sink = rnd[filled % 1024u];
+    }
+
+    endm = timer_e_nanoseconds();
+    (void)sink;
+
+    fprintf(stderr, "xorshift128plus_next %g ns per value, xorshift128plus_fill %g ns per value\n"
+                  , per_next
+                  , (endm - startm) / filled
+            );
+
+    aria_key_cache_t *cache;
+    aria_key_cache_stats_t cs;
+    static aria_u128_t keys[1000];
+
+    for (uint32_t i = 0u; i < 1000u; i++)
+    {
+      keys[i] = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+    }
+    static aria_key_schedule_t schedules[1000];
+
+    memset(schedules, 0, sizeof(schedules)); /* not timing page faults */
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < 1000u; i++)
+    {
+      (void)aria_init_key_schedule(&schedules[i], keys[i], keys[999u - i], ENCRYPT, 256u);
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For 1000 keys aria_init_key_schedule: %g ns per key\n", (endm - startm) / 1000u);
+
+    startm = timer_e_nanoseconds();
+
+    (void)aria_init_key_schedules_batch(schedules, keys, keys, 1000u, ENCRYPT, 256u);
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For 1000 keys aria_init_key_schedules_batch: %g ns per key\n", (endm - startm) / 1000u);
+
+    (void)aria_key_cache_create(&cache, 1024u);
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < iterations; i++)
+    {
+      (void)aria_key_cache_get(cache, keys[i % 1000u], keys[(i + 1u) % 1000u], 256u, &kse, &ksd);
+    }
+
+    endm = timer_e_nanoseconds();
+
+    aria_key_cache_stats(cache, &cs);
+    aria_key_cache_destroy(cache);
+    fprintf(stderr, "For %u aria_key_cache_get of 1000 keys: %g ns per get, %" PRIu64 " misses\n"
                   , iterations
-                  , keystride
                   , (endm - startm) / iterations
-                  , errors
+                  , cs.misses
+            );
+
+    aria_u128_t chain = { 0u, 0u };
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 1024u)
+    {
+      (void)aria_cbc_decrypt(&ksd, &chain, (const uint8_t *)text, (uint8_t *)ctxt, sizeof(text));
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_cbc_decrypt 16 KB per call: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 256u)
+    {
+      (void)aria_xts_encrypt(&kse, &kse, i, (const uint8_t *)text, (uint8_t *)ctxt, 4096u);
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_xts_encrypt 4 KB sectors: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    /* 256 messages of 64 bytes per call, against one call per message */
+    static const uint8_t *macs[256];
+    static size_t maclens[256];
+    static uint8_t mactags[16u * 256u];
+
+    for (uint32_t j = 0u; j < 256u; j++)
+    {
+      macs[j]    = (const uint8_t *)&text[4u * j];
+      maclens[j] = 64u;
+    }
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 1024u)
+    {
+      (void)aria_cmac_batch(&kse, macs, maclens, mactags, 256u);
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_cmac_batch 64-byte messages: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 4u)
+    {
+      (void)aria_cmac(&kse, macs[(i / 4u) % 256u], 64u, mactags);
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_cmac 64-byte messages: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    /* 256 one-block jobs under 5 keys per flush, against one call per job */
+    static aria_job_t tjobs[256];
+    aria_job_t *tdone[256];
+    aria_queue_t *tqueue;
+
+    (void)aria_queue_create(&tqueue, NULL, 256u);
+    for (uint32_t j = 0u; j < 256u; j++)
+    {
+      tjobs[j] = (aria_job_t ){ &schedules[j % 5u], JOB_ECB, { 0u, 0u }, (const uint8_t *)&text[j], (uint8_t *)&ctxt[j], 16u, NULL, NO_ERROR };
+    }
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 256u)
+    {
+      for (uint32_t j = 0u; j < 256u; j++)
+      {
+        (void)aria_queue_submit(tqueue, &tjobs[j]);
+      }
+      (void)aria_queue_flush(tqueue);
+      (void)aria_queue_poll(tqueue, tdone, 256u);
+    }
+
+    endm = timer_e_nanoseconds();
+
+    aria_queue_destroy(tqueue);
+    fprintf(stderr, "For %u blocks aria_queue one-block jobs: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 256u)
+    {
+      for (uint32_t j = 0u; j < 256u; j++)
+      {
+        (void)aria_ecb_crypt(tjobs[j].ks, tjobs[j].in, tjobs[j].out, 16u);
+      }
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_ecb_crypt one-block jobs: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
+            );
+
+    aria_gcm_t gcm;
+    uint8_t tag[16];
+
+    (void)aria_gcm_init(&gcm, &kse);
+
+    startm = timer_e_nanoseconds();
+
+    for (uint32_t i = 0u; i < bulkiterations; i += 1024u)
+    {
+      (void)aria_gcm_start(&gcm, (const uint8_t *)"twelve bytes", 12u);
+      (void)aria_gcm_encrypt(&gcm, (const uint8_t *)text, (uint8_t *)ctxt, sizeof(text));
+      (void)aria_gcm_finish(&gcm, tag, sizeof(tag));
+    }
+
+    endm = timer_e_nanoseconds();
+
+    fprintf(stderr, "For %u blocks aria_gcm_encrypt 16 KB per call: %g ns per block\n"
+                  , bulkiterations
+                  , (endm - startm) / bulkiterations
             );
   }
 }
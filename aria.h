@@ -1,10 +1,14 @@
 /* aria.h
 */
 
+#ifndef ARIA_H
+#define ARIA_H
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef struct aria_u128_s { uint64_t left; uint64_t right; } aria_u128_t;
@@ -21,13 +25,38 @@ typedef enum aria_error_code_e
   ARG_BAD,
   KEY_SIZE_BAD,
   CRYPTO_MODE_BAD,
+  BACKEND_BAD,
+  TAG_BAD,
+  RESOURCE_BAD,
 } aria_error_code_t;
 
+/* Round engines; see aria_set_backend() */
+typedef enum aria_backend_e
+{
+  BACKEND_AUTO = 0,   /* the fastest one this CPU supports */
+  BACKEND_REFERENCE,  /* portable, as written in RFC 5794 */
+  BACKEND_TTABLE,     /* portable, 32-bit table lookups */
+  BACKEND_SSSE3,      /* x86, byte sliced, 16 blocks per pass */
+  BACKEND_AVX2,       /* x86, byte sliced, 32 blocks per pass */
+  BACKEND_AESNI,      /* x86, byte sliced with AES-NI S-boxes, 16 blocks */
+  BACKEND_GFNI,       /* x86, byte sliced with GFNI S-boxes, 32 blocks */
+  BACKEND_BITSLICE,   /* portable, bitsliced, 64 blocks; see aria_set_backend() */
+  BACKEND_NEON,       /* AArch64, byte sliced, 16 blocks per pass */
+  BACKEND_NEON_AES,   /* AArch64, byte sliced with AES instruction S-boxes, 16 blocks */
+  BACKEND_COUNT
+} aria_backend_t;
+
+/* rounds and mode come first, on the cache line of the first round keys,
+** padded to 16 bytes so that in a schedule at a 64-byte boundary no round
+** key straddles a line: a 128-bit schedule (16 + 13 * 16 bytes) is then
+** four lines, not five
+*/
 typedef struct aria_key_schedule_s
 {
-  aria_u128_t       ek[18];
-  aria_cryto_mode_t mode;
   uint32_t          rounds;
+  aria_cryto_mode_t mode;
+  uint32_t          pad_[2];
+  aria_u128_t       ek[18];
 } aria_key_schedule_t;
 
 aria_error_code_t 
@@ -37,9 +66,561 @@ aria_init_key_schedule (aria_key_schedule_t *keysched
                       , aria_cryto_mode_t  mode
                       , uint32_t key_size_in_bits);
 
+/* Both directions from one master key, for services that need both: the
+** key derivation runs once, and the decryption round keys are made from the
+** encryption round keys. Each direction's schedule starts on a 64-byte
+** boundary (with GCC or Clang), so a 256-bit schedule spans five cache
+** lines; allocate with 64-byte alignment to keep that.
+*/
+#if defined(__GNUC__)
+#define ARIA_ALIGN64 __attribute__((aligned(64)))
+#else
+#define ARIA_ALIGN64
+#endif
+
+typedef struct aria_dual_key_schedule_s
+{
+  aria_key_schedule_t enc ARIA_ALIGN64;
+  aria_key_schedule_t dec ARIA_ALIGN64;
+} aria_dual_key_schedule_t;
+
+aria_error_code_t
+aria_init_dual_key_schedule (aria_dual_key_schedule_t *keysched
+                           , aria_u128_t              KeyLeft
+                           , aria_u128_t              KeyRight
+                           , uint32_t                 key_size_in_bits);
+
+/* aria_init_key_schedule() for count keys at once, keysched[i] from
+** KeyLeft[i] and KeyRight[i]; KeyRight may be NULL for 128-bit keys
+*/
+aria_error_code_t
+aria_init_key_schedules_batch (aria_key_schedule_t *keysched
+                             , const aria_u128_t   *KeyLeft
+                             , const aria_u128_t   *KeyRight
+                             , size_t               count
+                             , aria_cryto_mode_t    mode
+                             , uint32_t             key_size_in_bits);
+
+/* Make a DECRYPT schedule from an ENCRYPT one, without the master key;
+** enc and dec may be the same schedule
+*/
+aria_error_code_t
+aria_key_schedule_to_decrypt (const aria_key_schedule_t *enc, aria_key_schedule_t *dec);
+
 aria_u128_t 
 aria_crypt (aria_key_schedule_t *ks, aria_u128_t text);
 
+/* Encrypt or decrypt (per ks->mode) count blocks from in[] to out[].
+** Independent blocks are interleaved through the rounds, so this is much 
+** faster than calling aria_crypt() per block. in and out may be the same
+** array (in place), but must not otherwise overlap.
+*/
+aria_error_code_t 
+aria_crypt_blocks (aria_key_schedule_t *ks
+                 , const aria_u128_t *in
+                 , aria_u128_t       *out
+                 , size_t             count);
+
+/* As aria_crypt_blocks(), on len bytes of whole 16-byte blocks in byte order
+** (RFC 5794's test vectors: byte 0 is the most significant byte of left),
+** e.g. straight from a network buffer. in and out need no alignment, and
+** may be the same buffer (in place), but must not otherwise overlap. The
+** SIMD backends load and store the bytes themselves, so there is no copy to
+** or from aria_u128_t on either side.
+*/
+aria_error_code_t
+aria_crypt_bytes (aria_key_schedule_t *ks
+                , const uint8_t      *in
+                , uint8_t            *out
+                , size_t              len);
+
+/* As aria_crypt_blocks(), but block i under its own schedule ks[i], e.g.
+** one block each from many sessions, so that small messages under different
+** keys still fill the SIMD kernels. The schedules may be a mix of ENCRYPT
+** and DECRYPT, but must all be for keys of one size, else KEY_SIZE_BAD.
+*/
+aria_error_code_t
+aria_crypt_blocks_lanes (const aria_key_schedule_t *const *ks
+                       , const aria_u128_t *in
+                       , aria_u128_t       *out
+                       , size_t             count);
+
+/* Overwrite len bytes at p with zeros, in a way the compiler cannot skip,
+** e.g. to wipe a key schedule that is no longer needed
+*/
+void
+aria_wipe (void *p, size_t len);
+
+/* Key schedule cache
+**
+** A bounded, thread safe cache of encrypt and decrypt schedules, keyed by
+** master key and size, with CLOCK (approximately least recently used)
+** replacement. aria_key_cache_get() stores copies of the schedules in *enc
+** and *dec (either may be NULL), computing and caching them on a miss; the
+** copies belong to the caller. Entries are wiped when evicted, and all of
+** them by aria_key_cache_destroy().
+*/
+typedef struct aria_key_cache_s aria_key_cache_t;
+
+typedef struct aria_key_cache_stats_s
+{
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+  uint64_t entries;
+} aria_key_cache_stats_t;
+
+aria_error_code_t
+aria_key_cache_create (aria_key_cache_t **cache, uint32_t capacity);
+
+void
+aria_key_cache_destroy (aria_key_cache_t *cache);
+
+aria_error_code_t
+aria_key_cache_get (aria_key_cache_t    *cache
+                  , aria_u128_t          KeyLeft
+                  , aria_u128_t          KeyRight
+                  , uint32_t             key_size_in_bits
+                  , aria_key_schedule_t *enc
+                  , aria_key_schedule_t *dec);
+
+void
+aria_key_cache_stats (aria_key_cache_t *cache, aria_key_cache_stats_t *stats);
+
+/* Key schedule arena
+**
+** For many long lived schedules, e.g. one per session: capacity schedules
+** in one block of memory, each in its own 64-byte aligned slot of whole
+** cache lines, named by a handle, a 32-bit index from 0 to capacity - 1, so
+** a session table needs only 4 bytes per key. aria_key_arena_alloc() takes
+** a free slot, all zeros; fill it through the aria_key_arena_get() pointer,
+** e.g. with aria_init_key_schedule(). The pointer is valid until the handle
+** is freed. aria_key_arena_free() wipes the slot, and
+** aria_key_arena_destroy() wipes them all.
+**
+** Flags: ARIA_ARENA_HUGEPAGES backs the arena with huge pages where the
+** system has them (Linux), fewer TLB misses across many keys;
+** ARIA_ARENA_MLOCK locks it in memory, so keys are never swapped out, and
+** creation fails with RESOURCE_BAD if that is not allowed. Alloc and free
+** are thread safe; alloc returns RESOURCE_BAD when the arena is full, and
+** free ARG_BAD for a handle that is not allocated.
+*/
+#define ARIA_ARENA_HUGEPAGES 1u
+#define ARIA_ARENA_MLOCK     2u
+
+typedef struct aria_key_arena_s aria_key_arena_t;
+
+typedef uint32_t aria_key_handle_t;
+
+aria_error_code_t
+aria_key_arena_create (aria_key_arena_t **arena, uint32_t capacity, unsigned flags);
+
+void
+aria_key_arena_destroy (aria_key_arena_t *arena);
+
+aria_error_code_t
+aria_key_arena_alloc (aria_key_arena_t *arena, aria_key_handle_t *handle);
+
+aria_error_code_t
+aria_key_arena_free (aria_key_arena_t *arena, aria_key_handle_t handle);
+
+aria_key_schedule_t *
+aria_key_arena_get (aria_key_arena_t *arena, aria_key_handle_t handle);
+
+/* The number of handles allocated */
+uint32_t
+aria_key_arena_live (aria_key_arena_t *arena);
+
+/* CTR mode
+**
+** The counter block starts at iv and is incremented as a 128-bit big-endian
+** integer. aria_ctr_xcrypt() both encrypts and decrypts len bytes from in[]
+** to out[], with an ENCRYPT key schedule. A message may be passed in pieces
+** of any length: ctr carries the counter and unused keystream from one call
+** to the next. in and out may be the same buffer, but must not otherwise
+** overlap.
+*/
+typedef struct aria_ctr_s
+{
+  aria_u128_t counter;    /* the next counter block */
+  uint8_t     stream[16]; /* keystream of the last partial block */
+  uint32_t    used;       /* bytes of stream already used, 16 for none left */
+} aria_ctr_t;
+
+aria_error_code_t
+aria_ctr_init (aria_ctr_t *ctr, aria_u128_t iv);
+
+aria_error_code_t
+aria_ctr_xcrypt (aria_key_schedule_t *ks
+               , aria_ctr_t         *ctr
+               , const uint8_t      *in
+               , uint8_t            *out
+               , size_t              len);
+
+/* ECB and CBC modes
+**
+** len must be a multiple of 16. aria_ecb_crypt() encrypts or decrypts per
+** ks->mode. The CBC functions take an ENCRYPT or a DECRYPT key schedule
+** respectively, and replace *iv with the last ciphertext block, so a long
+** message may be passed in pieces. in and out may be the same buffer, but
+** must not otherwise overlap.
+*/
+aria_error_code_t
+aria_ecb_crypt (aria_key_schedule_t *ks
+              , const uint8_t      *in
+              , uint8_t            *out
+              , size_t              len);
+
+aria_error_code_t
+aria_cbc_encrypt (aria_key_schedule_t *ks
+                , aria_u128_t        *iv
+                , const uint8_t      *in
+                , uint8_t            *out
+                , size_t              len);
+
+aria_error_code_t
+aria_cbc_decrypt (aria_key_schedule_t *ks
+                , aria_u128_t        *iv
+                , const uint8_t      *in
+                , uint8_t            *out
+                , size_t              len);
+
+/* XTS mode (IEEE 1619)
+**
+** For disk encryption: encrypts or decrypts one data unit (sector) of len
+** bytes, at least 16 and not necessarily a multiple of 16, with a partial
+** last block done by ciphertext stealing. ks is the data key schedule,
+** ENCRYPT or DECRYPT respectively; tweak_ks is the ENCRYPT schedule of the
+** second, independent key, and sector is the data unit's number, which the
+** standard encodes as a little-endian 128-bit integer. Each sector is
+** independent, so a request covering several is one call per sector. in and
+** out may be the same buffer, but must not otherwise overlap. The standard
+** caps a data unit at 2^20 blocks, so a len over ARIA_XTS_MAX_LEN is ARG_BAD.
+*/
+#define ARIA_XTS_MAX_LEN (16u << 20)
+
+aria_error_code_t
+aria_xts_encrypt (aria_key_schedule_t *ks
+                , aria_key_schedule_t *tweak_ks
+                , uint64_t             sector
+                , const uint8_t       *in
+                , uint8_t             *out
+                , size_t               len);
+
+aria_error_code_t
+aria_xts_decrypt (aria_key_schedule_t *ks
+                , aria_key_schedule_t *tweak_ks
+                , uint64_t             sector
+                , const uint8_t       *in
+                , uint8_t             *out
+                , size_t               len);
+
+/* CMAC (NIST SP 800-38B)
+**
+** aria_cmac() stores the 16-byte tag of the len bytes at msg in tag[]; a
+** shorter tag is a prefix of it. aria_cmac_batch() does the same for count
+** independent messages, msgs[i] of lens[i] bytes (any lengths, including 0),
+** storing tag i at tags[16 * i]; running many messages' chains side by side
+** through the bulk engine makes it much faster than one aria_cmac() call per
+** message. ks is an ENCRYPT key schedule.
+*/
+aria_error_code_t
+aria_cmac (aria_key_schedule_t *ks, const uint8_t *msg, size_t len, uint8_t tag[16]);
+
+aria_error_code_t
+aria_cmac_batch (aria_key_schedule_t  *ks
+               , const uint8_t *const *msgs
+               , const size_t         *lens
+               , uint8_t              *tags
+               , size_t                count);
+
+/* GCM mode
+**
+** aria_gcm_init() prepares gcm for an ENCRYPT key schedule, which must
+** outlive it. Then per message: aria_gcm_start() with the IV (12 bytes is
+** the usual size), aria_gcm_aad() for the additional data, aria_gcm_encrypt()
+** or aria_gcm_decrypt() for the text, then aria_gcm_finish() for a tag of
+** 4 to 16 bytes, or aria_gcm_check() to compare with a received tag, which
+** returns TAG_BAD on a mismatch. The AAD and text may each be passed in
+** pieces of any length, but all the AAD comes first. Decrypted text must not
+** be used until aria_gcm_check() succeeds. in and out may be the same buffer,
+** but must not otherwise overlap.
+*/
+typedef struct aria_gcm_s
+{
+  aria_key_schedule_t *ks;
+  aria_u128_t          h[8];       /* H^1 .. H^8 */
+  uint64_t             hh[16];     /* i * H for nibbles i, left halves */
+  uint64_t             hl[16];     /* and right halves */
+  aria_u128_t          j0;         /* the pre-counter block */
+  aria_u128_t          counter;    /* the next counter block */
+  aria_u128_t          x;          /* the GHASH accumulator */
+  uint8_t              stream[16]; /* keystream of the last partial block */
+  uint32_t             used;       /* bytes in the pending GHASH block */
+  int                  text;       /* past the AAD */
+  int                  pclmul;     /* GHASH with carry-less multiplication */
+  uint64_t             aad_len;
+  uint64_t             text_len;
+} aria_gcm_t;
+
+aria_error_code_t
+aria_gcm_init (aria_gcm_t *gcm, aria_key_schedule_t *ks);
+
+/* GHASH engines, picked apart from the cipher backend: by default carry-less
+** multiplication (PCLMULQDQ, PMULL) if the CPU has it, else the portable
+** 4-bit tables. aria_set_ghash() overrides the choice for contexts made by
+** later aria_gcm_init() calls, e.g. for A/B runs, and returns BACKEND_BAD
+** for GHASH_CLMUL on a CPU without it. Call it before other threads start
+** using GCM.
+*/
+typedef enum aria_ghash_e
+{
+  GHASH_AUTO = 0,   /* carry-less multiply if the CPU has it */
+  GHASH_TABLE,      /* portable, 4-bit tables of multiples of H */
+  GHASH_CLMUL,      /* x86 PCLMULQDQ or AArch64 PMULL */
+  GHASH_COUNT
+} aria_ghash_t;
+
+aria_error_code_t
+aria_set_ghash (aria_ghash_t ghash);
+
+aria_error_code_t
+aria_gcm_start (aria_gcm_t *gcm, const uint8_t *iv, size_t iv_len);
+
+aria_error_code_t
+aria_gcm_aad (aria_gcm_t *gcm, const uint8_t *aad, size_t len);
+
+aria_error_code_t
+aria_gcm_encrypt (aria_gcm_t *gcm, const uint8_t *in, uint8_t *out, size_t len);
+
+aria_error_code_t
+aria_gcm_decrypt (aria_gcm_t *gcm, const uint8_t *in, uint8_t *out, size_t len);
+
+aria_error_code_t
+aria_gcm_finish (aria_gcm_t *gcm, uint8_t *tag, size_t tag_len);
+
+aria_error_code_t
+aria_gcm_check (aria_gcm_t *gcm, const uint8_t *tag, size_t tag_len);
+
+/* Scatter/gather
+**
+** CTR and GCM over buffers in segments (iovec or mbuf chains), with no
+** need for segments to be whole blocks and no copy into a contiguous
+** buffer: the same as passing the concatenated input and output to the
+** plain functions, which the _iov functions do piece by piece. The input
+** and output may be segmented differently, but must have the same total
+** length, else ARG_BAD. The same arrays may be passed for in and out to
+** work in place; segments must not otherwise overlap. base is not const,
+** as in struct iovec; input segments are only read.
+*/
+typedef struct aria_iovec_s
+{
+  void   *base;
+  size_t  len;
+} aria_iovec_t;
+
+aria_error_code_t
+aria_ctr_xcrypt_iov (aria_key_schedule_t *ks
+                   , aria_ctr_t          *ctr
+                   , const aria_iovec_t  *in
+                   , size_t               in_count
+                   , const aria_iovec_t  *out
+                   , size_t               out_count);
+
+aria_error_code_t
+aria_gcm_aad_iov (aria_gcm_t *gcm, const aria_iovec_t *aad, size_t count);
+
+aria_error_code_t
+aria_gcm_encrypt_iov (aria_gcm_t         *gcm
+                    , const aria_iovec_t *in
+                    , size_t              in_count
+                    , const aria_iovec_t *out
+                    , size_t              out_count);
+
+aria_error_code_t
+aria_gcm_decrypt_iov (aria_gcm_t         *gcm
+                    , const aria_iovec_t *in
+                    , size_t              in_count
+                    , const aria_iovec_t *out
+                    , size_t              out_count);
+
+/* Worker pool
+**
+** Opt in parallel ECB, CTR and CBC decryption of large buffers, split into
+** 64 KB chunks over a persistent pool of threads. threads counts the calling
+** thread, which works too; 0 means one per online CPU. With pin, the workers
+** are bound to CPUs 1, 2, ... in turn, leaving CPU 0 to the caller (Linux
+** only). The functions have the same results and
+** rules as their single threaded versions, and run one job at a time per
+** pool; they may be called from any thread. RESOURCE_BAD means threads or
+** memory could not be had.
+*/
+typedef struct aria_pool_s aria_pool_t;
+
+aria_error_code_t
+aria_pool_create (aria_pool_t **pool, unsigned threads, int pin);
+
+void
+aria_pool_destroy (aria_pool_t *pool);
+
+unsigned
+aria_pool_threads (const aria_pool_t *pool);
+
+aria_error_code_t
+aria_pool_ecb_crypt (aria_pool_t         *pool
+                   , aria_key_schedule_t *ks
+                   , const uint8_t       *in
+                   , uint8_t             *out
+                   , size_t               len);
+
+aria_error_code_t
+aria_pool_ctr_xcrypt (aria_pool_t         *pool
+                    , aria_key_schedule_t *ks
+                    , aria_ctr_t          *ctr
+                    , const uint8_t       *in
+                    , uint8_t             *out
+                    , size_t               len);
+
+aria_error_code_t
+aria_pool_cbc_decrypt (aria_pool_t         *pool
+                     , aria_key_schedule_t *ks
+                     , aria_u128_t         *iv
+                     , const uint8_t       *in
+                     , uint8_t             *out
+                     , size_t               len);
+
+/* Job queue
+**
+** For many small messages under different keys, e.g. the requests of one
+** event loop tick. Submit jobs with aria_queue_submit(); aria_queue_flush()
+** runs every job submitted so far, and aria_queue_poll() then hands back up
+** to max finished jobs, in the order submitted, with their status set.
+** Blocks of small jobs go through aria_crypt_blocks_lanes() together, any
+** mix of keys in one pass, so the SIMD kernels run full where one call per
+** message would not; large jobs go whole through the mode functions. Given
+** a pool, a flush spreads the work over its threads, else it runs on the
+** calling thread.
+**
+** A JOB_ECB job encrypts or decrypts per ks->mode, len a multiple of 16; a
+** JOB_CTR job, with an ENCRYPT schedule, XORs len bytes with the keystream
+** from counter block iv, as aria_ctr_xcrypt() on a fresh aria_ctr_t. Each
+** job's in and out may be the same buffer, but must not otherwise overlap,
+** nor overlap another job's out. A job, its schedule and buffers must stay
+** put from submit until poll returns it. submit returns KEY_SIZE_BAD for a
+** schedule that is not of 12, 14 or 16 rounds, and RESOURCE_BAD when
+** capacity jobs are submitted and not yet polled. A queue is used by one
+** thread at a time; queues may share a pool.
+*/
+typedef enum aria_job_op_e
+{
+  JOB_ECB,
+  JOB_CTR
+} aria_job_op_t;
+
+typedef struct aria_job_s
+{
+  aria_key_schedule_t *ks;
+  aria_job_op_t        op;
+  aria_u128_t          iv;     /* JOB_CTR: the first counter block */
+  const uint8_t       *in;
+  uint8_t             *out;
+  size_t               len;
+  void                *user;   /* the caller's, untouched */
+  aria_error_code_t    status; /* once done */
+} aria_job_t;
+
+typedef struct aria_queue_s aria_queue_t;
+
+aria_error_code_t
+aria_queue_create (aria_queue_t **queue, aria_pool_t *pool, uint32_t capacity);
+
+void
+aria_queue_destroy (aria_queue_t *queue);
+
+aria_error_code_t
+aria_queue_submit (aria_queue_t *queue, aria_job_t *job);
+
+aria_error_code_t
+aria_queue_flush (aria_queue_t *queue);
+
+size_t
+aria_queue_poll (aria_queue_t *queue, aria_job_t **done, size_t max);
+
+/* The backend is picked on first use of aria_crypt() or aria_crypt_blocks():
+** the one named by the environment variable ARIA_BACKEND ("reference",
+** "ttable", "ssse3", "avx2", "aesni", "gfni", "bitslice", "neon" or
+** "neonaes") if the CPU supports it, else the fastest one it supports; AUTO
+** never picks bitslice, which is for callers who need constant time more
+** than speed. Only its encryption and decryption are constant time: key
+** setup, aria_init_key_schedule(), aria_init_key_schedules_batch() and the
+** key cache, runs on S-box tables indexed by the key whatever the backend,
+** so a caller that must hide the key from cache timing has to set up its
+** schedules where that is not observable. aria_set_backend() overrides the
+** choice, and returns BACKEND_BAD for a backend the CPU or the build lacks;
+** BACKEND_AUTO goes back to the original choice. All backends give
+** identical results.
+** Call it before other threads start using the cipher.
+*/
+aria_error_code_t
+aria_set_backend (aria_backend_t backend);
+
+/* The backend in use, never BACKEND_AUTO */
+aria_backend_t
+aria_get_backend (void);
+
+/* 1 if aria_set_backend(backend) would succeed, else 0 */
+int
+aria_backend_supported (aria_backend_t backend);
+
+/* Short lowercase name of backend, as for ARIA_BACKEND; NULL if out of range */
+const char *
+aria_backend_name (aria_backend_t backend);
+
+/* Usage counters
+**
+** Built with ARIA_STATS=1, each thread counts its calls into the library;
+** otherwise there is no counting, and no cost. aria_stats_snapshot() sums
+** every thread's counts, including threads that have exited, and reports
+** the backend in use; while other threads are running the sum is only
+** approximate. Each mode counts the bytes passed to it, and the blocks its
+** bulk calls process also count in blocks. Built also with ARIA_STATS_PERF
+** (Linux), every bulk call is bracketed by perf_event counters, at the cost
+** of a system call at each end; perf is 0 if they could not be opened, e.g.
+** for lack of permission.
+*/
+typedef struct aria_stats_s
+{
+  int            enabled;        /* built with ARIA_STATS */
+  int            perf;           /* perf_event counters are running */
+  aria_backend_t backend;
+  uint64_t       crypt_calls;    /* aria_crypt() */
+  uint64_t       bulk_calls;     /* aria_crypt_blocks(), aria_crypt_bytes() */
+  uint64_t       blocks;         /* by either */
+  uint64_t       key_inits;      /* key schedules computed, one per key in a batch */
+  uint64_t       key_to_decrypt; /* aria_key_schedule_to_decrypt() */
+  uint64_t       ecb_bytes;
+  uint64_t       cbc_bytes;      /* encrypted and decrypted */
+  uint64_t       ctr_bytes;
+  uint64_t       xts_bytes;      /* encrypted and decrypted */
+  uint64_t       cmac_bytes;
+  uint64_t       gcm_bytes;      /* text, encrypted and decrypted */
+  uint64_t       gcm_aad_bytes;
+  uint64_t       cache_hits;     /* aria_key_cache_get() */
+  uint64_t       cache_misses;
+  uint64_t       cycles;         /* over bulk calls, with ARIA_STATS_PERF */
+  uint64_t       instructions;
+  uint64_t       l1d_misses;
+} aria_stats_t;
+
+aria_error_code_t
+aria_stats_snapshot (aria_stats_t *stats);
+
+/* Zero every thread's counters */
+void
+aria_stats_reset (void);
+
 #ifdef __cplusplus
 }
 #endif
+
+#endif /* ARIA_H */
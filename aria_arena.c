@@ -0,0 +1,239 @@
+/* aria_arena.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* Key schedule arena
+**
+** One allocation of capacity fixed size slots, each a key schedule rounded
+** up to whole 64-byte cache lines, so no schedule shares a line with another
+** or straddles one more than it must. A free list of slot indexes, linked
+** through a separate array, makes allocation and release constant time; a
+** live slot is marked in that array, which catches double frees. The slots
+** themselves are not touched by the arena except to wipe them, and the
+** address of slot h is base + h * stride, so aria_key_arena_get() needs no
+** lock.
+**
+** With ARIA_ARENA_HUGEPAGES (Linux) the slots are mapped from 2 MB pages if
+** the system has them reserved, and otherwise marked for transparent huge
+** pages; 100k 256-bit schedules then take 16 TLB entries instead of 8000.
+** With ARIA_ARENA_MLOCK the whole arena is locked in memory, so schedules
+** are never written to swap; failing that, creation fails.
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for MAP_ANONYMOUS, MAP_HUGETLB and madvise */
+#elif !defined(__APPLE__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L /* for posix_memalign */
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "aria.h"
+
+#define ARIA_ARENA_NONE  0xffffffffu  /* end of the free list */
+#define ARIA_ARENA_USED  0xfffffffeu  /* in next[], for a live slot */
+#define ARIA_ARENA_HUGE  (2u << 20)
+#define ARIA_ARENA_SLOT  ((sizeof(aria_key_schedule_t) + 63u) & ~(size_t )63u)
+
+struct aria_key_arena_s
+{
+  pthread_mutex_t lock;
+  uint8_t        *base;
+  size_t          bytes;     /* of the allocation at base */
+  uint32_t        capacity;
+  uint32_t        free;      /* the first free slot, or ARIA_ARENA_NONE */
+  uint32_t        live;
+  int             mapped;    /* by mmap(), else posix_memalign() */
+  int             locked;
+  uint32_t       *next;      /* the next free slot, or ARIA_ARENA_USED */
+};
+
+static int
+aria_key_arena_map (aria_key_arena_t *a, size_t bytes)
+{
+#if defined(__linux__)
+  size_t huge = (bytes + ARIA_ARENA_HUGE - 1u) & ~(size_t )(ARIA_ARENA_HUGE - 1u);
+  void  *p = mmap(NULL, huge, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+  if (MAP_FAILED == p)
+  {
+    p = mmap(NULL, huge, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == p)
+    {
+      return 0;
+    }
+#if defined(MADV_HUGEPAGE)
+    (void)madvise(p, huge, MADV_HUGEPAGE);
+#endif
+  }
+  a->base   = p;
+  a->bytes  = huge;
+  a->mapped = 1;
+  return 1;
+#else
+  (void)a;
+  (void)bytes;
+  return 0;
+#endif
+}
+
+aria_error_code_t
+aria_key_arena_create (aria_key_arena_t **arena, uint32_t capacity, unsigned flags)
+{
+  if ((NULL == arena) || (0u == capacity) || (capacity > (1u << 24)))
+  {
+    return ARG_BAD;
+  }
+  *arena = NULL;
+
+  aria_key_arena_t *a = calloc(1u, sizeof(aria_key_arena_t));
+  size_t bytes = (size_t )capacity * ARIA_ARENA_SLOT;
+
+  if (NULL != a)
+  {
+    a->next = malloc(capacity * sizeof(uint32_t));
+    if ((0u == (flags & ARIA_ARENA_HUGEPAGES)) || !aria_key_arena_map(a, bytes))
+    {
+      void *p = NULL;
+
+      bytes = (bytes + 4095u) & ~(size_t )4095u;
+      if (0 == posix_memalign(&p, 4096u, bytes))
+      {
+        memset(p, 0, bytes);
+        a->base  = p;
+        a->bytes = bytes;
+      }
+    }
+  }
+  if ((NULL == a) || (NULL == a->next) || (NULL == a->base))
+  {
+    aria_key_arena_destroy(a);
+    return RESOURCE_BAD;
+  }
+  if (0u != (flags & ARIA_ARENA_MLOCK))
+  {
+    if (0 != mlock(a->base, a->bytes))
+    {
+      aria_key_arena_destroy(a);
+      return RESOURCE_BAD;
+    }
+    a->locked = 1;
+  }
+  for (uint32_t i = 0u; i < capacity; i++)
+  {
+    a->next[i] = (i + 1u < capacity) ? (i + 1u) : ARIA_ARENA_NONE;
+  }
+  a->capacity = capacity;
+  a->free     = 0u;
+  (void)pthread_mutex_init(&a->lock, NULL);
+  *arena = a;
+  return NO_ERROR;
+}
+
+void
+aria_key_arena_destroy (aria_key_arena_t *arena)
+{
+  if (NULL == arena)
+  {
+    return;
+  }
+  if (NULL != arena->base)
+  {
+    aria_wipe(arena->base, arena->bytes);
+    if (arena->locked)
+    {
+      (void)munlock(arena->base, arena->bytes);
+    }
+    if (arena->mapped)
+    {
+      (void)munmap(arena->base, arena->bytes);
+    }
+    else
+    {
+      free(arena->base);
+    }
+  }
+  if (0u != arena->capacity)
+  {
+    (void)pthread_mutex_destroy(&arena->lock);
+  }
+  free(arena->next);
+  free(arena);
+}
+
+aria_error_code_t
+aria_key_arena_alloc (aria_key_arena_t *arena, aria_key_handle_t *handle)
+{
+  if ((NULL == arena) || (NULL == handle))
+  {
+    return ARG_BAD;
+  }
+  (void)pthread_mutex_lock(&arena->lock);
+
+  uint32_t h = arena->free;
+
+  if (ARIA_ARENA_NONE != h)
+  {
+    arena->free    = arena->next[h];
+    arena->next[h] = ARIA_ARENA_USED;
+    arena->live++;
+  }
+  (void)pthread_mutex_unlock(&arena->lock);
+  if (ARIA_ARENA_NONE == h)
+  {
+    return RESOURCE_BAD;
+  }
+  *handle = h;
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_key_arena_free (aria_key_arena_t *arena, aria_key_handle_t handle)
+{
+  aria_error_code_t err = ARG_BAD;
+
+  if ((NULL == arena) || (handle >= arena->capacity))
+  {
+    return ARG_BAD;
+  }
+  (void)pthread_mutex_lock(&arena->lock);
+  if (ARIA_ARENA_USED == arena->next[handle])
+  {
+    aria_wipe(&arena->base[(size_t )handle * ARIA_ARENA_SLOT], ARIA_ARENA_SLOT);
+    arena->next[handle] = arena->free;
+    arena->free = handle;
+    arena->live--;
+    err = NO_ERROR;
+  }
+  (void)pthread_mutex_unlock(&arena->lock);
+  return err;
+}
+
+aria_key_schedule_t *
+aria_key_arena_get (aria_key_arena_t *arena, aria_key_handle_t handle)
+{
+  if ((NULL == arena) || (handle >= arena->capacity))
+  {
+    return NULL;
+  }
+  return (aria_key_schedule_t *)(void *)&arena->base[(size_t )handle * ARIA_ARENA_SLOT];
+}
+
+uint32_t
+aria_key_arena_live (aria_key_arena_t *arena)
+{
+  uint32_t live = 0u;
+
+  if (NULL != arena)
+  {
+    (void)pthread_mutex_lock(&arena->lock);
+    live = arena->live;
+    (void)pthread_mutex_unlock(&arena->lock);
+  }
+  return live;
+}
@@ -0,0 +1,238 @@
+/* aria_arm.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* AArch64 SIMD kernels for ARIA
+**
+** The same byte-sliced kernel body as aria_x86.c, with tbl in place of
+** pshufb: NEON is part of every AArch64 CPU, so the vperm kernel needs no
+** feature test. The kernel that uses the ARMv8 Cryptography Extensions, and
+** GHASH with PMULL, are compiled with a target attribute, so the rest of the
+** library builds for the baseline instruction set, and aria.c only calls
+** them after checking that the CPU supports them.
+*/
+
+#include "aria_arm.h"
+
+#if ARIA_ARM64
+
+#include <arm_neon.h>
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#include "aria_vperm.h"
+
+#if defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO)
+#define ARIA_ARM_CRYPTO 1
+#define ARIA_ARM_CRYPTO_TARGET
+#elif defined(__clang__)
+#define ARIA_ARM_CRYPTO 0
+#define ARIA_ARM_CRYPTO_TARGET __attribute__((target("aes")))
+#else
+#define ARIA_ARM_CRYPTO 0
+#define ARIA_ARM_CRYPTO_TARGET __attribute__((target("+crypto")))
+#endif
+
+/* AT_HWCAP bits, as in the kernel's asm/hwcap.h */
+#define ARIA_ARM_HWCAP_AES   (1u << 3)
+#define ARIA_ARM_HWCAP_PMULL (1u << 4)
+
+static int
+aria_arm_hwcap (unsigned long bit)
+{
+#if defined(__linux__)
+  return (0u != (getauxval(AT_HWCAP) & bit)) ? 1 : 0;
+#elif defined(__APPLE__)
+  (void)bit;
+  return 1; /* every Apple AArch64 CPU has them */
+#else
+  (void)bit;
+  return ARIA_ARM_CRYPTO;
+#endif
+}
+
+int aria_arm_has_aes (void)
+{
+  return aria_arm_hwcap(ARIA_ARM_HWCAP_AES);
+}
+
+int aria_arm_has_pmull (void)
+{
+  return aria_arm_hwcap(ARIA_ARM_HWCAP_PMULL);
+}
+
+/* 128-bit vectors, 16 blocks per pass; tbl gives 0 for any index past 15,
+** which covers the 0x80 entries of the vperm tables
+*/
+
+#define ARIA_BS_BLOCKS   16u
+#define BS_V             uint8x16_t
+#define BS_XOR(a, b)     veorq_u8((a), (b))
+#define BS_AND(a, b)     vandq_u8((a), (b))
+#define BS_ANDNOT(a, b)  vbicq_u8((b), (a))
+#define BS_SHUF(t, x)    vqtbl1q_u8((t), (x))
+#define BS_SRL4(x)       vshrq_n_u8((x), 4)
+#define BS_SET1(c)       vdupq_n_u8((uint8_t )(c))
+#define BS_TAB(p)        vld1q_u8(p)
+#define BS_UNPACKLO8     vzip1q_u8
+#define BS_UNPACKHI8     vzip2q_u8
+#define BS_LOAD(p, m)    vld1q_u8(&(p)[16 * (m)])
+#define BS_STORE(p, m, v) vst1q_u8(&(p)[16 * (m)], (v))
+#define BS_KEY(rk)       vld1q_u8((const uint8_t *)(rk))
+
+/* NEON */
+
+#define ARIA_BS_NAME(x)  aria_arm_neon_##x
+#define ARIA_BS_TARGET
+
+#include "aria_byteslice.h"
+
+#undef ARIA_BS_NAME
+#undef ARIA_BS_TARGET
+
+/* ARMv8 AES
+**
+** As with AES-NI: aese and aesd with a zero round key are SubBytes and
+** InvSubBytes of the permuted input, so the tables that cancel the x86
+** instructions' ShiftRows and InvShiftRows serve here too, as do the affine
+** maps for SB2 and SB4.
+*/
+
+static inline ARIA_ARM_CRYPTO_TARGET uint8x16_t
+aria_arm_aes_affine (uint8x16_t x, const uint8_t *lo, const uint8_t *hi)
+{
+  const uint8x16_t m0f = vdupq_n_u8(0x0f);
+
+  return veorq_u8(vqtbl1q_u8(vld1q_u8(lo), vandq_u8(m0f, x)), vqtbl1q_u8(vld1q_u8(hi), vshrq_n_u8(x, 4)));
+}
+
+#define AES_SB1(x) vaeseq_u8(vqtbl1q_u8((x), vld1q_u8(AES_ISR)), vdupq_n_u8(0))
+#define AES_SB3(x) vaesdq_u8(vqtbl1q_u8((x), vld1q_u8(AES_SR)), vdupq_n_u8(0))
+
+#define BS_SB1(x) AES_SB1(x)
+#define BS_SB2(x) aria_arm_aes_affine(AES_SB1(x), AES_M2_LO, AES_M2_HI)
+#define BS_SB3(x) AES_SB3(x)
+#define BS_SB4(x) AES_SB3(aria_arm_aes_affine((x), AES_M4_LO, AES_M4_HI))
+
+#define ARIA_BS_NAME(x)  aria_arm_aes_##x
+#define ARIA_BS_TARGET   ARIA_ARM_CRYPTO_TARGET
+
+#include "aria_byteslice.h"
+
+#undef ARIA_BS_NAME
+#undef ARIA_BS_TARGET
+
+#undef ARIA_BS_BLOCKS
+#undef BS_V
+#undef BS_XOR
+#undef BS_AND
+#undef BS_ANDNOT
+#undef BS_SHUF
+#undef BS_SRL4
+#undef BS_SET1
+#undef BS_TAB
+#undef BS_UNPACKLO8
+#undef BS_UNPACKHI8
+#undef BS_LOAD
+#undef BS_STORE
+#undef BS_KEY
+
+/* GHASH with PMULL
+**
+** aria_x86_pclmul_ghash(), step for step: the same bit reflected products,
+** shift and reduction, with vext standing in for the whole-register byte
+** shifts.
+*/
+
+#define ARIA_GH_SLLB(x, n)  vreinterpretq_u64_u8(vextq_u8(vdupq_n_u8(0), vreinterpretq_u8_u64(x), 16 - (n)))
+#define ARIA_GH_SRLB(x, n)  vreinterpretq_u64_u8(vextq_u8(vreinterpretq_u8_u64(x), vdupq_n_u8(0), (n)))
+#define ARIA_GH_SLL32(x, n) vreinterpretq_u64_u32(vshlq_n_u32(vreinterpretq_u32_u64(x), (n)))
+#define ARIA_GH_SRL32(x, n) vreinterpretq_u64_u32(vshrq_n_u32(vreinterpretq_u32_u64(x), (n)))
+
+static inline ARIA_ARM_CRYPTO_TARGET uint64x2_t
+aria_arm_ghash_load (const aria_u128_t *p)
+{
+  return vcombine_u64(vcreate_u64(p->right), vcreate_u64(p->left));
+}
+
+/* Accumulate the unreduced product a * b into lo, mid, hi */
+
+static inline ARIA_ARM_CRYPTO_TARGET void
+aria_arm_ghash_mul (uint64x2_t a, uint64x2_t b, uint64x2_t *lo, uint64x2_t *mid, uint64x2_t *hi)
+{
+  uint64x2_t p00 = vreinterpretq_u64_p128(vmull_p64((poly64_t )vgetq_lane_u64(a, 0), (poly64_t )vgetq_lane_u64(b, 0)));
+  uint64x2_t p11 = vreinterpretq_u64_p128(vmull_high_p64(vreinterpretq_p64_u64(a), vreinterpretq_p64_u64(b)));
+  uint64x2_t p10 = vreinterpretq_u64_p128(vmull_p64((poly64_t )vgetq_lane_u64(a, 1), (poly64_t )vgetq_lane_u64(b, 0)));
+  uint64x2_t p01 = vreinterpretq_u64_p128(vmull_p64((poly64_t )vgetq_lane_u64(a, 0), (poly64_t )vgetq_lane_u64(b, 1)));
+
+  *lo  = veorq_u64(*lo, p00);
+  *hi  = veorq_u64(*hi, p11);
+  *mid = veorq_u64(*mid, veorq_u64(p10, p01));
+}
+
+static inline ARIA_ARM_CRYPTO_TARGET uint64x2_t
+aria_arm_ghash_reduce (uint64x2_t lo, uint64x2_t mid, uint64x2_t hi)
+{
+  lo = veorq_u64(lo, ARIA_GH_SLLB(mid, 8));
+  hi = veorq_u64(hi, ARIA_GH_SRLB(mid, 8));
+
+  /* shift hi:lo left by one bit */
+  uint64x2_t clo = ARIA_GH_SRL32(lo, 31);
+  uint64x2_t chi = ARIA_GH_SRL32(hi, 31);
+  lo  = ARIA_GH_SLL32(lo, 1);
+  hi  = ARIA_GH_SLL32(hi, 1);
+  hi  = vorrq_u64(hi, ARIA_GH_SRLB(clo, 12));
+  hi  = vorrq_u64(hi, ARIA_GH_SLLB(chi, 4));
+  lo  = vorrq_u64(lo, ARIA_GH_SLLB(clo, 4));
+
+  /* reduce */
+  uint64x2_t a = veorq_u64(veorq_u64(ARIA_GH_SLL32(lo, 31), ARIA_GH_SLL32(lo, 30)), ARIA_GH_SLL32(lo, 25));
+  uint64x2_t b = ARIA_GH_SRLB(a, 4);
+  lo = veorq_u64(lo, ARIA_GH_SLLB(a, 12));
+  a  = veorq_u64(veorq_u64(ARIA_GH_SRL32(lo, 1), ARIA_GH_SRL32(lo, 2)), ARIA_GH_SRL32(lo, 7));
+  return veorq_u64(hi, veorq_u64(lo, veorq_u64(a, b)));
+}
+
+void ARIA_ARM_CRYPTO_TARGET
+aria_arm_pmull_ghash (aria_u128_t *x, const aria_u128_t h[8], const aria_u128_t *blocks, size_t count)
+{
+  uint64x2_t y = aria_arm_ghash_load(x);
+
+  for (; count >= 8u; count -= 8u)
+  {
+    uint64x2_t lo  = vdupq_n_u64(0u);
+    uint64x2_t mid = vdupq_n_u64(0u);
+    uint64x2_t hi  = vdupq_n_u64(0u);
+
+    aria_arm_ghash_mul(veorq_u64(y, aria_arm_ghash_load(&blocks[0])), aria_arm_ghash_load(&h[7]), &lo, &mid, &hi);
+    for (int j = 1; j < 8; j++)
+    {
+      aria_arm_ghash_mul(aria_arm_ghash_load(&blocks[j]), aria_arm_ghash_load(&h[7 - j]), &lo, &mid, &hi);
+    }
+    y = aria_arm_ghash_reduce(lo, mid, hi);
+    blocks += 8;
+  }
+  for (; count > 0u; count--)
+  {
+    uint64x2_t lo  = vdupq_n_u64(0u);
+    uint64x2_t mid = vdupq_n_u64(0u);
+    uint64x2_t hi  = vdupq_n_u64(0u);
+
+    aria_arm_ghash_mul(veorq_u64(y, aria_arm_ghash_load(blocks++)), aria_arm_ghash_load(&h[0]), &lo, &mid, &hi);
+    y = aria_arm_ghash_reduce(lo, mid, hi);
+  }
+  x->left  = vgetq_lane_u64(y, 1);
+  x->right = vgetq_lane_u64(y, 0);
+}
+
+#undef ARIA_GH_SLLB
+#undef ARIA_GH_SRLB
+#undef ARIA_GH_SLL32
+#undef ARIA_GH_SRL32
+
+#endif /* ARIA_ARM64 */
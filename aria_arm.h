@@ -0,0 +1,80 @@
+/* aria_arm.h
+**
+** Internal interface between aria.c and the AArch64 SIMD kernels in aria_arm.c
+*/
+
+#ifndef ARIA_ARM_H
+#define ARIA_ARM_H
+
+#include "aria.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The byte-sliced layout assumes aria_u128_t is stored little-endian */
+#if defined(__aarch64__) && defined(__GNUC__) && defined(__ARM_NEON) \
+    && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) && !defined(ARIA_NO_SIMD)
+#define ARIA_ARM64 1
+#else
+#define ARIA_ARM64 0
+#endif
+
+#if ARIA_ARM64
+
+/* CPU feature tests, all return 0 or 1; NEON itself is baseline AArch64 */
+int aria_arm_has_aes (void);
+int aria_arm_has_pmull (void);
+
+/* The kernels process as many whole groups of 16 blocks as fit in count, and
+** return the number of blocks done; the caller handles the rest. in and out
+** may be the same array.
+*/
+size_t aria_arm_neon_crypt_blocks (const aria_key_schedule_t *ks
+                                 , const aria_u128_t *in
+                                 , aria_u128_t       *out
+                                 , size_t             count);
+
+size_t aria_arm_aes_crypt_blocks (const aria_key_schedule_t *ks
+                                , const aria_u128_t *in
+                                , aria_u128_t       *out
+                                , size_t             count);
+
+/* The same kernels on count blocks at in and out in byte order (see
+** aria_crypt_bytes()), with no alignment needed
+*/
+size_t aria_arm_neon_crypt_bytes (const aria_key_schedule_t *ks
+                                , const uint8_t *in
+                                , uint8_t       *out
+                                , size_t         count);
+
+size_t aria_arm_aes_crypt_bytes (const aria_key_schedule_t *ks
+                               , const uint8_t *in
+                               , uint8_t       *out
+                               , size_t         count);
+
+/* The same kernels with a key schedule per block: block i under ks[i], all
+** of them with the same round count
+*/
+size_t aria_arm_neon_crypt_lanes (const aria_key_schedule_t *const *ks
+                                , const aria_u128_t *in
+                                , aria_u128_t       *out
+                                , size_t             count);
+
+size_t aria_arm_aes_crypt_lanes (const aria_key_schedule_t *const *ks
+                               , const aria_u128_t *in
+                               , aria_u128_t       *out
+                               , size_t             count);
+
+/* GHASH: for each block, x = (x ^ block) * H, with h[i] = H^(i+1) */
+void aria_arm_pmull_ghash (aria_u128_t *x, const aria_u128_t h[8], const aria_u128_t *blocks, size_t count);
+
+#endif /* ARIA_ARM64 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARIA_ARM_H */
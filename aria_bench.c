@@ -0,0 +1,788 @@
+/* aria_bench.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* ariabench: per operation timings for tracking performance
+**
+**   ariabench [-f text|csv|json] [-b backends] [-k key sizes] [-j threads]
+**             [-s min,max] [-r reps] [-w warmup] [-t sample ms] [-c]
+**
+** Each operation is timed separately: key setup (encrypt and decrypt
+** schedules), one block through aria_crypt() as a dependent chain, and ECB,
+** CTR, XTS (one sector) and GCM (start, encrypt, finish: one message) over
+** 16 bytes to 16 MB in steps of 4x; per key size, per backend, and (ECB and
+** CTR, through a worker pool) per thread count. Lists are comma separated; the default is
+** every supported backend, all three key sizes, one thread plus one per
+** CPU, and 16,16M bytes.
+**
+** A sample repeats the operation enough times to take the sample time
+** (2 ms by default), after warmup samples that are thrown away; each result
+** is the median, 10th and 90th percentile and minimum over reps samples, of
+** the time per operation. Data is made before timing starts, so nothing but
+** the operation is timed. Cycles are from timer_e_cycles(), less the cost
+** of reading them: on x86 TSC cycles, the CPU's fixed reference clock
+** rather than its core clock, elsewhere nanoseconds. For key setup, which
+** has no bytes, cycles per byte is cycles per key.
+**
+** Besides the backends, the engine list can name oryx: the 32-bit word
+** implementation in oryx/oryx_aria.c, timed on the same data for key setup,
+** one block, and ECB as a loop over its block call. Before timing, every
+** engine listed is checked against the RFC 5794 vectors and against the
+** reference backend on the same random keys and data, each key size, both
+** directions, through both one block and bulk calls; a mismatch is reported
+** and ariabench exits 1 without timing anything. -c stops after the check.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "aria.h"
+#include "aria_block.h"
+#include "oryx/oryx_aria.h"
+#include "timer_e.h"
+#include "xorshift_e.h"
+
+#define ARIA_BENCH_MAX_BYTES (16u << 20)
+#define ARIA_BENCH_MAX_REPS  101u
+#define ARIA_BENCH_MAX_LIST  16u
+
+/* oryx/oryx_aria.c, in a list of backends */
+#define ARIA_BENCH_ORYX ((aria_backend_t )BACKEND_COUNT)
+
+typedef enum aria_bench_format_e
+{
+  FORMAT_TEXT,
+  FORMAT_CSV,
+  FORMAT_JSON
+} aria_bench_format_t;
+
+typedef struct aria_bench_s
+{
+  aria_key_schedule_t ks;
+  aria_gcm_t          gcm;
+  AriaContext         oryx;
+  aria_pool_t        *pool;       /* NULL for one thread */
+  aria_u128_t         key[2];
+  uint32_t            bits;
+  size_t              bytes;
+  uint8_t            *in;
+  uint8_t            *out;
+  aria_u128_t         block;
+} aria_bench_t;
+
+typedef void (*aria_bench_op_t) (aria_bench_t *b, size_t iterations);
+
+typedef struct aria_bench_result_s
+{
+  const char *op;
+  const char *backend;
+  uint32_t    bits;
+  unsigned    threads;
+  size_t      bytes;
+  size_t      iterations;  /* per sample */
+  double      ns[4];       /* per operation: median, p10, p90, min */
+  double      cycles;      /* per operation, median */
+} aria_bench_result_t;
+
+/* The operations */
+
+static void
+aria_bench_key_enc (aria_bench_t *b, size_t iterations)
+{
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    b->key[0].right += 1u;
+    (void)aria_init_key_schedule(&b->ks, b->key[0], b->key[1], ENCRYPT, b->bits);
+  }
+}
+
+static void
+aria_bench_key_dec (aria_bench_t *b, size_t iterations)
+{
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    b->key[0].right += 1u;
+    (void)aria_init_key_schedule(&b->ks, b->key[0], b->key[1], DECRYPT, b->bits);
+  }
+}
+
+static void
+aria_bench_block (aria_bench_t *b, size_t iterations)
+{
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    b->block = aria_crypt(&b->ks, b->block);
+  }
+}
+
+static void
+aria_bench_ecb (aria_bench_t *b, size_t iterations)
+{
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    if (NULL != b->pool)
+    {
+      (void)aria_pool_ecb_crypt(b->pool, &b->ks, b->in, b->out, b->bytes);
+    }
+    else
+    {
+      (void)aria_ecb_crypt(&b->ks, b->in, b->out, b->bytes);
+    }
+  }
+}
+
+static void
+aria_bench_ctr (aria_bench_t *b, size_t iterations)
+{
+  aria_ctr_t ctr;
+
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    (void)aria_ctr_init(&ctr, b->block);
+    if (NULL != b->pool)
+    {
+      (void)aria_pool_ctr_xcrypt(b->pool, &b->ks, &ctr, b->in, b->out, b->bytes);
+    }
+    else
+    {
+      (void)aria_ctr_xcrypt(&b->ks, &ctr, b->in, b->out, b->bytes);
+    }
+  }
+}
+
+/* One sector of b->bytes, with the data key standing in for the tweak key */
+static void
+aria_bench_xts (aria_bench_t *b, size_t iterations)
+{
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    (void)aria_xts_encrypt(&b->ks, &b->ks, (uint64_t )i, b->in, b->out, b->bytes);
+  }
+}
+
+static void
+aria_bench_gcm (aria_bench_t *b, size_t iterations)
+{
+  uint8_t tag[16];
+
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    (void)aria_gcm_start(&b->gcm, b->in, 12u);
+    (void)aria_gcm_encrypt(&b->gcm, b->in, b->out, b->bytes);
+    (void)aria_gcm_finish(&b->gcm, tag, 16u);
+  }
+}
+
+/* The oryx operations: ariaInit() makes both schedules, so its key setup
+** compares with key_dec
+*/
+
+static void
+aria_bench_oryx_init (AriaContext *c, aria_u128_t left, aria_u128_t right, uint32_t bits)
+{
+  uint8_t key[32];
+
+  aria_store_block(key, left);
+  aria_store_block(&key[16], right);
+  (void)ariaInit(c, key, bits / 8u);
+}
+
+static void
+aria_bench_oryx_key (aria_bench_t *b, size_t iterations)
+{
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    b->key[0].right += 1u;
+    aria_bench_oryx_init(&b->oryx, b->key[0], b->key[1], b->bits);
+  }
+}
+
+static void
+aria_bench_oryx_block (aria_bench_t *b, size_t iterations)
+{
+  uint8_t block[16];
+
+  aria_store_block(block, b->block);
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    ariaEncryptBlock(&b->oryx, block, block);
+  }
+  b->block = aria_load_block(block);
+}
+
+static void
+aria_bench_oryx_ecb (aria_bench_t *b, size_t iterations)
+{
+  for (size_t i = 0u; i < iterations; i++)
+  {
+    for (size_t j = 0u; j < b->bytes; j += 16u)
+    {
+      ariaEncryptBlock(&b->oryx, &b->in[j], &b->out[j]);
+    }
+  }
+}
+
+/* Cross checks */
+
+static const char *
+aria_bench_engine_name (aria_backend_t e)
+{
+  return (ARIA_BENCH_ORYX == e) ? "oryx" : aria_backend_name(e);
+}
+
+/* ECB in one engine; the aria engines also take each block through
+** aria_crypt(), and give 1 if that disagrees with the bulk call
+*/
+static int
+aria_bench_engine_ecb (aria_backend_t e
+                     , const uint8_t *key
+                     , uint32_t       bits
+                     , int            decrypt
+                     , const uint8_t *in
+                     , uint8_t       *out
+                     , size_t         len)
+{
+  int bad = 0;
+
+  if (ARIA_BENCH_ORYX == e)
+  {
+    AriaContext c;
+
+    (void)ariaInit(&c, key, bits / 8u);
+    for (size_t j = 0u; j < len; j += 16u)
+    {
+      if (decrypt)
+      {
+        ariaDecryptBlock(&c, &in[j], &out[j]);
+      }
+      else
+      {
+        ariaEncryptBlock(&c, &in[j], &out[j]);
+      }
+    }
+    aria_wipe(&c, sizeof(c));
+  }
+  else
+  {
+    aria_key_schedule_t ks;
+    aria_u128_t right = (bits > 128u) ? aria_load_block(&key[16]) : (aria_u128_t ){ 0u, 0u };
+
+    (void)aria_set_backend(e);
+    (void)aria_init_key_schedule(&ks, aria_load_block(key), right, decrypt ? DECRYPT : ENCRYPT, bits);
+    (void)aria_ecb_crypt(&ks, in, out, len);
+    for (size_t j = 0u; j < len; j += 16u)
+    {
+      aria_u128_t c = aria_crypt(&ks, aria_load_block(&in[j]));
+
+      if ((c.left != aria_load_be64(&out[j])) || (c.right != aria_load_be64(&out[j + 8u])))
+      {
+        bad = 1;
+      }
+    }
+    aria_wipe(&ks, sizeof(ks));
+  }
+  return bad;
+}
+
+/* RFC 5794 Appendix A: the key is 00 01 02 ..., the plaintext 00 11 22 ... */
+static const uint8_t aria_bench_rfc_ct[3][16] =
+{
+  { 0xd7, 0x18, 0xfb, 0xd6, 0xab, 0x64, 0x4c, 0x73, 0x9d, 0xa9, 0x5f, 0x3b, 0xe6, 0x45, 0x17, 0x78 },
+  { 0x26, 0x44, 0x9c, 0x18, 0x05, 0xdb, 0xe7, 0xaa, 0x25, 0xa4, 0x68, 0xce, 0x26, 0x3a, 0x9e, 0x79 },
+  { 0xf9, 0x2b, 0xd7, 0xc7, 0x9f, 0xb7, 0x2e, 0x2f, 0x2b, 0x8f, 0x80, 0xc1, 0x97, 0x2d, 0x24, 0xfc }
+};
+
+#define ARIA_BENCH_CHECK_KEYS  8u
+#define ARIA_BENCH_CHECK_BYTES (16u * 67u)
+
+/* Check each engine; returns the number that fail */
+static unsigned
+aria_bench_check (const aria_backend_t *engines, size_t count)
+{
+  static uint8_t data[ARIA_BENCH_CHECK_BYTES];
+  static uint8_t want[ARIA_BENCH_CHECK_BYTES];
+  static uint8_t got[ARIA_BENCH_CHECK_BYTES];
+  static uint8_t back[ARIA_BENCH_CHECK_BYTES];
+  unsigned failed = 0u;
+
+  for (size_t e = 0u; e < count; e++)
+  {
+    unsigned errors = 0u;
+
+    for (uint32_t k = 0u; k < 3u; k++)
+    {
+      uint32_t bits = 128u + (64u * k);
+      uint8_t key[32];
+      uint8_t pt[16];
+
+      for (unsigned i = 0u; i < 32u; i++)
+      {
+        key[i] = (uint8_t )i;
+      }
+      for (unsigned i = 0u; i < 16u; i++)
+      {
+        pt[i] = (uint8_t )(0x11u * i);
+      }
+      errors += (unsigned )aria_bench_engine_ecb(engines[e], key, bits, 0, pt, got, 16u);
+      errors += (0 != memcmp(got, aria_bench_rfc_ct[k], 16u)) ? 1u : 0u;
+      errors += (unsigned )aria_bench_engine_ecb(engines[e], key, bits, 1, aria_bench_rfc_ct[k], got, 16u);
+      errors += (0 != memcmp(got, pt, 16u)) ? 1u : 0u;
+
+      /* the same keys and data for every engine; lengths straddle the
+      ** SIMD kernels' batch sizes
+      */
+      (void)xorshift128plus_seed(0x5a5a5a5a5a5a5a5au + bits);
+      for (uint32_t n = 0u; n < ARIA_BENCH_CHECK_KEYS; n++)
+      {
+        size_t len = 16u * (1u + ((n * 23u) % (ARIA_BENCH_CHECK_BYTES / 16u)));
+
+        for (unsigned i = 0u; i < 32u; i++)
+        {
+          key[i] = (uint8_t )xorshift128plus_next();
+        }
+        for (size_t i = 0u; i < len; i++)
+        {
+          data[i] = (uint8_t )xorshift128plus_next();
+        }
+        errors += (unsigned )aria_bench_engine_ecb(BACKEND_REFERENCE, key, bits, 0, data, want, len);
+        errors += (unsigned )aria_bench_engine_ecb(engines[e], key, bits, 0, data, got, len);
+        errors += (0 != memcmp(got, want, len)) ? 1u : 0u;
+        errors += (unsigned )aria_bench_engine_ecb(engines[e], key, bits, 1, got, back, len);
+        errors += (0 != memcmp(back, data, len)) ? 1u : 0u;
+      }
+    }
+    if (0u == errors)
+    {
+      fprintf(stderr, "ariabench: %s check pass\n", aria_bench_engine_name(engines[e]));
+    }
+    else
+    {
+      fprintf(stderr, "ariabench: %s fail: %u errors\n", aria_bench_engine_name(engines[e]), errors);
+      failed++;
+    }
+  }
+  (void)aria_set_backend(BACKEND_AUTO);
+  return failed;
+}
+
+/* Timing */
+
+static int
+aria_bench_compare (const void *a, const void *b)
+{
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+
+  return (x < y) ? -1 : ((x > y) ? 1 : 0);
+}
+
+static void
+aria_bench_sample (aria_bench_t *b, aria_bench_op_t op, size_t iterations, double *ns, double *cycles)
+{
+  double   t = timer_e_nanoseconds();
+  uint64_t c = timer_e_cycles();
+
+  op(b, iterations);
+
+  uint64_t e = timer_e_cycles_end();
+
+  *ns     = (timer_e_nanoseconds() - t) / (double )iterations;
+  *cycles = (double )timer_e_cycles_elapsed(c, e) / (double )iterations;
+}
+
+static void
+aria_bench_run (aria_bench_t        *b
+              , aria_bench_op_t      op
+              , unsigned             reps
+              , unsigned             warmup
+              , double               sample_ns
+              , aria_bench_result_t *r)
+{
+  double ns[ARIA_BENCH_MAX_REPS];
+  double cycles[ARIA_BENCH_MAX_REPS];
+  size_t n = 1u;
+
+  /* grow the sample until it takes a tenth of the sample time, then scale */
+  for (;;)
+  {
+    double t;
+    double c;
+
+    aria_bench_sample(b, op, n, &t, &c);
+    if (((t * (double )n) >= (sample_ns / 10.0)) || (n >= ((size_t )1 << 30)))
+    {
+      double scaled = sample_ns / ((t > 0.0) ? t : 1.0);
+
+      n = (scaled < 1.0) ? 1u : (size_t )scaled;
+      break;
+    }
+    n *= 10u;
+  }
+  for (unsigned i = 0u; i < warmup; i++)
+  {
+    aria_bench_sample(b, op, n, &ns[0], &cycles[0]);
+  }
+  for (unsigned i = 0u; i < reps; i++)
+  {
+    aria_bench_sample(b, op, n, &ns[i], &cycles[i]);
+  }
+  qsort(ns, reps, sizeof(double), aria_bench_compare);
+  qsort(cycles, reps, sizeof(double), aria_bench_compare);
+  r->iterations = n;
+  r->ns[0]  = ns[reps / 2u];
+  r->ns[1]  = ns[(reps - 1u) / 10u];
+  r->ns[2]  = ns[(reps - 1u) - ((reps - 1u) / 10u)];
+  r->ns[3]  = ns[0];
+  r->cycles = cycles[reps / 2u];
+}
+
+/* Output */
+
+static void
+aria_bench_print (aria_bench_format_t format, const aria_bench_result_t *r, int first)
+{
+  double per   = (0u != r->bytes) ? (double )r->bytes : 1.0;
+  double gbps  = (0u != r->bytes) ? (per / r->ns[0]) : 0.0;
+
+  switch (format)
+  {
+    case FORMAT_CSV:
+      if (first)
+      {
+        printf("op,backend,key_bits,threads,bytes,iterations,ns_median,ns_p10,ns_p90,ns_min,cycles_median,cycles_per_byte,gb_per_s\n");
+      }
+      printf("%s,%s,%" PRIu32 ",%u,%zu,%zu,%.3f,%.3f,%.3f,%.3f,%.1f,%.3f,%.3f\n"
+            , r->op, r->backend, r->bits, r->threads, r->bytes, r->iterations
+            , r->ns[0], r->ns[1], r->ns[2], r->ns[3], r->cycles, r->cycles / per, gbps);
+      break;
+    case FORMAT_JSON:
+      printf("%s\n  {\"op\": \"%s\", \"backend\": \"%s\", \"key_bits\": %" PRIu32 ", \"threads\": %u, \"bytes\": %zu"
+             ", \"iterations\": %zu, \"ns_median\": %.3f, \"ns_p10\": %.3f, \"ns_p90\": %.3f, \"ns_min\": %.3f"
+             ", \"cycles_median\": %.1f, \"cycles_per_byte\": %.3f, \"gb_per_s\": %.3f}"
+            , first ? "[" : ","
+            , r->op, r->backend, r->bits, r->threads, r->bytes, r->iterations
+            , r->ns[0], r->ns[1], r->ns[2], r->ns[3], r->cycles, r->cycles / per, gbps);
+      break;
+    default:
+      if (first)
+      {
+        printf("%-10s %-9s %4s %3s %9s %12s %12s %12s %10s %8s\n"
+              , "op", "backend", "key", "thr", "bytes", "ns median", "ns p10", "ns p90", "cyc/byte", "GB/s");
+      }
+      printf("%-10s %-9s %4" PRIu32 " %3u %9zu %12.1f %12.1f %12.1f %10.2f %8.3f\n"
+            , r->op, r->backend, r->bits, r->threads, r->bytes
+            , r->ns[0], r->ns[1], r->ns[2], r->cycles / per, gbps);
+      break;
+  }
+  fflush(stdout);
+}
+
+/* Parse a comma separated list of numbers, with an optional K or M suffix */
+
+static size_t
+aria_bench_list (const char *s, unsigned long *v, size_t max)
+{
+  size_t n = 0u;
+
+  while ((n < max) && ('\0' != *s))
+  {
+    char *end;
+
+    v[n] = strtoul(s, &end, 10);
+    if (('K' == *end) || ('k' == *end))
+    {
+      v[n] <<= 10;
+      end++;
+    }
+    else if (('M' == *end) || ('m' == *end))
+    {
+      v[n] <<= 20;
+      end++;
+    }
+    if ((end == s) || ((',' != *end) && ('\0' != *end)))
+    {
+      return 0u;
+    }
+    n++;
+    s = (',' == *end) ? (end + 1) : end;
+  }
+  return n;
+}
+
+static int
+aria_bench_usage (void)
+{
+  fprintf(stderr, "usage: ariabench [-f text|csv|json] [-b backends] [-k key sizes] [-j threads]\n"
+                  "                 [-s min,max] [-r reps] [-w warmup] [-t sample ms] [-c]\n"
+                  "backends: the names aria_backend_name() gives, and oryx\n");
+  return 2;
+}
+
+int main (int argc, char **argv)
+{
+  aria_bench_format_t format = FORMAT_TEXT;
+  aria_backend_t backends[BACKEND_COUNT + 1u];
+  size_t nbackends = 0u;
+  unsigned long bits[ARIA_BENCH_MAX_LIST] = { 128u, 192u, 256u };
+  size_t nbits = 3u;
+  unsigned long threads[ARIA_BENCH_MAX_LIST] = { 1u, 0u };
+  size_t nthreads = 2u;
+  unsigned long sizes[2] = { 16u, ARIA_BENCH_MAX_BYTES };
+  unsigned reps   = 11u;
+  unsigned warmup = 2u;
+  double sample_ns = 2e6;
+  int check_only = 0;
+  int opt;
+
+  while (-1 != (opt = getopt(argc, argv, "f:b:k:j:s:r:w:t:c")))
+  {
+    switch (opt)
+    {
+      case 'f':
+        if (0 == strcmp("csv", optarg))
+        {
+          format = FORMAT_CSV;
+        }
+        else if (0 == strcmp("json", optarg))
+        {
+          format = FORMAT_JSON;
+        }
+        else if (0 != strcmp("text", optarg))
+        {
+          return aria_bench_usage();
+        }
+        break;
+      case 'b':
+        for (char *name = strtok(optarg, ","); NULL != name; name = strtok(NULL, ","))
+        {
+          unsigned b = BACKEND_REFERENCE;
+
+          while ((b <= BACKEND_COUNT) && (0 != strcmp(name, aria_bench_engine_name((aria_backend_t )b))))
+          {
+            b++;
+          }
+          if ((b > BACKEND_COUNT) || (nbackends > BACKEND_COUNT))
+          {
+            return aria_bench_usage();
+          }
+          backends[nbackends++] = (aria_backend_t )b;
+        }
+        break;
+      case 'k':
+        nbits = aria_bench_list(optarg, bits, ARIA_BENCH_MAX_LIST);
+        break;
+      case 'j':
+        nthreads = aria_bench_list(optarg, threads, ARIA_BENCH_MAX_LIST);
+        break;
+      case 's':
+        if ((2u != aria_bench_list(optarg, sizes, 2u)) || (sizes[0] < 16u) || (sizes[1] > ARIA_BENCH_MAX_BYTES))
+        {
+          return aria_bench_usage();
+        }
+        break;
+      case 'r':
+        reps = (unsigned )strtoul(optarg, NULL, 10);
+        break;
+      case 'w':
+        warmup = (unsigned )strtoul(optarg, NULL, 10);
+        break;
+      case 't':
+        sample_ns = strtod(optarg, NULL) * 1e6;
+        break;
+      case 'c':
+        check_only = 1;
+        break;
+      default:
+        return aria_bench_usage();
+    }
+  }
+  if ((0u == nbits) || (0u == nthreads) || (0u == reps) || (reps > ARIA_BENCH_MAX_REPS) || !(sample_ns > 0.0))
+  {
+    return aria_bench_usage();
+  }
+  for (size_t i = 0u; i < nbits; i++)
+  {
+    if ((128u != bits[i]) && (192u != bits[i]) && (256u != bits[i]))
+    {
+      return aria_bench_usage();
+    }
+  }
+  if (0u == nbackends)
+  {
+    for (unsigned b = BACKEND_REFERENCE; b < BACKEND_COUNT; b++)
+    {
+      if (aria_backend_supported((aria_backend_t )b))
+      {
+        backends[nbackends++] = (aria_backend_t )b;
+      }
+    }
+    backends[nbackends++] = ARIA_BENCH_ORYX;
+  }
+  for (size_t be = 0u; be < nbackends; be++)
+  {
+    if ((ARIA_BENCH_ORYX != backends[be]) && !aria_backend_supported(backends[be]))
+    {
+      fprintf(stderr, "ariabench: backend %s not supported\n", aria_backend_name(backends[be]));
+      return 1;
+    }
+  }
+  if (0u != aria_bench_check(backends, nbackends))
+  {
+    return 1;
+  }
+  if (check_only)
+  {
+    return 0;
+  }
+
+  /* one per CPU, unless that is one */
+  if ((2u == nthreads) && (1u == threads[0]) && (0u == threads[1]))
+  {
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+    threads[1] = (unsigned long )ncpu;
+    nthreads   = (ncpu > 1) ? 2u : 1u;
+  }
+
+  aria_bench_t b;
+  aria_bench_result_t r;
+  void *in  = NULL;
+  void *out = NULL;
+  int first = 1;
+
+  memset(&b, 0, sizeof(b));
+  if ((0 != posix_memalign(&in, 64u, ARIA_BENCH_MAX_BYTES)) || (0 != posix_memalign(&out, 64u, ARIA_BENCH_MAX_BYTES)))
+  {
+    fprintf(stderr, "ariabench: out of memory\n");
+    return 1;
+  }
+  b.in  = in;
+  b.out = out;
+  xorshift128plus_lanes_t lanes;
+
+  xorshift128plus_lanes_seed(&lanes, 0x0123456789abcdefu);
+  xorshift128plus_fill(&lanes, in, ARIA_BENCH_MAX_BYTES / sizeof(uint64_t));
+  (void)xorshift128plus_seed(0x0123456789abcdefu);
+  memset(b.out, 0, ARIA_BENCH_MAX_BYTES);
+  b.key[0] = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+  b.key[1] = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+  b.block  = (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() };
+
+  fprintf(stderr, "ariabench: cycle counter %.3f GHz, read overhead %" PRIu64 " cycles\n"
+                , timer_e_cycles_hz() / 1e9, timer_e_cycles_overhead());
+
+  /* key setup does not depend on the backend */
+  for (size_t k = 0u; k < nbits; k++)
+  {
+    static const struct { const char *name; aria_bench_op_t op; } key_ops[2] =
+    {
+      { "key_enc", aria_bench_key_enc }, { "key_dec", aria_bench_key_dec }
+    };
+
+    b.bits = (uint32_t )bits[k];
+    for (size_t o = 0u; o < 2u; o++)
+    {
+      r = (aria_bench_result_t ){ key_ops[o].name, "-", b.bits, 1u, 0u, 0u, { 0.0 }, 0.0 };
+      aria_bench_run(&b, key_ops[o].op, reps, warmup, sample_ns, &r);
+      aria_bench_print(format, &r, first);
+      first = 0;
+    }
+  }
+
+  for (size_t be = 0u; be < nbackends; be++)
+  {
+    if (ARIA_BENCH_ORYX == backends[be])
+    {
+      for (size_t k = 0u; k < nbits; k++)
+      {
+        static const struct { const char *name; aria_bench_op_t op; } oryx_ops[2] =
+        {
+          { "key_dec", aria_bench_oryx_key }, { "block", aria_bench_oryx_block }
+        };
+
+        b.bits = (uint32_t )bits[k];
+        aria_bench_oryx_init(&b.oryx, b.key[0], b.key[1], b.bits);
+        for (size_t o = 0u; o < 2u; o++)
+        {
+          r = (aria_bench_result_t ){ oryx_ops[o].name, "oryx", b.bits, 1u, (0u == o) ? 0u : 16u, 0u, { 0.0 }, 0.0 };
+          aria_bench_run(&b, oryx_ops[o].op, reps, warmup, sample_ns, &r);
+          aria_bench_print(format, &r, first);
+          first = 0;
+        }
+        aria_bench_oryx_init(&b.oryx, b.key[0], b.key[1], b.bits);
+        for (b.bytes = sizes[0]; b.bytes <= sizes[1]; b.bytes *= 4u)
+        {
+          b.bytes &= ~(size_t )15u;
+          r = (aria_bench_result_t ){ "ecb", "oryx", b.bits, 1u, b.bytes, 0u, { 0.0 }, 0.0 };
+          aria_bench_run(&b, aria_bench_oryx_ecb, reps, warmup, sample_ns, &r);
+          aria_bench_print(format, &r, first);
+          first = 0;
+        }
+      }
+      continue;
+    }
+    (void)aria_set_backend(backends[be]);
+
+    const char *name = aria_backend_name(backends[be]);
+
+    for (size_t k = 0u; k < nbits; k++)
+    {
+      b.bits = (uint32_t )bits[k];
+      (void)aria_init_key_schedule(&b.ks, b.key[0], b.key[1], ENCRYPT, b.bits);
+      (void)aria_gcm_init(&b.gcm, &b.ks);
+
+      r = (aria_bench_result_t ){ "block", name, b.bits, 1u, 16u, 0u, { 0.0 }, 0.0 };
+      aria_bench_run(&b, aria_bench_block, reps, warmup, sample_ns, &r);
+      aria_bench_print(format, &r, first);
+      first = 0;
+
+      for (size_t t = 0u; t < nthreads; t++)
+      {
+        b.pool = NULL;
+        if ((threads[t] > 1u) && (NO_ERROR != aria_pool_create(&b.pool, (unsigned )threads[t], 0)))
+        {
+          fprintf(stderr, "ariabench: cannot start %lu threads\n", threads[t]);
+          continue;
+        }
+        for (b.bytes = sizes[0]; b.bytes <= sizes[1]; b.bytes *= 4u)
+        {
+          static const struct { const char *name; aria_bench_op_t op; } ops[4] =
+          {
+            { "ecb", aria_bench_ecb }, { "ctr", aria_bench_ctr }, { "xts", aria_bench_xts }, { "gcm", aria_bench_gcm }
+          };
+
+          b.bytes &= ~(size_t )15u;
+          for (size_t o = 0u; o < 4u; o++)
+          {
+            if (((aria_bench_gcm == ops[o].op) || (aria_bench_xts == ops[o].op)) && (NULL != b.pool))
+            {
+              continue; /* GCM and XTS have no pool versions */
+            }
+            r = (aria_bench_result_t ){ ops[o].name, name, b.bits, (unsigned )threads[t], b.bytes, 0u, { 0.0 }, 0.0 };
+            aria_bench_run(&b, ops[o].op, reps, warmup, sample_ns, &r);
+            aria_bench_print(format, &r, first);
+            first = 0;
+          }
+        }
+        aria_pool_destroy(b.pool);
+      }
+    }
+  }
+  if (FORMAT_JSON == format)
+  {
+    printf("%s\n]\n", first ? "[" : "");
+  }
+  aria_wipe(&b.ks, sizeof(b.ks));
+  aria_wipe(&b.gcm, sizeof(b.gcm));
+  aria_wipe(&b.oryx, sizeof(b.oryx));
+  free(in);
+  free(out);
+  return 0;
+}
@@ -0,0 +1,517 @@
+/* aria_bitslice.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* Bitsliced ARIA, 64 blocks per pass
+**
+** Word i of the state holds bit i of 64 blocks, one block per bit, so each
+** 64-bit AND or XOR does one step of a boolean circuit for all of them at
+** once. There are no table lookups and no branches on data, so the time a
+** pass takes depends only on the round count: it is constant time on any
+** CPU with 64-bit logic, and needs no SIMD. The key schedule is still set
+** up with the table engine, once per key, as for every other backend.
+**
+** State: a pass loads the 64 blocks' left words into s[0..63] and their
+** right words into s[64..127], and transposes each half, so s[i] bit j is
+** bit i of block j's left (or right) word. Block byte p (0 most significant,
+** as in aria_block.h) is then the eight words at ARIA_BS_BYTE(s, p), least
+** significant bit first.
+**
+** S-boxes: SB1 and SB2 are an affine map of the inverse in GF(2^8), and SB3
+** and SB4 their inverses, so each is Mout(inv(Min(x) ^ cin)) ^ cout for
+** linear maps Min and Mout. Inversion is much cheaper in a tower field,
+** GF(2^8) as GF(2^4)[y]/(y^2 + y + z^3) over GF(2^4) = GF(2)[z]/(z^4 + z + 1),
+** so Min changes to the tower basis, and Mout changes back; the maps below
+** have the affine parts of the S-boxes folded in, and their constants become
+** NOTs. The linear maps were reduced with greedy common subexpression
+** elimination, and every S-box circuit checked against SB1..SB4 on all 256
+** inputs. Each S-box costs 58 ANDs and about 110 XORs and NOTs.
+**
+** Diffusion: A mixes whole bytes, so it is the same XOR network on each of
+** the eight bit positions.
+*/
+
+#include "aria_bitslice.h"
+#include "aria_block.h"
+
+#include <string.h>
+
+/* The eight words of block byte p, 0..15 */
+#define ARIA_BS_BYTE(s, p) (&(s)[(((p) & 8u) << 3) + 8u * (7u - ((p) & 7u))])
+
+/* a[j] bit k <-> a[k] bit j, by swapping ever smaller off-diagonal blocks */
+
+static void
+aria_bs_transpose (uint64_t a[64])
+{
+  static const uint64_t m[6] =
+  {
+    0x00000000ffffffffu, 0x0000ffff0000ffffu, 0x00ff00ff00ff00ffu
+  , 0x0f0f0f0f0f0f0f0fu, 0x3333333333333333u, 0x5555555555555555u
+  };
+  unsigned k = 0u;
+
+  for (unsigned w = 32u; w > 0u; w >>= 1, k++)
+  {
+    for (unsigned j = 0u; j < 64u; j = (j + w + 1u) & ~w)
+    {
+      uint64_t t = ((a[j] >> w) ^ a[j + w]) & m[k];
+
+      a[j]     ^= t << w;
+      a[j + w] ^= t;
+    }
+  }
+}
+
+/* Round key, as all-ones or all-zero words; only the mask depends on the key */
+
+static inline void
+aria_bs_add_key (uint64_t s[128], aria_u128_t k)
+{
+  for (unsigned i = 0u; i < 64u; i++)
+  {
+    s[i]       ^= 0u - ((k.left  >> i) & 1u);
+    s[64u + i] ^= 0u - ((k.right >> i) & 1u);
+  }
+}
+
+/* A round key per block, the first n of lanes: transposed as the blocks are */
+
+static inline void
+aria_bs_add_lane_keys (uint64_t s[128], const aria_key_schedule_t *const *lanes, size_t n, uint32_t r)
+{
+  uint64_t k[128];
+
+  memset(k, 0, sizeof(k));
+  for (size_t j = 0u; j < n; j++)
+  {
+    k[j]       = lanes[j]->ek[r].left;
+    k[64u + j] = lanes[j]->ek[r].right;
+  }
+  aria_bs_transpose(&k[0]);
+  aria_bs_transpose(&k[64]);
+  for (unsigned i = 0u; i < 128u; i++)
+  {
+    s[i] ^= k[i];
+  }
+}
+
+/* GF(2^4) multiply, modulo z^4 + z + 1 */
+
+static inline void
+aria_bs_mul16 (const uint64_t a[4], const uint64_t b[4], uint64_t r[4])
+{
+  uint64_t c0 = a[0] & b[0];
+  uint64_t c1 = (a[0] & b[1]) ^ (a[1] & b[0]);
+  uint64_t c2 = (a[0] & b[2]) ^ (a[1] & b[1]) ^ (a[2] & b[0]);
+  uint64_t c3 = (a[0] & b[3]) ^ (a[1] & b[2]) ^ (a[2] & b[1]) ^ (a[3] & b[0]);
+  uint64_t c4 = (a[1] & b[3]) ^ (a[2] & b[2]) ^ (a[3] & b[1]);
+  uint64_t c5 = (a[2] & b[3]) ^ (a[3] & b[2]);
+  uint64_t c6 = a[3] & b[3];
+
+  r[0] = c0 ^ c4;
+  r[1] = c1 ^ c4 ^ c5;
+  r[2] = c2 ^ c5 ^ c6;
+  r[3] = c3 ^ c6;
+}
+
+/* GF(2^4) inverse (0 to 0), from its algebraic normal form */
+
+static inline void
+aria_bs_inv16 (const uint64_t a[4], uint64_t r[4])
+{
+  uint64_t m01  = a[0] & a[1];
+  uint64_t m02  = a[0] & a[2];
+  uint64_t m03  = a[0] & a[3];
+  uint64_t m12  = a[1] & a[2];
+  uint64_t m13  = a[1] & a[3];
+  uint64_t m23  = a[2] & a[3];
+  uint64_t m012 = m01 & a[2];
+  uint64_t m013 = m01 & a[3];
+  uint64_t m023 = m02 & a[3];
+  uint64_t m123 = m12 & a[3];
+
+  r[0] = a[0] ^ a[1] ^ a[2] ^ a[3] ^ m02 ^ m12 ^ m012 ^ m123;
+  r[1] = a[3] ^ m01 ^ m02 ^ m12 ^ m13 ^ m013;
+  r[2] = a[2] ^ a[3] ^ m01 ^ m02 ^ m03 ^ m023;
+  r[3] = a[1] ^ a[2] ^ a[3] ^ m03 ^ m13 ^ m23 ^ m123;
+}
+
+/* GF(2^8) inverse in the tower basis, t[0..3] low and t[4..7] high:
+** 1/(h y + l) = (h y + (h + l)) / (z^3 h^2 + h l + l^2)
+*/
+
+static inline void
+aria_bs_inv256 (const uint64_t t[8], uint64_t o[8])
+{
+  const uint64_t *l = &t[0];
+  const uint64_t *h = &t[4];
+  uint64_t u0 = t[2] ^ t[6];
+  uint64_t q[4]; /* z^3 h^2 + l^2, which is linear */
+  uint64_t m[4];
+  uint64_t d[4];
+  uint64_t di[4];
+  uint64_t hl[4];
+
+  q[0] = t[0] ^ u0;
+  q[1] = t[5] ^ t[7] ^ u0;
+  q[2] = t[1] ^ t[3] ^ t[5];
+  q[3] = t[3] ^ t[4] ^ t[6] ^ t[7];
+  aria_bs_mul16(h, l, m);
+  for (unsigned i = 0u; i < 4u; i++)
+  {
+    d[i]  = q[i] ^ m[i];
+    hl[i] = h[i] ^ l[i];
+  }
+  aria_bs_inv16(d, di);
+  aria_bs_mul16(hl, di, &o[0]);
+  aria_bs_mul16(h,  di, &o[4]);
+}
+
+/* Min: the standard basis to the tower basis, for SB1 and SB2 */
+
+static inline void
+aria_bs_in12 (const uint64_t x[8], uint64_t y[8])
+{
+  uint64_t u0 = x[5] ^ x[7];
+  uint64_t u1 = x[4] ^ x[6];
+  uint64_t u3 = u0 ^ x[2] ^ x[3];
+
+  y[0] = x[0] ^ u0;
+  y[1] = x[2];
+  y[2] = u1 ^ u3;
+  y[3] = x[3] ^ x[4];
+  y[4] = x[5] ^ u1;
+  y[5] = x[1] ^ x[7] ^ u1;
+  y[6] = u3;
+  y[7] = u0;
+}
+
+/* Min for SB3: SB1's affine map undone, then to the tower basis */
+
+static inline void
+aria_bs_in3 (const uint64_t x[8], uint64_t y[8])
+{
+  uint64_t u0 = x[5] ^ x[6];
+  uint64_t u1 = x[0] ^ u0;
+  uint64_t u2 = x[1] ^ x[2];
+  uint64_t u3 = x[1] ^ x[4];
+  uint64_t u4 = x[4] ^ u1;
+  uint64_t u5 = x[7] ^ u2;
+
+  y[0] = ~(x[1] ^ u0);
+  y[1] = ~(x[7] ^ u3);
+  y[2] = ~u3;
+  y[3] = x[3] ^ u1 ^ u2;
+  y[4] = u4 ^ u5;
+  y[5] = x[3] ^ x[4] ^ u0;
+  y[6] = ~u4;
+  y[7] = x[6] ^ u5;
+}
+
+/* Min for SB4: SB2's affine map undone, then to the tower basis */
+
+static inline void
+aria_bs_in4 (const uint64_t x[8], uint64_t y[8])
+{
+  uint64_t u1 = x[0] ^ x[1] ^ x[2];
+  uint64_t u2 = x[4] ^ x[6];
+
+  y[0] = ~u1;
+  y[1] = ~u2;
+  y[2] = ~x[1];
+  y[3] = ~(x[5] ^ x[7] ^ u2);
+  y[4] = ~(x[2] ^ x[3] ^ u2);
+  y[5] = x[5] ^ u1;
+  y[6] = ~(x[3] ^ x[7]);
+  y[7] = ~(x[3] ^ x[4] ^ u1);
+}
+
+/* Mout for SB1: back to the standard basis, then SB1's affine map */
+
+static inline void
+aria_bs_out1 (const uint64_t x[8], uint64_t y[8])
+{
+  uint64_t u0 = x[0] ^ x[5];
+  uint64_t u1 = x[1] ^ x[2];
+  uint64_t u2 = x[3] ^ u0;
+  uint64_t u3 = x[4] ^ u2;
+  uint64_t u4 = x[6] ^ x[7];
+
+  y[0] = ~(x[0] ^ x[2] ^ x[6]);
+  y[1] = ~(u1 ^ u3);
+  y[2] = x[6] ^ u2;
+  y[3] = x[2] ^ u0;
+  y[4] = x[1] ^ u3;
+  y[5] = ~(x[3] ^ x[5] ^ u1 ^ u4);
+  y[6] = ~(x[4] ^ u4);
+  y[7] = u1;
+}
+
+/* Mout for SB2: back to the standard basis, then SB2's affine map */
+
+static inline void
+aria_bs_out2 (const uint64_t x[8], uint64_t y[8])
+{
+  uint64_t u0 = x[3] ^ x[5];
+  uint64_t u1 = x[6] ^ u0;
+  uint64_t u2 = x[0] ^ x[1];
+  uint64_t u3 = x[4] ^ u1;
+  uint64_t u4 = x[7] ^ u1;
+
+  y[0] = x[2] ^ u3;
+  y[1] = ~x[2];
+  y[2] = x[0] ^ u3;
+  y[3] = u1 ^ u2;
+  y[4] = x[1] ^ u4;
+  y[5] = ~(x[0] ^ x[5]);
+  y[6] = ~u4;
+  y[7] = ~(u0 ^ u2);
+}
+
+/* Mout for SB3 and SB4: back to the standard basis */
+
+static inline void
+aria_bs_out34 (const uint64_t x[8], uint64_t y[8])
+{
+  uint64_t u0 = x[1] ^ x[7];
+  uint64_t u2 = x[3] ^ u0;
+  uint64_t u3 = x[2] ^ x[4] ^ x[6];
+
+  y[0] = x[0] ^ x[7];
+  y[1] = x[4] ^ x[5] ^ x[7];
+  y[2] = x[1];
+  y[3] = x[6] ^ u0;
+  y[4] = x[6] ^ u2;
+  y[5] = u3;
+  y[6] = x[2] ^ u2;
+  y[7] = x[7] ^ u3;
+}
+
+#define ARIA_BS_SBOX(n, in, out) \
+static inline void \
+aria_bs_sb##n (uint64_t x[8]) \
+{ \
+  uint64_t t[8]; \
+  uint64_t o[8]; \
+ \
+  in(x, t); \
+  aria_bs_inv256(t, o); \
+  out(o, x); \
+}
+
+ARIA_BS_SBOX(1, aria_bs_in12, aria_bs_out1)
+ARIA_BS_SBOX(2, aria_bs_in12, aria_bs_out2)
+ARIA_BS_SBOX(3, aria_bs_in3,  aria_bs_out34)
+ARIA_BS_SBOX(4, aria_bs_in4,  aria_bs_out34)
+
+#undef ARIA_BS_SBOX
+
+static void
+aria_bs_SL1 (uint64_t s[128])
+{
+  for (unsigned p = 0u; p < 16u; p += 4u)
+  {
+    aria_bs_sb1(ARIA_BS_BYTE(s, p));
+    aria_bs_sb2(ARIA_BS_BYTE(s, p + 1u));
+    aria_bs_sb3(ARIA_BS_BYTE(s, p + 2u));
+    aria_bs_sb4(ARIA_BS_BYTE(s, p + 3u));
+  }
+}
+
+static void
+aria_bs_SL2 (uint64_t s[128])
+{
+  for (unsigned p = 0u; p < 16u; p += 4u)
+  {
+    aria_bs_sb3(ARIA_BS_BYTE(s, p));
+    aria_bs_sb4(ARIA_BS_BYTE(s, p + 1u));
+    aria_bs_sb1(ARIA_BS_BYTE(s, p + 2u));
+    aria_bs_sb2(ARIA_BS_BYTE(s, p + 3u));
+  }
+}
+
+/* aria_A() in aria.c, with its common subexpressions, once per bit position */
+
+static void
+aria_bs_A (uint64_t s[128])
+{
+  for (unsigned b = 0u; b < 8u; b++)
+  {
+    uint64_t x[16];
+
+    for (unsigned p = 0u; p < 16u; p++)
+    {
+      x[p] = ARIA_BS_BYTE(s, p)[b];
+    }
+
+    uint64_t t0 = x[0] ^ x[7] ^ x[10] ^ x[13];
+    uint64_t t1 = x[1] ^ x[6] ^ x[11] ^ x[12];
+    uint64_t t2 = x[2] ^ x[5] ^ x[8]  ^ x[15];
+    uint64_t t3 = x[3] ^ x[4] ^ x[9]  ^ x[14];
+
+    ARIA_BS_BYTE(s,  0u)[b] = t3   ^ x[6] ^ x[8]  ^ x[13];
+    ARIA_BS_BYTE(s,  1u)[b] = t2   ^ x[7] ^ x[9]  ^ x[12];
+    ARIA_BS_BYTE(s,  2u)[b] = t1   ^ x[4] ^ x[10] ^ x[15];
+    ARIA_BS_BYTE(s,  3u)[b] = t0   ^ x[5] ^ x[11] ^ x[14];
+    ARIA_BS_BYTE(s,  4u)[b] = x[0] ^ t2   ^ x[11] ^ x[14];
+    ARIA_BS_BYTE(s,  5u)[b] = x[1] ^ t3   ^ x[10] ^ x[15];
+    ARIA_BS_BYTE(s,  6u)[b] = t0   ^ x[2] ^ x[9]  ^ x[12];
+    ARIA_BS_BYTE(s,  7u)[b] = t1   ^ x[3] ^ x[8]  ^ x[13];
+    ARIA_BS_BYTE(s,  8u)[b] = t0   ^ x[1] ^ x[4]  ^ x[15];
+    ARIA_BS_BYTE(s,  9u)[b] = x[0] ^ t1   ^ x[5]  ^ x[14];
+    ARIA_BS_BYTE(s, 10u)[b] = t2   ^ x[3] ^ x[6]  ^ x[13];
+    ARIA_BS_BYTE(s, 11u)[b] = x[2] ^ t3   ^ x[7]  ^ x[12];
+    ARIA_BS_BYTE(s, 12u)[b] = t1   ^ x[2] ^ x[7]  ^ x[9];
+    ARIA_BS_BYTE(s, 13u)[b] = t0   ^ x[3] ^ x[6]  ^ x[8];
+    ARIA_BS_BYTE(s, 14u)[b] = x[0] ^ t3   ^ x[5]  ^ x[11];
+    ARIA_BS_BYTE(s, 15u)[b] = x[1] ^ t2   ^ x[4]  ^ x[10];
+  }
+}
+
+/* One pass over s, loaded with 64 blocks' left words then their right words;
+** with lanes, block j under the schedule lanes[j], for the first n blocks,
+** all of them with the round count of ks
+*/
+
+static inline void
+aria_bs_key (uint64_t s[128], const aria_key_schedule_t *ks, const aria_key_schedule_t *const *lanes, size_t n, uint32_t r)
+{
+  if (NULL == lanes)
+  {
+    aria_bs_add_key(s, ks->ek[r]);
+  }
+  else
+  {
+    aria_bs_add_lane_keys(s, lanes, n, r);
+  }
+}
+
+static void
+aria_bs_crypt (const aria_key_schedule_t *ks, const aria_key_schedule_t *const *lanes, size_t n, uint64_t s[128])
+{
+  aria_bs_transpose(&s[0]);
+  aria_bs_transpose(&s[64]);
+  aria_bs_key(s, ks, lanes, n, 1u);
+  aria_bs_SL1(s);
+  aria_bs_A(s);
+  for (uint32_t i = 2u; i < ks->rounds; i += 2u)
+  {
+    aria_bs_key(s, ks, lanes, n, i);
+    aria_bs_SL2(s);
+    aria_bs_A(s);
+    aria_bs_key(s, ks, lanes, n, i + 1u);
+    aria_bs_SL1(s);
+    aria_bs_A(s);
+  }
+  aria_bs_key(s, ks, lanes, n, ks->rounds);
+  aria_bs_SL2(s);
+  aria_bs_key(s, ks, lanes, n, ks->rounds + 1u);
+  aria_bs_transpose(&s[0]);
+  aria_bs_transpose(&s[64]);
+}
+
+size_t
+aria_bitslice_crypt_blocks (const aria_key_schedule_t *ks
+                          , const aria_u128_t *in
+                          , aria_u128_t       *out
+                          , size_t             count)
+{
+  uint64_t s[128];
+
+  for (size_t done = 0u, n; done < count; done += n)
+  {
+    n = count - done;
+    if (n > ARIA_BITSLICE_LANES)
+    {
+      n = ARIA_BITSLICE_LANES;
+    }
+    memset(s, 0, sizeof(s));
+    for (size_t j = 0u; j < n; j++)
+    {
+      s[j]       = in[done + j].left;
+      s[64u + j] = in[done + j].right;
+    }
+    aria_bs_crypt(ks, NULL, n, s);
+    for (size_t j = 0u; j < n; j++)
+    {
+      out[done + j].left  = s[j];
+      out[done + j].right = s[64u + j];
+    }
+  }
+  return count;
+}
+
+size_t
+aria_bitslice_crypt_bytes (const aria_key_schedule_t *ks
+                         , const uint8_t *in
+                         , uint8_t       *out
+                         , size_t         count)
+{
+  uint64_t s[128];
+
+  for (size_t done = 0u, n; done < count; done += n)
+  {
+    n = count - done;
+    if (n > ARIA_BITSLICE_LANES)
+    {
+      n = ARIA_BITSLICE_LANES;
+    }
+    memset(s, 0, sizeof(s));
+    for (size_t j = 0u; j < n; j++)
+    {
+      s[j]       = aria_load_be64(&in[16u * (done + j)]);
+      s[64u + j] = aria_load_be64(&in[16u * (done + j) + 8u]);
+    }
+    aria_bs_crypt(ks, NULL, n, s);
+    for (size_t j = 0u; j < n; j++)
+    {
+      aria_store_be64(&out[16u * (done + j)],      s[j]);
+      aria_store_be64(&out[16u * (done + j) + 8u], s[64u + j]);
+    }
+  }
+  return count;
+}
+
+size_t
+aria_bitslice_crypt_lanes (const aria_key_schedule_t *const *ks
+                         , const aria_u128_t *in
+                         , aria_u128_t       *out
+                         , size_t             count)
+{
+  uint64_t s[128];
+
+  for (size_t done = 0u, n; done < count; done += n)
+  {
+    n = count - done;
+    if (n > ARIA_BITSLICE_LANES)
+    {
+      n = ARIA_BITSLICE_LANES;
+    }
+    memset(s, 0, sizeof(s));
+    for (size_t j = 0u; j < n; j++)
+    {
+      s[j]       = in[done + j].left;
+      s[64u + j] = in[done + j].right;
+    }
+    aria_bs_crypt(ks[done], &ks[done], n, s);
+    for (size_t j = 0u; j < n; j++)
+    {
+      out[done + j].left  = s[j];
+      out[done + j].right = s[64u + j];
+    }
+  }
+  return count;
+}
+
+aria_u128_t
+aria_bitslice_crypt (const aria_key_schedule_t *ks, aria_u128_t text)
+{
+  aria_u128_t out;
+
+  (void)aria_bitslice_crypt_blocks(ks, &text, &out, 1u);
+  return out;
+}
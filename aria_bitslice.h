@@ -0,0 +1,52 @@
+/* aria_bitslice.h
+**
+** Internal interface between aria.c and the bitsliced engine in
+** aria_bitslice.c
+*/
+
+#ifndef ARIA_BITSLICE_H
+#define ARIA_BITSLICE_H
+
+#include "aria.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Blocks per pass: one per bit of a uint64_t */
+#define ARIA_BITSLICE_LANES 64u
+
+/* Unlike the x86 kernels, these do all count blocks, padding a short last
+** pass, and return count. in and out may be the same array.
+*/
+size_t aria_bitslice_crypt_blocks (const aria_key_schedule_t *ks
+                                 , const aria_u128_t *in
+                                 , aria_u128_t       *out
+                                 , size_t             count);
+
+/* The same on count blocks at in and out in byte order (see
+** aria_crypt_bytes()), with no alignment needed
+*/
+size_t aria_bitslice_crypt_bytes (const aria_key_schedule_t *ks
+                                , const uint8_t *in
+                                , uint8_t       *out
+                                , size_t         count);
+
+/* The same with a key schedule per block: block i under ks[i], all of them
+** with the same round count
+*/
+size_t aria_bitslice_crypt_lanes (const aria_key_schedule_t *const *ks
+                                , const aria_u128_t *in
+                                , aria_u128_t       *out
+                                , size_t             count);
+
+/* One block, in a pass of its own; as slow as 64, but still constant time */
+aria_u128_t aria_bitslice_crypt (const aria_key_schedule_t *ks, aria_u128_t text);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARIA_BITSLICE_H */
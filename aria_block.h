@@ -0,0 +1,53 @@
+/* aria_block.h
+**
+** Internal: blocks in byte order. A 16-byte block b[0..15] is the aria_u128_t
+** with b[0..7] in left and b[8..15] in right, most significant byte first, as
+** in RFC 5794's test vectors.
+*/
+
+#ifndef ARIA_BLOCK_H
+#define ARIA_BLOCK_H
+
+#include "aria.h"
+
+/* Compilers turn these into a single (byte swapping, when needed) load or
+** store, bswap or movbe on x86, so data needs no alignment and the code
+** needs no endian tests.
+*/
+
+static inline uint64_t
+aria_load_be64 (const uint8_t *p)
+{
+  return ((uint64_t )p[0] << 56) | ((uint64_t )p[1] << 48)
+       | ((uint64_t )p[2] << 40) | ((uint64_t )p[3] << 32)
+       | ((uint64_t )p[4] << 24) | ((uint64_t )p[5] << 16)
+       | ((uint64_t )p[6] <<  8) |  (uint64_t )p[7];
+}
+
+static inline void
+aria_store_be64 (uint8_t *p, uint64_t v)
+{
+  p[0] = (uint8_t )(v >> 56);
+  p[1] = (uint8_t )(v >> 48);
+  p[2] = (uint8_t )(v >> 40);
+  p[3] = (uint8_t )(v >> 32);
+  p[4] = (uint8_t )(v >> 24);
+  p[5] = (uint8_t )(v >> 16);
+  p[6] = (uint8_t )(v >>  8);
+  p[7] = (uint8_t )v;
+}
+
+static inline aria_u128_t
+aria_load_block (const uint8_t *p)
+{
+  return (aria_u128_t ){ aria_load_be64(p), aria_load_be64(p + 8) };
+}
+
+static inline void
+aria_store_block (uint8_t *p, aria_u128_t b)
+{
+  aria_store_be64(p,     b.left);
+  aria_store_be64(p + 8, b.right);
+}
+
+#endif /* ARIA_BLOCK_H */
@@ -0,0 +1,310 @@
+/* aria_byteslice.h
+**
+** Byte-sliced ARIA kernel body. This file is included by aria_x86.c and
+** aria_arm.c once per instruction set, after defining
+**
+**   ARIA_BS_NAME(x)    paste a per-instruction-set prefix onto x
+**   ARIA_BS_TARGET     the function attribute enabling the instruction set
+**   ARIA_BS_BLOCKS     blocks per pass: 16 per 128-bit lane of BS_V
+**   BS_V               the vector type
+**   BS_XOR, BS_AND, BS_ANDNOT, BS_SHUF, BS_SRL4, BS_SET1, BS_TAB,
+**   BS_UNPACKLO8, BS_UNPACKHI8, BS_LOAD, BS_STORE, BS_KEY
+**
+** and optionally BS_SB1..BS_SB4 to replace the vperm S-boxes.
+**
+** Byte slicing: ARIA_BS_BLOCKS blocks are transposed so that vector s[m]
+** holds byte m of every block. In this layout each vector needs only one
+** S-box, and the diffusion layer A is nothing but XORs of whole vectors.
+** The round key byte for s[m] is splatted across the vector; with a
+** schedule per block (crypt_lanes), the round keys are sliced like blocks.
+**
+** Blocks are aria_u128_t in memory, so on little-endian x86 and AArch64
+** memory offset m holds ARIA byte x(7-m) for m < 8 and x(23-m) for m >= 8;
+** BS_X maps an ARIA byte index to its vector. Blocks in byte order (aria_crypt_bytes()) are
+** loaded with one more shuffle per vector, swapping the bytes of each half,
+** which puts them in that same layout.
+*/
+
+#define BS_X(s, b) ((s)[((b) < 8) ? (7 - (b)) : (23 - (b))])
+
+/* The vperm S-box
+**
+** All four ARIA S-boxes are affine maps around inversion in GF(2^8):
+** SB1 = out1(inv(x)), SB2 = out2(inv(x)), SB3 = inv(in3(x)), SB4 = inv(in4(x)).
+** Following Hamburg's "Accelerating AES with Vector Permute Instructions",
+** the input is mapped (by two 16-entry lookups) to a pair of nibbles (i, k)
+** representing an element of GF((2^4)^2), and the inverse is computed with
+** nothing but 16-entry lookups of nibbles and XORs:
+**
+**    iak = 1/i + a/k,  jak = 1/(i+k) + a/k
+**    io  = (i+k) + 1/iak,  jo = i + 1/jak
+**
+** where lookups of 0 give 0x80, so that pshufb (or tbl) returns 0 for 1/0
+** further on.
+** Two more lookups of io and jo map back to bytes with the output affine map
+** folded in. Every lookup is a register shuffle, so there are no memory
+** accesses indexed by secret data.
+*/
+
+static inline ARIA_BS_TARGET BS_V
+ARIA_BS_NAME(vperm) (BS_V x
+                   , const uint8_t *in_lo
+                   , const uint8_t *in_hi
+                   , const uint8_t *out_io
+                   , const uint8_t *out_jo)
+{
+  const BS_V m0f = BS_SET1(0x0f);
+  const BS_V inv = BS_TAB(VP_INV);
+
+  BS_V y   = BS_XOR(BS_SHUF(BS_TAB(in_lo), BS_AND(m0f, x)), BS_SHUF(BS_TAB(in_hi), BS_SRL4(BS_ANDNOT(m0f, x))));
+  BS_V i   = BS_SRL4(BS_ANDNOT(m0f, y));
+  BS_V k   = BS_AND(m0f, y);
+  BS_V ak  = BS_SHUF(BS_TAB(VP_AK), k);
+  BS_V j   = BS_XOR(i, k);
+  BS_V iak = BS_XOR(BS_SHUF(inv, i), ak);
+  BS_V jak = BS_XOR(BS_SHUF(inv, j), ak);
+  BS_V io  = BS_XOR(BS_SHUF(inv, iak), j);
+  BS_V jo  = BS_XOR(BS_SHUF(inv, jak), i);
+
+  return BS_XOR(BS_SHUF(BS_TAB(out_io), io), BS_SHUF(BS_TAB(out_jo), jo));
+}
+
+#ifndef BS_SB1
+#define BS_SB1(x) BS_XOR(ARIA_BS_NAME(vperm)((x), VP_PHI_LO, VP_PHI_HI, VP_OUT1_IO, VP_OUT1_JO), BS_SET1(0x63))
+#define BS_SB2(x) BS_XOR(ARIA_BS_NAME(vperm)((x), VP_PHI_LO, VP_PHI_HI, VP_OUT2_IO, VP_OUT2_JO), BS_SET1(0xe2))
+#define BS_SB3(x) ARIA_BS_NAME(vperm)((x), VP_IN3_LO, VP_IN3_HI, VP_INV_IO, VP_INV_JO)
+#define BS_SB4(x) ARIA_BS_NAME(vperm)((x), VP_IN4_LO, VP_IN4_HI, VP_INV_IO, VP_INV_JO)
+#endif
+
+/* 16x16 byte transpose within each 128-bit lane; it is its own inverse */
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(transpose) (BS_V s[16])
+{
+  BS_V t[16];
+
+  for (int pass = 0; pass < 4; pass++)
+  {
+    for (int m = 0; m < 8; m++)
+    {
+      t[2 * m]     = BS_UNPACKLO8(s[m], s[m + 8]);
+      t[2 * m + 1] = BS_UNPACKHI8(s[m], s[m + 8]);
+    }
+    for (int m = 0; m < 16; m++)
+    {
+      s[m] = t[m];
+    }
+  }
+}
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(add_key) (BS_V s[16], const aria_u128_t *rk)
+{
+  const BS_V k = BS_KEY(rk);
+
+  for (int m = 0; m < 16; m++)
+  {
+    s[m] = BS_XOR(s[m], BS_SHUF(k, BS_SET1(m)));
+  }
+}
+
+/* Each block its own round key: the keys are gathered into an array laid
+** out as the blocks are, and sliced the same way
+*/
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(add_lane_keys) (BS_V s[16], const aria_key_schedule_t *const *lanes, uint32_t i)
+{
+  aria_u128_t rk[ARIA_BS_BLOCKS];
+  BS_V k[16];
+
+  for (uint32_t b = 0u; b < ARIA_BS_BLOCKS; b++)
+  {
+    rk[b] = lanes[b]->ek[i];
+  }
+  for (int m = 0; m < 16; m++)
+  {
+    k[m] = BS_LOAD((const uint8_t *)rk, m);
+  }
+  ARIA_BS_NAME(transpose)(k);
+  for (int m = 0; m < 16; m++)
+  {
+    s[m] = BS_XOR(s[m], k[m]);
+  }
+}
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(key) (BS_V s[16], const aria_key_schedule_t *ks, const aria_key_schedule_t *const *lanes, uint32_t i)
+{
+  if (NULL == lanes)
+  {
+    ARIA_BS_NAME(add_key)(s, &ks->ek[i]);
+  }
+  else
+  {
+    ARIA_BS_NAME(add_lane_keys)(s, lanes, i);
+  }
+}
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(SL1) (BS_V s[16])
+{
+  for (int b = 0; b < 16; b += 4)
+  {
+    BS_X(s, b    ) = BS_SB1(BS_X(s, b    ));
+    BS_X(s, b + 1) = BS_SB2(BS_X(s, b + 1));
+    BS_X(s, b + 2) = BS_SB3(BS_X(s, b + 2));
+    BS_X(s, b + 3) = BS_SB4(BS_X(s, b + 3));
+  }
+}
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(SL2) (BS_V s[16])
+{
+  for (int b = 0; b < 16; b += 4)
+  {
+    BS_X(s, b    ) = BS_SB3(BS_X(s, b    ));
+    BS_X(s, b + 1) = BS_SB4(BS_X(s, b + 1));
+    BS_X(s, b + 2) = BS_SB1(BS_X(s, b + 2));
+    BS_X(s, b + 3) = BS_SB2(BS_X(s, b + 3));
+  }
+}
+
+/* Diffusion layer A, with the same common subexpressions as aria_A */
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(A) (BS_V s[16])
+{
+  BS_V x[16];
+
+  for (int b = 0; b < 16; b++)
+  {
+    x[b] = BS_X(s, b);
+  }
+
+  BS_V t0 = BS_XOR(BS_XOR(x[0], x[7]), BS_XOR(x[10], x[13]));
+  BS_V t1 = BS_XOR(BS_XOR(x[1], x[6]), BS_XOR(x[11], x[12]));
+  BS_V t2 = BS_XOR(BS_XOR(x[2], x[5]), BS_XOR(x[8],  x[15]));
+  BS_V t3 = BS_XOR(BS_XOR(x[3], x[4]), BS_XOR(x[9],  x[14]));
+
+  BS_X(s,  0) = BS_XOR(BS_XOR(t3, x[6]), BS_XOR(x[8],  x[13]));
+  BS_X(s,  1) = BS_XOR(BS_XOR(t2, x[7]), BS_XOR(x[9],  x[12]));
+  BS_X(s,  2) = BS_XOR(BS_XOR(t1, x[4]), BS_XOR(x[10], x[15]));
+  BS_X(s,  3) = BS_XOR(BS_XOR(t0, x[5]), BS_XOR(x[11], x[14]));
+  BS_X(s,  4) = BS_XOR(BS_XOR(t2, x[0]), BS_XOR(x[11], x[14]));
+  BS_X(s,  5) = BS_XOR(BS_XOR(t3, x[1]), BS_XOR(x[10], x[15]));
+  BS_X(s,  6) = BS_XOR(BS_XOR(t0, x[2]), BS_XOR(x[9],  x[12]));
+  BS_X(s,  7) = BS_XOR(BS_XOR(t1, x[3]), BS_XOR(x[8],  x[13]));
+  BS_X(s,  8) = BS_XOR(BS_XOR(t0, x[1]), BS_XOR(x[4],  x[15]));
+  BS_X(s,  9) = BS_XOR(BS_XOR(t1, x[0]), BS_XOR(x[5],  x[14]));
+  BS_X(s, 10) = BS_XOR(BS_XOR(t2, x[3]), BS_XOR(x[6],  x[13]));
+  BS_X(s, 11) = BS_XOR(BS_XOR(t3, x[2]), BS_XOR(x[7],  x[12]));
+  BS_X(s, 12) = BS_XOR(BS_XOR(t1, x[2]), BS_XOR(x[7],  x[9]));
+  BS_X(s, 13) = BS_XOR(BS_XOR(t0, x[3]), BS_XOR(x[6],  x[8]));
+  BS_X(s, 14) = BS_XOR(BS_XOR(t3, x[0]), BS_XOR(x[5],  x[11]));
+  BS_X(s, 15) = BS_XOR(BS_XOR(t2, x[1]), BS_XOR(x[4],  x[10]));
+}
+
+/* One pass over ARIA_BS_BLOCKS blocks at in and out, as aria_u128_t if be is
+** 0, else in byte order; with lanes, block b under the schedule lanes[b],
+** all of them with the round count of ks
+*/
+
+static inline ARIA_BS_TARGET void
+ARIA_BS_NAME(crypt) (const aria_key_schedule_t *ks
+                   , const aria_key_schedule_t *const *lanes
+                   , const uint8_t *in
+                   , uint8_t       *out
+                   , int            be)
+{
+  const BS_V swap = BS_TAB(BS_BSWAP64);
+  BS_V s[16];
+
+  for (int m = 0; m < 16; m++)
+  {
+    s[m] = BS_LOAD(in, m);
+    if (be)
+    {
+      s[m] = BS_SHUF(s[m], swap);
+    }
+  }
+  ARIA_BS_NAME(transpose)(s);
+
+  for (uint32_t i = 1u; i < ks->rounds; i++)
+  {
+    ARIA_BS_NAME(key)(s, ks, lanes, i);
+    if (0u != (i & 1u))
+    {
+      ARIA_BS_NAME(SL1)(s);
+    }
+    else
+    {
+      ARIA_BS_NAME(SL2)(s);
+    }
+    ARIA_BS_NAME(A)(s);
+  }
+  ARIA_BS_NAME(key)(s, ks, lanes, ks->rounds);
+  ARIA_BS_NAME(SL2)(s);
+  ARIA_BS_NAME(key)(s, ks, lanes, ks->rounds + 1u);
+
+  ARIA_BS_NAME(transpose)(s);
+  for (int m = 0; m < 16; m++)
+  {
+    if (be)
+    {
+      s[m] = BS_SHUF(s[m], swap);
+    }
+    BS_STORE(out, m, s[m]);
+  }
+}
+
+size_t
+ARIA_BS_NAME(crypt_blocks) (const aria_key_schedule_t *ks
+                          , const aria_u128_t *in
+                          , aria_u128_t       *out
+                          , size_t             count)
+{
+  size_t done = 0u;
+
+  for (; (count - done) >= ARIA_BS_BLOCKS; done += ARIA_BS_BLOCKS)
+  {
+    ARIA_BS_NAME(crypt)(ks, NULL, (const uint8_t *)&in[done], (uint8_t *)&out[done], 0);
+  }
+  return done;
+}
+
+size_t
+ARIA_BS_NAME(crypt_bytes) (const aria_key_schedule_t *ks
+                         , const uint8_t *in
+                         , uint8_t       *out
+                         , size_t         count)
+{
+  size_t done = 0u;
+
+  for (; (count - done) >= ARIA_BS_BLOCKS; done += ARIA_BS_BLOCKS)
+  {
+    ARIA_BS_NAME(crypt)(ks, NULL, &in[16u * done], &out[16u * done], 1);
+  }
+  return done;
+}
+
+size_t
+ARIA_BS_NAME(crypt_lanes) (const aria_key_schedule_t *const *ks
+                         , const aria_u128_t *in
+                         , aria_u128_t       *out
+                         , size_t             count)
+{
+  size_t done = 0u;
+
+  for (; (count - done) >= ARIA_BS_BLOCKS; done += ARIA_BS_BLOCKS)
+  {
+    ARIA_BS_NAME(crypt)(ks[done], &ks[done], (const uint8_t *)&in[done], (uint8_t *)&out[done], 0);
+  }
+  return done;
+}
+
+#undef BS_X
+#undef BS_SB1
+#undef BS_SB2
+#undef BS_SB3
+#undef BS_SB4
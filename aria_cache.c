@@ -0,0 +1,265 @@
+/* aria_cache.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* Key schedule cache
+**
+** A fixed array of entries, each holding the encrypt and decrypt schedules
+** of one master key, found through a chained hash table of entry indexes.
+** Replacement is CLOCK: a hit sets the entry's referenced flag; to make
+** room, the hand sweeps the entries, clearing referenced flags, and evicts
+** the first entry found without one. That approximates LRU with no list to
+** update on a hit.
+**
+** One mutex covers the cache. Schedules are copied out under it, so an
+** entry can be evicted as soon as the lock is released. On a miss the
+** schedules are computed with the lock released, then inserted, unless
+** another thread got there first.
+*/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "aria.h"
+#include "aria_stats.h"
+
+#define ARIA_CACHE_NONE 0xffffffffu
+
+typedef struct aria_key_cache_entry_s
+{
+  aria_key_schedule_t enc;
+  aria_key_schedule_t dec;
+  aria_u128_t         left;
+  aria_u128_t         right;
+  uint32_t            bits;
+  uint32_t            next;       /* the next entry in the bucket, or ARIA_CACHE_NONE */
+  int                 used;
+  int                 referenced;
+} aria_key_cache_entry_t;
+
+struct aria_key_cache_s
+{
+  pthread_mutex_t         lock;
+  aria_key_cache_stats_t  stats;
+  uint32_t                capacity;
+  uint32_t                hand;
+  uint32_t                mask;      /* buckets - 1 */
+  uint32_t               *bucket;
+  aria_key_cache_entry_t *entry;
+};
+
+static uint32_t
+aria_key_cache_hash (const aria_key_cache_t *cache, aria_u128_t left, aria_u128_t right, uint32_t bits)
+{
+  uint64_t h = left.left ^ (left.right * 0x9e3779b97f4a7c15u) ^ (right.left * 0xc2b2ae3d27d4eb4fu) ^ right.right ^ bits;
+
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdu;
+  h ^= h >> 33;
+  return (uint32_t )h & cache->mask;
+}
+
+/* The key as its schedule sees it: bits of KeyRight past the key size unused */
+
+static aria_u128_t
+aria_key_cache_right (aria_u128_t right, uint32_t bits)
+{
+  if (bits < 256u)
+  {
+    right.right = 0u;
+  }
+  if (bits < 192u)
+  {
+    right.left = 0u;
+  }
+  return right;
+}
+
+static aria_key_cache_entry_t *
+aria_key_cache_find (aria_key_cache_t *cache, uint32_t h, aria_u128_t left, aria_u128_t right, uint32_t bits)
+{
+  for (uint32_t i = cache->bucket[h]; ARIA_CACHE_NONE != i; i = cache->entry[i].next)
+  {
+    aria_key_cache_entry_t *e = &cache->entry[i];
+
+    if ((e->bits == bits)
+        && (e->left.left == left.left) && (e->left.right == left.right)
+        && (e->right.left == right.left) && (e->right.right == right.right))
+    {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+/* Sweep the clock hand to a free or unreferenced entry, evicting it */
+
+static aria_key_cache_entry_t *
+aria_key_cache_victim (aria_key_cache_t *cache)
+{
+  for (;;)
+  {
+    aria_key_cache_entry_t *e = &cache->entry[cache->hand];
+    uint32_t i = cache->hand;
+
+    cache->hand = (cache->hand + 1u) % cache->capacity;
+    if (!e->used)
+    {
+      return e;
+    }
+    if (e->referenced)
+    {
+      e->referenced = 0;
+      continue;
+    }
+
+    uint32_t *link = &cache->bucket[aria_key_cache_hash(cache, e->left, e->right, e->bits)];
+
+    while (*link != i)
+    {
+      link = &cache->entry[*link].next;
+    }
+    *link = e->next;
+    aria_wipe(e, sizeof(*e));
+    cache->stats.evictions++;
+    cache->stats.entries--;
+    return e;
+  }
+}
+
+aria_error_code_t
+aria_key_cache_create (aria_key_cache_t **cache, uint32_t capacity)
+{
+  if ((NULL == cache) || (0u == capacity) || (capacity > (1u << 24)))
+  {
+    return ARG_BAD;
+  }
+  *cache = NULL;
+
+  aria_key_cache_t *c = calloc(1u, sizeof(aria_key_cache_t));
+  uint32_t buckets = 1u;
+
+  while (buckets < capacity)
+  {
+    buckets *= 2u;
+  }
+  if (NULL != c)
+  {
+    c->bucket = malloc(buckets * sizeof(uint32_t));
+    c->entry  = calloc(capacity, sizeof(aria_key_cache_entry_t));
+  }
+  if ((NULL == c) || (NULL == c->bucket) || (NULL == c->entry))
+  {
+    aria_key_cache_destroy(c);
+    return RESOURCE_BAD;
+  }
+  for (uint32_t i = 0u; i < buckets; i++)
+  {
+    c->bucket[i] = ARIA_CACHE_NONE;
+  }
+  c->capacity = capacity;
+  c->mask     = buckets - 1u;
+  (void)pthread_mutex_init(&c->lock, NULL);
+  *cache = c;
+  return NO_ERROR;
+}
+
+void
+aria_key_cache_destroy (aria_key_cache_t *cache)
+{
+  if (NULL == cache)
+  {
+    return;
+  }
+  if (0u != cache->capacity)
+  {
+    aria_wipe(cache->entry, cache->capacity * sizeof(aria_key_cache_entry_t));
+    (void)pthread_mutex_destroy(&cache->lock);
+  }
+  free(cache->entry);
+  free(cache->bucket);
+  free(cache);
+}
+
+aria_error_code_t
+aria_key_cache_get (aria_key_cache_t    *cache
+                  , aria_u128_t          KeyLeft
+                  , aria_u128_t          KeyRight
+                  , uint32_t             key_size_in_bits
+                  , aria_key_schedule_t *enc
+                  , aria_key_schedule_t *dec)
+{
+  if (NULL == cache)
+  {
+    return ARG_BAD;
+  }
+  if ((128u != key_size_in_bits) && (192u != key_size_in_bits) && (256u != key_size_in_bits))
+  {
+    return KEY_SIZE_BAD;
+  }
+  KeyRight = aria_key_cache_right(KeyRight, key_size_in_bits);
+
+  uint32_t h = aria_key_cache_hash(cache, KeyLeft, KeyRight, key_size_in_bits);
+  aria_key_cache_entry_t *e;
+
+  (void)pthread_mutex_lock(&cache->lock);
+  e = aria_key_cache_find(cache, h, KeyLeft, KeyRight, key_size_in_bits);
+  if (NULL != e)
+  {
+    e->referenced = 1;
+    cache->stats.hits++;
+    ARIA_STAT_ADD(cache_hits, 1u);
+  }
+  else
+  {
+    aria_key_cache_entry_t fresh;
+
+    cache->stats.misses++;
+    ARIA_STAT_ADD(cache_misses, 1u);
+    (void)pthread_mutex_unlock(&cache->lock);
+    (void)aria_init_key_schedule(&fresh.enc, KeyLeft, KeyRight, ENCRYPT, key_size_in_bits);
+    (void)aria_key_schedule_to_decrypt(&fresh.enc, &fresh.dec);
+    (void)pthread_mutex_lock(&cache->lock);
+
+    e = aria_key_cache_find(cache, h, KeyLeft, KeyRight, key_size_in_bits);
+    if (NULL == e)
+    {
+      e = aria_key_cache_victim(cache);
+      e->enc        = fresh.enc;
+      e->dec        = fresh.dec;
+      e->left       = KeyLeft;
+      e->right      = KeyRight;
+      e->bits       = key_size_in_bits;
+      e->used       = 1;
+      e->referenced = 0;
+      e->next       = cache->bucket[h];
+      cache->bucket[h] = (uint32_t )(e - cache->entry);
+      cache->stats.entries++;
+    }
+    aria_wipe(&fresh, sizeof(fresh));
+  }
+  if (NULL != enc)
+  {
+    *enc = e->enc;
+  }
+  if (NULL != dec)
+  {
+    *dec = e->dec;
+  }
+  (void)pthread_mutex_unlock(&cache->lock);
+  return NO_ERROR;
+}
+
+void
+aria_key_cache_stats (aria_key_cache_t *cache, aria_key_cache_stats_t *stats)
+{
+  if ((NULL == cache) || (NULL == stats))
+  {
+    return;
+  }
+  (void)pthread_mutex_lock(&cache->lock);
+  *stats = cache->stats;
+  (void)pthread_mutex_unlock(&cache->lock);
+}
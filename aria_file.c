@@ -0,0 +1,514 @@
+/* aria_file.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* ariafile: encrypt or decrypt a file in CTR or GCM mode
+**
+**   ariafile -e|-d [-m ctr|gcm] -k key -n iv [-a aad] [-j threads] [-r] [-v] in out
+**
+** key, iv and aad are hex. The key is 16, 24 or 32 bytes; a CTR iv is the
+** 16-byte initial counter block, a GCM iv up to 64 bytes (12 is usual); aad
+** is up to 256 bytes. GCM output is the ciphertext followed by a 16-byte
+** tag; decryption writes a temporary file beside the output and renames it
+** to the output only once the tag verifies, so a bad tag leaves any
+** existing output file as it was. -j is the worker pool size for CTR (0,
+** the default, means one thread per CPU); GHASH is one dependent chain, so
+** GCM runs on one thread. -v prints the end-to-end throughput.
+**
+** The file is processed in ARIA_FILE_CHUNK byte chunks, double buffered:
+** while the main thread encrypts one chunk, an I/O thread writes the
+** previous one with pwrite() and reads the next with pread(). Inputs of at
+** least ARIA_FILE_MMAP_MIN bytes are mapped instead of read, unless -r, and
+** encrypted straight from the mapping into the output buffer.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+#define _FILE_OFFSET_BITS 64
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "aria.h"
+#include "aria_block.h"
+#include "timer_e.h"
+
+#define ARIA_FILE_CHUNK    (4u << 20) /* 64 pool chunks */
+#define ARIA_FILE_MMAP_MIN (1u << 20)
+
+typedef enum aria_file_state_e
+{
+  BUF_FILLING,  /* the I/O thread is reading into it */
+  BUF_FULL,     /* input ready to encrypt */
+  BUF_CRYPTED   /* output ready to write */
+} aria_file_state_t;
+
+typedef struct aria_file_s
+{
+  pthread_mutex_t      lock;
+  pthread_cond_t       cond;
+  int                  in_fd;
+  int                  out_fd;
+  const uint8_t       *map;      /* the input, when mapped */
+  uint64_t             len;      /* bytes to encrypt or decrypt */
+  uint64_t             chunks;
+  uint8_t             *buf[2];
+  aria_file_state_t    state[2];
+  int                  err;      /* errno of the first failure */
+} aria_file_t;
+
+static size_t
+aria_file_chunk_len (const aria_file_t *f, uint64_t chunk)
+{
+  uint64_t rest = f->len - chunk * ARIA_FILE_CHUNK;
+
+  return (rest < ARIA_FILE_CHUNK) ? (size_t )rest : ARIA_FILE_CHUNK;
+}
+
+static void
+aria_file_set_state (aria_file_t *f, unsigned b, aria_file_state_t state, int err)
+{
+  (void)pthread_mutex_lock(&f->lock);
+  f->state[b] = state;
+  if ((0 != err) && (0 == f->err))
+  {
+    f->err = err;
+  }
+  (void)pthread_cond_broadcast(&f->cond);
+  (void)pthread_mutex_unlock(&f->lock);
+}
+
+/* Wait for buffer b to reach state; returns 0, or the errno of a failure */
+
+static int
+aria_file_wait (aria_file_t *f, unsigned b, aria_file_state_t state)
+{
+  int err;
+
+  (void)pthread_mutex_lock(&f->lock);
+  while ((f->state[b] != state) && (0 == f->err))
+  {
+    (void)pthread_cond_wait(&f->cond, &f->lock);
+  }
+  err = f->err;
+  (void)pthread_mutex_unlock(&f->lock);
+  return err;
+}
+
+static int
+aria_file_pread (int fd, uint8_t *p, size_t len, uint64_t off)
+{
+  while (len > 0u)
+  {
+    ssize_t n = pread(fd, p, len, (off_t )off);
+
+    if (n <= 0)
+    {
+      if ((n < 0) && (EINTR == errno))
+      {
+        continue;
+      }
+      return (0 == n) ? EIO : errno; /* the file shrank */
+    }
+    p   += n;
+    off += (uint64_t )n;
+    len -= (size_t )n;
+  }
+  return 0;
+}
+
+static int
+aria_file_pwrite (int fd, const uint8_t *p, size_t len, uint64_t off)
+{
+  while (len > 0u)
+  {
+    ssize_t n = pwrite(fd, p, len, (off_t )off);
+
+    if (n < 0)
+    {
+      if (EINTR == errno)
+      {
+        continue;
+      }
+      return errno;
+    }
+    p   += n;
+    off += (uint64_t )n;
+    len -= (size_t )n;
+  }
+  return 0;
+}
+
+static void
+aria_file_fill (aria_file_t *f, uint64_t chunk)
+{
+  unsigned b = (unsigned )(chunk & 1u);
+  int err = 0;
+
+  if (NULL == f->map)
+  {
+    err = aria_file_pread(f->in_fd, f->buf[b], aria_file_chunk_len(f, chunk), chunk * ARIA_FILE_CHUNK);
+  }
+  aria_file_set_state(f, b, BUF_FULL, err);
+}
+
+static void *
+aria_file_io (void *arg)
+{
+  aria_file_t *f = arg;
+
+  for (uint64_t i = 0u; (i < 2u) && (i < f->chunks); i++)
+  {
+    aria_file_fill(f, i);
+  }
+  for (uint64_t i = 0u; i < f->chunks; i++)
+  {
+    unsigned b = (unsigned )(i & 1u);
+
+    if (0 != aria_file_wait(f, b, BUF_CRYPTED))
+    {
+      break;
+    }
+    int err = aria_file_pwrite(f->out_fd, f->buf[b], aria_file_chunk_len(f, i), i * ARIA_FILE_CHUNK);
+
+    if (0 != err)
+    {
+      aria_file_set_state(f, b, BUF_FILLING, err);
+      break;
+    }
+    if ((i + 2u) < f->chunks)
+    {
+      aria_file_set_state(f, b, BUF_FILLING, 0);
+      aria_file_fill(f, i + 2u);
+    }
+  }
+  return NULL;
+}
+
+static size_t
+aria_file_hex (const char *hex, uint8_t *out, size_t max)
+{
+  size_t n = 0u;
+
+  for (; '\0' != *hex; hex += 2)
+  {
+    unsigned b;
+
+    if ((n == max) || ('\0' == hex[1]) || (1 != sscanf(hex, "%2x", &b)))
+    {
+      return 0u;
+    }
+    out[n++] = (uint8_t )b;
+  }
+  return n;
+}
+
+static int
+aria_file_usage (void)
+{
+  fprintf(stderr, "usage: ariafile -e|-d [-m ctr|gcm] -k key -n iv [-a aad] [-j threads] [-r] [-v] in out\n");
+  return 2;
+}
+
+int main (int argc, char **argv)
+{
+  int encrypt = -1;
+  int gcm_mode = 0;
+  int use_read = 0;
+  int verbose = 0;
+  unsigned threads = 0u;
+  uint8_t key[32];
+  uint8_t iv[64];
+  uint8_t aad[256];
+  size_t key_len = 0u;
+  size_t iv_len = 0u;
+  size_t aad_len = 0u;
+  int bad_arg = 0;
+  int opt;
+
+  while (-1 != (opt = getopt(argc, argv, "edm:k:n:a:j:rv")))
+  {
+    switch (opt)
+    {
+      case 'e':
+      case 'd':
+        encrypt = ('e' == opt) ? 1 : 0;
+        break;
+      case 'm':
+        if ((0 != strcmp("ctr", optarg)) && (0 != strcmp("gcm", optarg)))
+        {
+          return aria_file_usage();
+        }
+        gcm_mode = (0 == strcmp("gcm", optarg)) ? 1 : 0;
+        break;
+      case 'k':
+        key_len = aria_file_hex(optarg, key, sizeof(key));
+        break;
+      case 'n':
+        iv_len = aria_file_hex(optarg, iv, sizeof(iv));
+        break;
+      case 'a':
+        aad_len = aria_file_hex(optarg, aad, sizeof(aad));
+        bad_arg |= ('\0' != optarg[0]) && (0u == aad_len); /* not hex, or too long */
+        break;
+      case 'j':
+      {
+        char *end;
+        unsigned long j = strtoul(optarg, &end, 10);
+
+        bad_arg |= ((optarg[0] < '0') || (optarg[0] > '9') || ('\0' != *end) || (j > UINT_MAX));
+        threads = (unsigned )j;
+        break;
+      }
+      case 'r':
+        use_read = 1;
+        break;
+      case 'v':
+        verbose = 1;
+        break;
+      default:
+        return aria_file_usage();
+    }
+  }
+  if (bad_arg || (encrypt < 0) || ((argc - optind) != 2)
+      || ((16u != key_len) && (24u != key_len) && (32u != key_len))
+      || (0u == iv_len) || (!gcm_mode && (16u != iv_len)))
+  {
+    return aria_file_usage();
+  }
+  const char *in_name  = argv[optind];
+  const char *out_name = argv[optind + 1];
+
+  /* the key schedule */
+  uint8_t kb[32] = { 0u };
+  aria_key_schedule_t ks;
+
+  memcpy(kb, key, key_len);
+  (void)aria_init_key_schedule(&ks, aria_load_block(kb), aria_load_block(&kb[16]), ENCRYPT, 8u * (uint32_t )key_len);
+  aria_wipe(kb, sizeof(kb));
+  aria_wipe(key, sizeof(key));
+
+  /* the files */
+  aria_file_t f;
+  struct stat st;
+
+  memset(&f, 0, sizeof(f));
+  f.in_fd = open(in_name, O_RDONLY);
+  if ((f.in_fd < 0) || (0 != fstat(f.in_fd, &st)) || !S_ISREG(st.st_mode))
+  {
+    fprintf(stderr, "ariafile: %s: %s\n", in_name, (f.in_fd < 0) ? strerror(errno) : "not a regular file");
+    return 1;
+  }
+  f.len = (uint64_t )st.st_size;
+  if (gcm_mode && !encrypt)
+  {
+    if (f.len < 16u)
+    {
+      fprintf(stderr, "ariafile: %s: too short for a GCM tag\n", in_name);
+      return 1;
+    }
+    f.len -= 16u;
+  }
+  f.chunks = (f.len + ARIA_FILE_CHUNK - 1u) / ARIA_FILE_CHUNK;
+  if (!use_read && (f.len >= ARIA_FILE_MMAP_MIN))
+  {
+    void *map = mmap(NULL, (size_t )st.st_size, PROT_READ, MAP_PRIVATE, f.in_fd, 0);
+
+    if (MAP_FAILED != map)
+    {
+      (void)posix_madvise(map, (size_t )st.st_size, POSIX_MADV_SEQUENTIAL);
+      f.map = map;
+    }
+  }
+  /* GCM plaintext is unauthenticated until the tag is checked, so it goes to
+  ** a temporary file, renamed to out_name only once the tag verifies
+  */
+  char *tmp_name = NULL;
+
+  if (gcm_mode && !encrypt)
+  {
+    size_t n = strlen(out_name);
+
+    if (NULL == (tmp_name = malloc(n + sizeof(".XXXXXX"))))
+    {
+      fprintf(stderr, "ariafile: out of memory\n");
+      return 1;
+    }
+    memcpy(tmp_name, out_name, n);
+    memcpy(&tmp_name[n], ".XXXXXX", sizeof(".XXXXXX"));
+    f.out_fd = mkstemp(tmp_name);
+    if ((f.out_fd >= 0) && (0 != fchmod(f.out_fd, 0600)))
+    {
+      int e = errno;
+
+      (void)close(f.out_fd);
+      (void)unlink(tmp_name);
+      f.out_fd = -1;
+      errno = e;
+    }
+  }
+  else
+  {
+    f.out_fd = open(out_name, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  }
+
+  const char *write_name = (NULL != tmp_name) ? tmp_name : out_name;
+
+  if (f.out_fd < 0)
+  {
+    fprintf(stderr, "ariafile: %s: %s\n", write_name, strerror(errno));
+    return 1;
+  }
+  for (unsigned b = 0u; b < 2u; b++)
+  {
+    void *p = NULL;
+
+    if (0 != posix_memalign(&p, 4096u, ARIA_FILE_CHUNK))
+    {
+      fprintf(stderr, "ariafile: out of memory\n");
+      (void)unlink(write_name);
+      return 1;
+    }
+    f.buf[b] = p;
+  }
+
+  /* the engine */
+  aria_pool_t *pool = NULL;
+  aria_ctr_t ctr;
+  aria_gcm_t gcm;
+
+  if (gcm_mode)
+  {
+    (void)aria_gcm_init(&gcm, &ks);
+    (void)aria_gcm_start(&gcm, iv, iv_len);
+    (void)aria_gcm_aad(&gcm, aad, aad_len);
+  }
+  else
+  {
+    if (NO_ERROR != aria_pool_create(&pool, threads, 0))
+    {
+      fprintf(stderr, "ariafile: cannot start %u threads\n", threads);
+      (void)unlink(write_name);
+      return 1;
+    }
+    (void)aria_ctr_init(&ctr, aria_load_block(iv));
+  }
+
+  double start = timer_e_nanoseconds();
+  pthread_t io;
+  int err = 0;
+
+  (void)pthread_mutex_init(&f.lock, NULL);
+  (void)pthread_cond_init(&f.cond, NULL);
+  f.state[0] = BUF_FILLING;
+  f.state[1] = BUF_FILLING;
+  if (0 != pthread_create(&io, NULL, aria_file_io, &f))
+  {
+    fprintf(stderr, "ariafile: cannot start the I/O thread\n");
+    (void)unlink(write_name);
+    return 1;
+  }
+  for (uint64_t i = 0u; (i < f.chunks) && (0 == err); i++)
+  {
+    unsigned b = (unsigned )(i & 1u);
+    size_t len = aria_file_chunk_len(&f, i);
+
+    err = aria_file_wait(&f, b, BUF_FULL);
+    if (0 == err)
+    {
+      const uint8_t *in = (NULL != f.map) ? &f.map[i * ARIA_FILE_CHUNK] : f.buf[b];
+      aria_error_code_t e;
+
+      if (gcm_mode)
+      {
+        e = encrypt ? aria_gcm_encrypt(&gcm, in, f.buf[b], len) : aria_gcm_decrypt(&gcm, in, f.buf[b], len);
+      }
+      else
+      {
+        e = aria_pool_ctr_xcrypt(pool, &ks, &ctr, in, f.buf[b], len);
+      }
+      aria_file_set_state(&f, b, BUF_CRYPTED, (NO_ERROR == e) ? 0 : EFBIG);
+    }
+  }
+  (void)pthread_join(io, NULL);
+  err = f.err;
+
+  /* the tag */
+  int tag_bad = 0;
+
+  if (gcm_mode && (0 == err))
+  {
+    uint8_t tag[16];
+
+    if (encrypt)
+    {
+      (void)aria_gcm_finish(&gcm, tag, 16u);
+      err = aria_file_pwrite(f.out_fd, tag, 16u, f.len);
+    }
+    else
+    {
+      if (NULL != f.map)
+      {
+        memcpy(tag, &f.map[f.len], 16u);
+      }
+      else
+      {
+        err = aria_file_pread(f.in_fd, tag, 16u, f.len);
+      }
+      tag_bad = (0 == err) && (NO_ERROR != aria_gcm_check(&gcm, tag, 16u));
+    }
+  }
+  if ((0 != close(f.out_fd)) && (0 == err))
+  {
+    err = errno;
+  }
+  if ((NULL != tmp_name) && (0 == err) && !tag_bad && (0 != rename(tmp_name, out_name)))
+  {
+    err = errno;
+  }
+
+  double secs = (timer_e_nanoseconds() - start) / 1e9;
+
+  if ((0 != err) || tag_bad)
+  {
+    fprintf(stderr, "ariafile: %s\n", tag_bad ? "authentication failed" : strerror(err));
+    (void)unlink(write_name);
+  }
+  else if (verbose)
+  {
+    fprintf(stderr, "ariafile: %" PRIu64 " bytes in %.3f s, %.3f GB/s (%s backend, %u threads, %s)\n"
+                  , f.len
+                  , secs
+                  , (secs > 0.0) ? ((double )f.len / secs / 1e9) : 0.0
+                  , aria_backend_name(aria_get_backend())
+                  , gcm_mode ? 1u : aria_pool_threads(pool)
+                  , (NULL != f.map) ? "mmap" : "pread"
+            );
+  }
+
+  aria_pool_destroy(pool);
+  aria_wipe(&ks, sizeof(ks));
+  if (gcm_mode)
+  {
+    aria_wipe(&gcm, sizeof(gcm));
+  }
+  free(f.buf[0]);
+  free(f.buf[1]);
+  if (NULL != f.map)
+  {
+    (void)munmap((void *)f.map, (size_t )st.st_size);
+  }
+  (void)close(f.in_fd);
+  free(tmp_name);
+  return ((0 != err) || tag_bad) ? 1 : 0;
+}
@@ -0,0 +1,1126 @@
+/* aria_kat.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* ariakat: known answer, Monte Carlo, differential and performance tests
+**
+**   ariakat [-n fuzz cases] [-S seed] [-m outer] [-p baseline [-T percent] [-u]]
+**           [file.rsp ...]
+**
+** Every engine (each supported backend, and oryx: the 32-bit word
+** implementation in oryx/oryx_aria.c, written apart from this library) is
+** run through each set; ariakat prints a line per set and exits 1 if any
+** engine fails one.
+**
+** Known answers: the RFC 5794 Appendix A vectors; then, since the official
+** files are not shipped here, the VarTxt and VarKey sets in the NIST CAVP
+** layout (key 0 and the plaintext, or plaintext 0 and the key, with 1 to
+** all bits set from the left), each key size, against oryx, both
+** directions; then each response file named. These are the CAVP and KISA
+** .rsp / .txt files: KEY, IV (or CTR), PLAINTEXT (or PT) and CIPHERTEXT (or
+** CT) lines in hex, [ENCRYPT] and [DECRYPT] sections, any other line
+** ignored. The mode is from the file name, CBC, CTR or else ECB, and a name
+** with MCT is a Monte Carlo file: each record is then checked for the 1000
+** inner iterations of the AESAVS procedure (section 6.4), from its KEY, IV
+** and first text to its answer. A record with no section is checked in both
+** directions.
+**
+** Monte Carlo: the whole AESAVS procedure, ECB and CBC, each key size and
+** direction, outer rounds of 1000 blocks (-m, default 100) with the key
+** updated from the last two answers each round; every engine must end on
+** the key and answer oryx does.
+**
+** Differential fuzzing: -n cases (default 5000) from seed -S (printed, so a
+** failure can be rerun), each random in key size, keys, length, alignment,
+** in place or not, and call: aria_crypt(), aria_crypt_blocks(),
+** aria_crypt_bytes(), aria_crypt_blocks_lanes() with a mix of keys and
+** directions, aria_ctr_xcrypt() from a counter about to carry, and
+** aria_cbc_decrypt(). The answer is the reference backend's aria_crypt()
+** one block at a time, and every backend must give it.
+**
+** Performance gate: with -p, ECB and CTR over 64 KB, 128 and 256-bit keys,
+** each backend, the best of 11 samples in cycles per byte (see ariabench for
+** the cycle counter), against the baseline file: a line per result of op,
+** backend, key bits and cycles per byte. A result more than -T percent
+** (default 15) over its baseline fails, as does one with no baseline line
+** or a file with no lines to read. If the file does not exist, or with -u,
+** the results are written to it instead. A baseline is of one machine,
+** so is not kept in the tree; make perf keeps it in aria_perf.txt.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "aria.h"
+#include "aria_block.h"
+#include "oryx/oryx_aria.h"
+#include "timer_e.h"
+#include "xorshift_e.h"
+
+/* oryx/oryx_aria.c, in a list of engines */
+#define ARIA_KAT_ORYX ((aria_backend_t )BACKEND_COUNT)
+
+#define ARIA_KAT_MAX_TEXT    4096u   /* bytes of text in a response file record */
+#define ARIA_KAT_MAX_LINE    (2u * ARIA_KAT_MAX_TEXT + 64u)
+#define ARIA_KAT_MCT_INNER   1000u
+#define ARIA_KAT_FUZZ_BLOCKS 200u
+#define ARIA_KAT_FUZZ_KEYS   4u
+#define ARIA_KAT_PERF_BYTES  65536u
+#define ARIA_KAT_PERF_REPS   11u
+#define ARIA_KAT_PERF_MAX    64u     /* baseline lines */
+
+typedef enum aria_kat_mode_e
+{
+  KAT_ECB,
+  KAT_CBC,
+  KAT_CTR
+} aria_kat_mode_t;
+
+static const char *const aria_kat_mode_names[3] = { "ECB", "CBC", "CTR" };
+
+/* One engine with one key, in one direction */
+typedef struct aria_kat_engine_s
+{
+  aria_backend_t      e;
+  aria_key_schedule_t ks;
+  AriaContext         oryx;
+  int                 decrypt;
+} aria_kat_engine_t;
+
+/* A response file record */
+typedef struct aria_kat_record_s
+{
+  uint8_t key[32];
+  uint8_t iv[16];
+  uint8_t pt[ARIA_KAT_MAX_TEXT];
+  uint8_t ct[ARIA_KAT_MAX_TEXT];
+  size_t  key_len;
+  size_t  iv_len;
+  size_t  pt_len;
+  size_t  ct_len;
+} aria_kat_record_t;
+
+/* The engines */
+
+static const char *
+aria_kat_engine_name (aria_backend_t e)
+{
+  return (ARIA_KAT_ORYX == e) ? "oryx" : aria_backend_name(e);
+}
+
+/* key is 32 bytes, zero past bits; for CTR, decrypt is 0 both ways */
+static void
+aria_kat_key (aria_kat_engine_t *g, aria_backend_t e, const uint8_t *key, uint32_t bits, int decrypt)
+{
+  g->e       = e;
+  g->decrypt = decrypt;
+  if (ARIA_KAT_ORYX == e)
+  {
+    (void)ariaInit(&g->oryx, key, bits / 8u);
+  }
+  else
+  {
+    (void)aria_set_backend(e);
+    (void)aria_init_key_schedule(&g->ks, aria_load_block(key), aria_load_block(&key[16])
+                               , decrypt ? DECRYPT : ENCRYPT, bits);
+  }
+}
+
+static void
+aria_kat_wipe (aria_kat_engine_t *g)
+{
+  aria_wipe(g, sizeof(aria_kat_engine_t));
+}
+
+static void
+aria_kat_ecb (aria_kat_engine_t *g, const uint8_t *in, uint8_t *out, size_t len)
+{
+  if (ARIA_KAT_ORYX != g->e)
+  {
+    (void)aria_ecb_crypt(&g->ks, in, out, len);
+    return;
+  }
+  for (size_t j = 0u; j < len; j += 16u)
+  {
+    if (g->decrypt)
+    {
+      ariaDecryptBlock(&g->oryx, &in[j], &out[j]);
+    }
+    else
+    {
+      ariaEncryptBlock(&g->oryx, &in[j], &out[j]);
+    }
+  }
+}
+
+/* CBC over whole blocks; chain is the IV in, the last ciphertext block out */
+static void
+aria_kat_cbc (aria_kat_engine_t *g, uint8_t *chain, const uint8_t *in, uint8_t *out, size_t len)
+{
+  if (ARIA_KAT_ORYX != g->e)
+  {
+    aria_u128_t iv = aria_load_block(chain);
+
+    if (g->decrypt)
+    {
+      (void)aria_cbc_decrypt(&g->ks, &iv, in, out, len);
+    }
+    else
+    {
+      (void)aria_cbc_encrypt(&g->ks, &iv, in, out, len);
+    }
+    aria_store_block(chain, iv);
+    return;
+  }
+  for (size_t j = 0u; j < len; j += 16u)
+  {
+    uint8_t b[16];
+    uint8_t c[16];
+
+    if (g->decrypt)
+    {
+      memcpy(c, &in[j], 16u);
+      ariaDecryptBlock(&g->oryx, c, b);
+      for (unsigned i = 0u; i < 16u; i++)
+      {
+        out[j + i] = b[i] ^ chain[i];
+      }
+      memcpy(chain, c, 16u);
+    }
+    else
+    {
+      for (unsigned i = 0u; i < 16u; i++)
+      {
+        b[i] = in[j + i] ^ chain[i];
+      }
+      ariaEncryptBlock(&g->oryx, b, &out[j]);
+      memcpy(chain, &out[j], 16u);
+    }
+  }
+}
+
+/* CTR from counter block iv, incremented as a 128-bit big endian number */
+static void
+aria_kat_ctr (aria_kat_engine_t *g, const uint8_t *iv, const uint8_t *in, uint8_t *out, size_t len)
+{
+  if (ARIA_KAT_ORYX != g->e)
+  {
+    aria_ctr_t ctr;
+
+    (void)aria_ctr_init(&ctr, aria_load_block(iv));
+    (void)aria_ctr_xcrypt(&g->ks, &ctr, in, out, len);
+    aria_wipe(&ctr, sizeof(ctr));
+    return;
+  }
+
+  uint8_t counter[16];
+  uint8_t stream[16];
+
+  memcpy(counter, iv, 16u);
+  for (size_t j = 0u; j < len; j += 16u)
+  {
+    ariaEncryptBlock(&g->oryx, counter, stream);
+    for (size_t i = 0u; (i < 16u) && ((j + i) < len); i++)
+    {
+      out[j + i] = in[j + i] ^ stream[i];
+    }
+    for (unsigned i = 16u; (i > 0u) && (0u == ++counter[i - 1u]); i--)
+    {
+    }
+  }
+}
+
+/* The AESAVS Monte Carlo inner loop: 1000 blocks from key, iv and the first
+** text in, to the last answer out and the one before it prev
+*/
+static void
+aria_kat_mct_inner (aria_kat_engine_t *g
+                  , aria_kat_mode_t    mode
+                  , const uint8_t     *iv
+                  , const uint8_t     *in
+                  , uint8_t           *out
+                  , uint8_t           *prev)
+{
+  uint8_t x[16];
+  uint8_t y[16];
+  uint8_t chain[16];
+  uint8_t last[16];
+
+  memcpy(x, in, 16u);
+  memcpy(chain, iv, 16u);
+  memcpy(last, iv, 16u);  /* the text of block 1 is the IV */
+  for (uint32_t j = 0u; j < ARIA_KAT_MCT_INNER; j++)
+  {
+    if (KAT_ECB == mode)
+    {
+      aria_kat_ecb(g, x, y, 16u);
+      memcpy(x, y, 16u);
+    }
+    else
+    {
+      aria_kat_cbc(g, chain, x, y, 16u);
+      memcpy(x, last, 16u);
+      memcpy(last, y, 16u);
+    }
+    if ((ARIA_KAT_MCT_INNER - 2u) == j)
+    {
+      memcpy(prev, y, 16u);
+    }
+  }
+  memcpy(out, y, 16u);
+}
+
+/* Known answers */
+
+/* RFC 5794 Appendix A: the key is 00 01 02 ..., the plaintext 00 11 22 ... */
+static const uint8_t aria_kat_rfc_ct[3][16] =
+{
+  { 0xd7, 0x18, 0xfb, 0xd6, 0xab, 0x64, 0x4c, 0x73, 0x9d, 0xa9, 0x5f, 0x3b, 0xe6, 0x45, 0x17, 0x78 },
+  { 0x26, 0x44, 0x9c, 0x18, 0x05, 0xdb, 0xe7, 0xaa, 0x25, 0xa4, 0x68, 0xce, 0x26, 0x3a, 0x9e, 0x79 },
+  { 0xf9, 0x2b, 0xd7, 0xc7, 0x9f, 0xb7, 0x2e, 0x2f, 0x2b, 0x8f, 0x80, 0xc1, 0x97, 0x2d, 0x24, 0xfc }
+};
+
+/* One known answer, ECB, both directions; returns the errors */
+static unsigned
+aria_kat_answer (aria_backend_t e, const uint8_t *key, uint32_t bits, const uint8_t *pt, const uint8_t *ct)
+{
+  aria_kat_engine_t g;
+  uint8_t got[16];
+  unsigned errors = 0u;
+
+  aria_kat_key(&g, e, key, bits, 0);
+  aria_kat_ecb(&g, pt, got, 16u);
+  errors += (0 != memcmp(got, ct, 16u)) ? 1u : 0u;
+  aria_kat_key(&g, e, key, bits, 1);
+  aria_kat_ecb(&g, ct, got, 16u);
+  errors += (0 != memcmp(got, pt, 16u)) ? 1u : 0u;
+  aria_kat_wipe(&g);
+  return errors;
+}
+
+/* The RFC vectors, then VarTxt and VarKey against oryx */
+static unsigned
+aria_kat_known (aria_backend_t e)
+{
+  unsigned errors = 0u;
+
+  for (uint32_t k = 0u; k < 3u; k++)
+  {
+    uint32_t bits = 128u + (64u * k);
+    uint8_t key[32] = { 0u };
+    uint8_t pt[16];
+    uint8_t ct[16];
+
+    for (unsigned i = 0u; i < (bits / 8u); i++)
+    {
+      key[i] = (uint8_t )i;
+    }
+    for (unsigned i = 0u; i < 16u; i++)
+    {
+      pt[i] = (uint8_t )(0x11u * i);
+    }
+    errors += aria_kat_answer(e, key, bits, pt, aria_kat_rfc_ct[k]);
+
+    /* VarTxt, then VarKey: bit i and those before it set */
+    for (uint32_t v = 0u; v < 2u; v++)
+    {
+      for (uint32_t i = 0u; i < ((0u == v) ? 128u : bits); i++)
+      {
+        uint8_t *set = (0u == v) ? pt : key;
+        aria_kat_engine_t g;
+
+        memset(key, 0, sizeof(key));
+        memset(pt, 0, sizeof(pt));
+        for (uint32_t b = 0u; b <= i; b++)
+        {
+          set[b / 8u] |= (uint8_t )(0x80u >> (b % 8u));
+        }
+        aria_kat_key(&g, ARIA_KAT_ORYX, key, bits, 0);
+        aria_kat_ecb(&g, pt, ct, 16u);
+        aria_kat_wipe(&g);
+        errors += aria_kat_answer(e, key, bits, pt, ct);
+      }
+    }
+  }
+  return errors;
+}
+
+/* Parse hex into out, at most max bytes; returns 0 if it is not hex */
+static int
+aria_kat_hex (const char *s, uint8_t *out, size_t max, size_t *len)
+{
+  size_t n = 0u;
+
+  while (isxdigit((unsigned char )s[0]) && isxdigit((unsigned char )s[1]))
+  {
+    unsigned v;
+
+    if ((n == max) || (1 != sscanf(s, "%2x", &v)))
+    {
+      return 0;
+    }
+    out[n++] = (uint8_t )v;
+    s += 2;
+  }
+  while (isspace((unsigned char )*s))
+  {
+    s++;
+  }
+  *len = n;
+  return '\0' == *s;
+}
+
+/* Check one record with every engine; dir is 0 or 1 for a section, -1 for
+** both; returns the number of engines that fail it
+*/
+static unsigned
+aria_kat_check_record (const aria_backend_t    *engines
+                     , size_t                   count
+                     , aria_kat_mode_t          mode
+                     , int                      mct
+                     , int                      dir
+                     , const aria_kat_record_t *r
+                     , const char              *where)
+{
+  static uint8_t got[ARIA_KAT_MAX_TEXT];
+  uint32_t bits = 8u * (uint32_t )r->key_len;
+  unsigned failed = 0u;
+  uint8_t key[32] = { 0u };
+  uint8_t iv[16] = { 0u };
+
+  if (((16u != r->key_len) && (24u != r->key_len) && (32u != r->key_len))
+      || (r->pt_len != r->ct_len) || ((KAT_CTR != mode) && (0u != (r->pt_len % 16u)))
+      || ((KAT_ECB != mode) && (16u != r->iv_len)) || (mct && (16u != r->pt_len)))
+  {
+    fprintf(stderr, "ariakat: %s: bad record\n", where);
+    return 1u;
+  }
+  memcpy(key, r->key, r->key_len);
+  memcpy(iv, r->iv, r->iv_len);
+  for (size_t e = 0u; e < count; e++)
+  {
+    unsigned errors = 0u;
+
+    for (int d = 0; d < 2; d++)
+    {
+      const uint8_t *in   = d ? r->ct : r->pt;
+      const uint8_t *want = d ? r->pt : r->ct;
+      aria_kat_engine_t g;
+      uint8_t chain[16];
+      uint8_t prev[16];
+
+      if ((dir >= 0) && (d != dir))
+      {
+        continue;
+      }
+      aria_kat_key(&g, engines[e], key, bits, d && (KAT_CTR != mode));
+      memcpy(chain, iv, 16u);
+      if (mct)
+      {
+        aria_kat_mct_inner(&g, mode, iv, in, got, prev);
+      }
+      else if (KAT_ECB == mode)
+      {
+        aria_kat_ecb(&g, in, got, r->pt_len);
+      }
+      else if (KAT_CBC == mode)
+      {
+        aria_kat_cbc(&g, chain, in, got, r->pt_len);
+      }
+      else
+      {
+        aria_kat_ctr(&g, iv, in, got, r->pt_len);
+      }
+      aria_kat_wipe(&g);
+      errors += (0 != memcmp(got, want, r->pt_len)) ? 1u : 0u;
+    }
+    if (0u != errors)
+    {
+      fprintf(stderr, "ariakat: %s: %s fail\n", where, aria_kat_engine_name(engines[e]));
+      failed++;
+    }
+  }
+  return failed;
+}
+
+/* A response file; returns the number of failures, *records the records */
+static unsigned
+aria_kat_file (const aria_backend_t *engines, size_t count, const char *path, unsigned *records)
+{
+  static aria_kat_record_t r;
+  static char line[ARIA_KAT_MAX_LINE];
+  const char *base = strrchr(path, '/');
+  char name[256];
+  aria_kat_mode_t mode = KAT_ECB;
+  unsigned failed = 0u;
+  unsigned lineno = 0u;
+  unsigned at = 0u;      /* the line of the record's KEY */
+  int dir = -1;
+  FILE *f = fopen(path, "r");
+
+  if (NULL == f)
+  {
+    fprintf(stderr, "ariakat: cannot open %s\n", path);
+    return 1u;
+  }
+  base = (NULL == base) ? path : (base + 1);
+  for (size_t i = 0u; i < sizeof(name); i++)
+  {
+    name[i] = (char )toupper((unsigned char )base[i]);
+    if ('\0' == base[i])
+    {
+      break;
+    }
+  }
+  name[sizeof(name) - 1u] = '\0';
+  if (NULL != strstr(name, "CBC"))
+  {
+    mode = KAT_CBC;
+  }
+  else if (NULL != strstr(name, "CTR"))
+  {
+    mode = KAT_CTR;
+  }
+
+  int mct = (NULL != strstr(name, "MCT"));
+
+  memset(&r, 0, sizeof(r));
+  for (int more = 1; more; )
+  {
+    char *field = NULL;
+    char *value = NULL;
+
+    more = (NULL != fgets(line, sizeof(line), f));
+    lineno++;
+    if (more)
+    {
+      char *eq = strchr(line, '=');
+
+      field = line;
+      while (isspace((unsigned char )*field))
+      {
+        field++;
+      }
+      if (NULL != eq)
+      {
+        char *end = eq;
+
+        while ((end > field) && isspace((unsigned char )end[-1]))
+        {
+          end--;
+        }
+        *end  = '\0';
+        value = eq + 1;
+        while (isspace((unsigned char )*value))
+        {
+          value++;
+        }
+      }
+    }
+
+    /* a record ends at the next KEY, a section or the end of the file */
+    if ((0u != r.key_len) && (0u != r.pt_len) && (0u != r.ct_len)
+        && (!more || ('[' == *field) || ((NULL != value) && (0 == strcmp("KEY", field)))))
+    {
+      char where[300];
+
+      (void)snprintf(where, sizeof(where), "%s:%u %s%s", path, at, aria_kat_mode_names[mode], mct ? " MCT" : "");
+      failed += (0u != aria_kat_check_record(engines, count, mode, mct, dir, &r, where)) ? 1u : 0u;
+      (*records)++;
+      memset(&r, 0, sizeof(r));
+    }
+    if (!more)
+    {
+      break;
+    }
+    if (0 == strncmp("[ENCRYPT]", field, 9u))
+    {
+      dir = 0;
+    }
+    else if (0 == strncmp("[DECRYPT]", field, 9u))
+    {
+      dir = 1;
+    }
+    else if (NULL != value)
+    {
+      int ok = 1;
+
+      if (0 == strcmp("KEY", field))
+      {
+        memset(&r, 0, sizeof(r));
+        at = lineno;
+        ok = aria_kat_hex(value, r.key, sizeof(r.key), &r.key_len);
+      }
+      else if ((0 == strcmp("IV", field)) || (0 == strcmp("CTR", field)))
+      {
+        ok = aria_kat_hex(value, r.iv, sizeof(r.iv), &r.iv_len);
+      }
+      else if ((0 == strcmp("PLAINTEXT", field)) || (0 == strcmp("PT", field)))
+      {
+        ok = aria_kat_hex(value, r.pt, sizeof(r.pt), &r.pt_len);
+      }
+      else if ((0 == strcmp("CIPHERTEXT", field)) || (0 == strcmp("CT", field)))
+      {
+        ok = aria_kat_hex(value, r.ct, sizeof(r.ct), &r.ct_len);
+      }
+      if (!ok)
+      {
+        fprintf(stderr, "ariakat: %s:%u: bad %s\n", path, lineno, field);
+        failed++;
+      }
+    }
+  }
+  (void)fclose(f);
+  aria_wipe(&r, sizeof(r));
+  return failed;
+}
+
+/* Print a set's result for an engine; returns 1 if it failed */
+static unsigned
+aria_kat_report (aria_backend_t e, const char *set, unsigned errors)
+{
+  if (0u == errors)
+  {
+    fprintf(stderr, "ariakat: %s %s pass\n", aria_kat_engine_name(e), set);
+    return 0u;
+  }
+  fprintf(stderr, "ariakat: %s %s fail: %u errors\n", aria_kat_engine_name(e), set, errors);
+  return 1u;
+}
+
+/* Monte Carlo */
+
+/* The whole AESAVS procedure in one engine; key is 32 bytes and ends as
+** the last key, out the last answer
+*/
+static void
+aria_kat_mct (aria_backend_t e, aria_kat_mode_t mode, int decrypt, uint32_t bits, uint32_t outer, uint8_t *key, uint8_t *out)
+{
+  uint8_t iv[16];
+  uint8_t text[16];
+  uint8_t prev[16];
+
+  for (unsigned i = 0u; i < 16u; i++)
+  {
+    iv[i]   = (uint8_t )(0xa5u ^ i);
+    text[i] = (uint8_t )(0x11u * i);
+  }
+  for (uint32_t i = 0u; i < outer; i++)
+  {
+    aria_kat_engine_t g;
+    uint8_t tail[32];
+
+    aria_kat_key(&g, e, key, bits, decrypt);
+    aria_kat_mct_inner(&g, mode, iv, text, out, prev);
+    aria_kat_wipe(&g);
+
+    /* the key is XORed with the last bits/8 bytes of prev || out */
+    memcpy(tail, prev, 16u);
+    memcpy(&tail[16], out, 16u);
+    for (uint32_t j = 0u; j < (bits / 8u); j++)
+    {
+      key[j] ^= tail[(32u - (bits / 8u)) + j];
+    }
+    if (KAT_ECB == mode)
+    {
+      memcpy(text, out, 16u);
+    }
+    else
+    {
+      memcpy(iv, out, 16u);
+      memcpy(text, prev, 16u);
+    }
+  }
+}
+
+/* Every engine against oryx; returns the number of engines that fail */
+static unsigned
+aria_kat_monte (const aria_backend_t *engines, size_t count, uint32_t outer)
+{
+  unsigned errors[BACKEND_COUNT + 1u] = { 0u };
+  unsigned failed = 0u;
+
+  for (uint32_t k = 0u; k < 3u; k++)
+  {
+    for (int mode = KAT_ECB; mode <= KAT_CBC; mode++)
+    {
+      for (int d = 0; d < 2; d++)
+      {
+        uint32_t bits = 128u + (64u * k);
+        uint8_t  start[32];
+        uint8_t  key[2][32];
+        uint8_t  out[2][16];
+
+        for (unsigned i = 0u; i < 32u; i++)
+        {
+          start[i] = (i < (bits / 8u)) ? (uint8_t )(0x3cu * (i + 1u)) : 0u;
+        }
+        memcpy(key[0], start, 32u);
+        aria_kat_mct(ARIA_KAT_ORYX, (aria_kat_mode_t )mode, d, bits, outer, key[0], out[0]);
+        for (size_t e = 0u; e < count; e++)
+        {
+          if (ARIA_KAT_ORYX == engines[e])
+          {
+            continue;
+          }
+          memcpy(key[1], start, 32u);
+          aria_kat_mct(engines[e], (aria_kat_mode_t )mode, d, bits, outer, key[1], out[1]);
+          if ((0 != memcmp(key[0], key[1], 32u)) || (0 != memcmp(out[0], out[1], 16u)))
+          {
+            fprintf(stderr, "ariakat: %s Monte Carlo %s %" PRIu32 " %s differs from oryx\n", aria_kat_engine_name(engines[e])
+                          , aria_kat_mode_names[mode], bits, d ? "decrypt" : "encrypt");
+            errors[e]++;
+          }
+        }
+      }
+    }
+  }
+  for (size_t e = 0u; e < count; e++)
+  {
+    if (ARIA_KAT_ORYX != engines[e])
+    {
+      failed += aria_kat_report(engines[e], "Monte Carlo", errors[e]);
+    }
+  }
+  return failed;
+}
+
+/* Differential fuzzing */
+
+static void
+aria_kat_fuzz_bytes (uint8_t *p, size_t len)
+{
+  for (size_t i = 0u; i < len; i++)
+  {
+    p[i] = (uint8_t )xorshift128plus_next();
+  }
+}
+
+typedef enum aria_kat_call_e
+{
+  CALL_CRYPT,
+  CALL_BLOCKS,
+  CALL_BYTES,
+  CALL_LANES,
+  CALL_CTR,
+  CALL_CBC,
+  CALL_COUNT
+} aria_kat_call_t;
+
+static const char *const aria_kat_call_names[CALL_COUNT] =
+{
+  "aria_crypt", "aria_crypt_blocks", "aria_crypt_bytes", "aria_crypt_blocks_lanes", "aria_ctr_xcrypt", "aria_cbc_decrypt"
+};
+
+/* One case, in the current backend; out is in, or apart from it */
+static void
+aria_kat_fuzz_call (aria_kat_call_t      call
+                  , aria_key_schedule_t *ks
+                  , const aria_key_schedule_t *const *lane
+                  , aria_u128_t          iv
+                  , const uint8_t       *in
+                  , uint8_t             *out
+                  , size_t               len)
+{
+  static aria_u128_t b[2][ARIA_KAT_FUZZ_BLOCKS];
+  aria_u128_t *bo = (in == out) ? b[0] : b[1];
+  size_t n = len / 16u;
+
+  switch (call)
+  {
+    case CALL_CRYPT:
+    case CALL_BLOCKS:
+    case CALL_LANES:
+      for (size_t i = 0u; i < n; i++)
+      {
+        b[0][i] = aria_load_block(&in[16u * i]);
+      }
+      if (CALL_CRYPT == call)
+      {
+        for (size_t i = 0u; i < n; i++)
+        {
+          bo[i] = aria_crypt(ks, b[0][i]);
+        }
+      }
+      else if (CALL_BLOCKS == call)
+      {
+        (void)aria_crypt_blocks(ks, b[0], bo, n);
+      }
+      else
+      {
+        (void)aria_crypt_blocks_lanes(lane, b[0], bo, n);
+      }
+      for (size_t i = 0u; i < n; i++)
+      {
+        aria_store_block(&out[16u * i], bo[i]);
+      }
+      break;
+    case CALL_BYTES:
+      (void)aria_crypt_bytes(ks, in, out, len);
+      break;
+    case CALL_CTR:
+    {
+      aria_ctr_t ctr;
+
+      (void)aria_ctr_init(&ctr, iv);
+      (void)aria_ctr_xcrypt(ks, &ctr, in, out, len);
+      break;
+    }
+    default:
+      (void)aria_cbc_decrypt(ks, &iv, in, out, len);
+      break;
+  }
+}
+
+/* The answer, from the reference backend a block at a time */
+static void
+aria_kat_fuzz_want (aria_kat_call_t      call
+                  , aria_key_schedule_t *ks
+                  , const aria_key_schedule_t *const *lane
+                  , aria_u128_t          iv
+                  , const uint8_t       *in
+                  , uint8_t             *out
+                  , size_t               len)
+{
+  aria_u128_t chain = iv;
+
+  (void)aria_set_backend(BACKEND_REFERENCE);
+  for (size_t j = 0u; j < len; j += 16u)
+  {
+    aria_u128_t x = (CALL_CTR == call) ? iv : aria_load_block(&in[j]);
+    uint8_t y[16];
+
+    x = aria_crypt((CALL_LANES == call) ? (aria_key_schedule_t *)lane[j / 16u] : ks, x);
+    if (CALL_CBC == call)
+    {
+      x = (aria_u128_t ){ x.left ^ chain.left, x.right ^ chain.right };
+      chain = aria_load_block(&in[j]);
+    }
+    aria_store_block(y, x);
+    for (size_t i = 0u; (i < 16u) && ((j + i) < len); i++)
+    {
+      out[j + i] = (CALL_CTR == call) ? (uint8_t )(in[j + i] ^ y[i]) : y[i];
+    }
+    iv.right += 1u;
+    iv.left  += (0u == iv.right) ? 1u : 0u;
+  }
+}
+
+static unsigned
+aria_kat_fuzz (const aria_backend_t *engines, size_t count, uint32_t cases, uint64_t seed)
+{
+  static uint8_t text[16u * ARIA_KAT_FUZZ_BLOCKS + 16u];
+  static uint8_t work[sizeof(text)];
+  static uint8_t want[sizeof(text)];
+  static uint8_t got[sizeof(text) + 16u];
+  static aria_key_schedule_t ks[2u * ARIA_KAT_FUZZ_KEYS];
+  const aria_key_schedule_t *lane[ARIA_KAT_FUZZ_BLOCKS];
+  unsigned errors[BACKEND_COUNT + 1u] = { 0u };
+  unsigned failed = 0u;
+
+  (void)xorshift128plus_seed(seed);
+  for (uint32_t c = 0u; c < cases; c++)
+  {
+    uint64_t r = xorshift128plus_next();
+    aria_kat_call_t call = (aria_kat_call_t )(r % CALL_COUNT);
+    uint32_t bits = 128u + (64u * (uint32_t )((r >> 8) % 3u));
+    size_t   n    = 1u + (size_t )((r >> 16) % ((0u == ((r >> 32) & 3u)) ? 8u : ARIA_KAT_FUZZ_BLOCKS));
+    size_t   len  = 16u * n;
+    size_t   off  = (size_t )((r >> 40) % 16u);
+    int      in_place = (0u != ((r >> 44) & 1u));
+    int      decrypt  = (CALL_CBC == call) || ((CALL_CTR != call) && (0u != ((r >> 45) & 1u)));
+    aria_u128_t iv = { xorshift128plus_next(), ~(uint64_t )((r >> 48) % 64u) }; /* about to carry */
+
+    if (CALL_CTR == call)
+    {
+      len -= (size_t )((r >> 56) % 16u);
+    }
+    for (uint32_t i = 0u; i < ARIA_KAT_FUZZ_KEYS; i++)
+    {
+      aria_u128_t left  = { xorshift128plus_next(), xorshift128plus_next() };
+      aria_u128_t right = { xorshift128plus_next(), xorshift128plus_next() };
+
+      (void)aria_init_key_schedule(&ks[2u * i], left, right, ENCRYPT, bits);
+      (void)aria_init_key_schedule(&ks[(2u * i) + 1u], left, right, DECRYPT, bits);
+    }
+    for (size_t i = 0u; i < n; i++)
+    {
+      lane[i] = &ks[xorshift128plus_next() % (2u * ARIA_KAT_FUZZ_KEYS)];
+    }
+    aria_kat_fuzz_bytes(&text[off], len);
+    aria_kat_fuzz_want(call, &ks[decrypt ? 1u : 0u], lane, iv, &text[off], want, len);
+    for (size_t e = 0u; e < count; e++)
+    {
+      uint8_t *in  = &work[off];
+      uint8_t *out = in_place ? in : &got[(off + 7u) % 16u];
+
+      if (ARIA_KAT_ORYX == engines[e])
+      {
+        continue;
+      }
+      memcpy(in, &text[off], len);
+      (void)aria_set_backend(engines[e]);
+      aria_kat_fuzz_call(call, &ks[decrypt ? 1u : 0u], lane, iv, in, out, len);
+      if ((0 != memcmp(out, want, len)) && (0u == errors[e]++))
+      {
+        fprintf(stderr, "ariakat: %s fuzz case %" PRIu32 " of seed %" PRIu64 ": %s, %" PRIu32 " bits, %zu bytes%s fail\n"
+                      , aria_kat_engine_name(engines[e]), c, seed, aria_kat_call_names[call], bits, len
+                      , in_place ? " in place" : "");
+      }
+    }
+  }
+  for (size_t e = 0u; e < count; e++)
+  {
+    failed += (0u != errors[e]) ? 1u : 0u;
+  }
+  aria_wipe(ks, sizeof(ks));
+  return failed;
+}
+
+/* Performance gate */
+
+typedef struct aria_kat_perf_s
+{
+  char     op[8];
+  char     backend[16];
+  uint32_t bits;
+  double   cpb;
+} aria_kat_perf_t;
+
+/* Cycles per byte of iterations calls */
+static double
+aria_kat_perf_sample (aria_key_schedule_t *ks, int ctr_op, const uint8_t *in, uint8_t *out, uint32_t iterations)
+{
+  aria_ctr_t ctr;
+  uint64_t c = timer_e_cycles();
+
+  for (uint32_t i = 0u; i < iterations; i++)
+  {
+    if (ctr_op)
+    {
+      (void)aria_ctr_init(&ctr, (aria_u128_t ){ 0u, i });
+      (void)aria_ctr_xcrypt(ks, &ctr, in, out, ARIA_KAT_PERF_BYTES);
+    }
+    else
+    {
+      (void)aria_ecb_crypt(ks, in, out, ARIA_KAT_PERF_BYTES);
+    }
+  }
+
+  uint64_t e = timer_e_cycles_end();
+
+  return (double )timer_e_cycles_elapsed(c, e) / ((double )iterations * (double )ARIA_KAT_PERF_BYTES);
+}
+
+static unsigned
+aria_kat_perf (const aria_backend_t *engines, size_t count, const char *path, double percent, int update)
+{
+  static uint8_t in[ARIA_KAT_PERF_BYTES];
+  static uint8_t out[ARIA_KAT_PERF_BYTES];
+  static aria_kat_perf_t base[ARIA_KAT_PERF_MAX];
+  static aria_kat_perf_t now[ARIA_KAT_PERF_MAX];
+  size_t nbase = 0u;
+  size_t nnow  = 0u;
+  unsigned failed = 0u;
+  FILE *f = update ? NULL : fopen(path, "r");
+  int have_baseline = (NULL != f);
+
+  if (have_baseline)
+  {
+    while ((nbase < ARIA_KAT_PERF_MAX)
+           && (4 == fscanf(f, "%7s %15s %" SCNu32 " %lf", base[nbase].op, base[nbase].backend, &base[nbase].bits, &base[nbase].cpb)))
+    {
+      nbase++;
+    }
+    (void)fclose(f);
+    if (0u == nbase)
+    {
+      fprintf(stderr, "ariakat: no perf baseline results read from %s fail\n", path);
+      failed++;
+    }
+  }
+  aria_kat_fuzz_bytes(in, sizeof(in));
+  for (size_t e = 0u; e < count; e++)
+  {
+    if (ARIA_KAT_ORYX == engines[e])
+    {
+      continue;
+    }
+    (void)aria_set_backend(engines[e]);
+    for (uint32_t bits = 128u; bits <= 256u; bits += 128u)
+    {
+      aria_key_schedule_t ks;
+
+      (void)aria_init_key_schedule(&ks, (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() }
+                                 , (aria_u128_t ){ xorshift128plus_next(), xorshift128plus_next() }, ENCRYPT, bits);
+      for (int op = 0; (op < 2) && (nnow < ARIA_KAT_PERF_MAX); op++)
+      {
+        aria_kat_perf_t *p = &now[nnow++];
+        double   once = aria_kat_perf_sample(&ks, op, in, out, 1u);
+        uint32_t n    = 1u + (uint32_t )(2e6 / ((once > 0.0) ? (once * ARIA_KAT_PERF_BYTES) : 1.0)); /* 2M cycles */
+
+        (void)snprintf(p->op, sizeof(p->op), "%s", op ? "ctr" : "ecb");
+        (void)snprintf(p->backend, sizeof(p->backend), "%s", aria_backend_name(engines[e]));
+        p->bits = bits;
+        p->cpb  = aria_kat_perf_sample(&ks, op, in, out, n);
+        for (uint32_t r = 1u; r < ARIA_KAT_PERF_REPS; r++)
+        {
+          double cpb = aria_kat_perf_sample(&ks, op, in, out, n);
+
+          p->cpb = (cpb < p->cpb) ? cpb : p->cpb;
+        }
+        size_t b;
+
+        for (b = 0u; b < nbase; b++)
+        {
+          if ((0 == strcmp(base[b].op, p->op)) && (0 == strcmp(base[b].backend, p->backend)) && (base[b].bits == p->bits))
+          {
+            int slow = (p->cpb > (base[b].cpb * (1.0 + (percent / 100.0))));
+
+            fprintf(stderr, "ariakat: %s perf %s %" PRIu32 ": %.2f cycles/byte, baseline %.2f (%+.1f%%) %s\n"
+                          , p->backend, p->op, p->bits, p->cpb, base[b].cpb
+                          , 100.0 * ((p->cpb / base[b].cpb) - 1.0), slow ? "fail" : "pass");
+            failed += slow ? 1u : 0u;
+            break;
+          }
+        }
+        if (have_baseline && (b == nbase))
+        {
+          fprintf(stderr, "ariakat: %s perf %s %" PRIu32 ": %.2f cycles/byte, no baseline fail\n"
+                        , p->backend, p->op, p->bits, p->cpb);
+          failed++;
+        }
+      }
+      aria_wipe(&ks, sizeof(ks));
+    }
+  }
+  if (!have_baseline)
+  {
+    if (NULL == (f = fopen(path, "w")))
+    {
+      fprintf(stderr, "ariakat: cannot write %s\n", path);
+      return failed + 1u;
+    }
+    for (size_t i = 0u; i < nnow; i++)
+    {
+      fprintf(f, "%s %s %" PRIu32 " %.3f\n", now[i].op, now[i].backend, now[i].bits, now[i].cpb);
+    }
+    (void)fclose(f);
+    fprintf(stderr, "ariakat: perf baseline of %zu results written to %s\n", nnow, path);
+  }
+  (void)aria_set_backend(BACKEND_AUTO);
+  return failed;
+}
+
+static int
+aria_kat_usage (void)
+{
+  fprintf(stderr, "usage: ariakat [-n fuzz cases] [-S seed] [-m outer] [-p baseline [-T percent] [-u]]\n"
+                  "               [file.rsp ...]\n");
+  return 2;
+}
+
+int main (int argc, char **argv)
+{
+  aria_backend_t engines[BACKEND_COUNT + 1u];
+  size_t count = 0u;
+  uint32_t cases = 5000u;
+  uint64_t seed  = 0x5a5a5a5a5a5a5a5au;
+  uint32_t outer = 100u;
+  const char *baseline = NULL;
+  double percent = 15.0;
+  int update = 0;
+  unsigned failed = 0u;
+  int opt;
+
+  while (-1 != (opt = getopt(argc, argv, "n:S:m:p:T:u")))
+  {
+    switch (opt)
+    {
+      case 'n':
+        cases = (uint32_t )strtoul(optarg, NULL, 10);
+        break;
+      case 'S':
+        seed = (uint64_t )strtoull(optarg, NULL, 0);
+        break;
+      case 'm':
+        outer = (uint32_t )strtoul(optarg, NULL, 10);
+        break;
+      case 'p':
+        baseline = optarg;
+        break;
+      case 'T':
+        percent = strtod(optarg, NULL);
+        break;
+      case 'u':
+        update = 1;
+        break;
+      default:
+        return aria_kat_usage();
+    }
+  }
+  if (!(percent >= 0.0) || (update && (NULL == baseline)))
+  {
+    return aria_kat_usage();
+  }
+  for (unsigned b = BACKEND_REFERENCE; b < BACKEND_COUNT; b++)
+  {
+    if (aria_backend_supported((aria_backend_t )b))
+    {
+      engines[count++] = (aria_backend_t )b;
+    }
+  }
+  engines[count++] = ARIA_KAT_ORYX;
+
+  for (size_t e = 0u; e < count; e++)
+  {
+    failed += aria_kat_report(engines[e], "known answers", aria_kat_known(engines[e]));
+  }
+  for (int i = optind; i < argc; i++)
+  {
+    unsigned records = 0u;
+    unsigned bad = aria_kat_file(engines, count, argv[i], &records);
+
+    if ((0u == bad) && (0u != records))
+    {
+      fprintf(stderr, "ariakat: %s: %u records pass\n", argv[i], records);
+    }
+    else
+    {
+      fprintf(stderr, "ariakat: %s fail: %u of %u records\n", argv[i], bad, records);
+      failed++;
+    }
+  }
+  if (0u != outer)
+  {
+    failed += aria_kat_monte(engines, count, outer);
+  }
+  if (0u != cases)
+  {
+    unsigned bad = aria_kat_fuzz(engines, count, cases, seed);
+
+    if (0u == bad)
+    {
+      fprintf(stderr, "ariakat: %" PRIu32 " fuzz cases of seed %" PRIu64 " pass\n", cases, seed);
+    }
+    else
+    {
+      fprintf(stderr, "ariakat: fuzz fail: %u engines\n", bad);
+    }
+    failed += bad;
+  }
+  if (NULL != baseline)
+  {
+    failed += aria_kat_perf(engines, count, baseline, percent, update);
+  }
+  (void)aria_set_backend(BACKEND_AUTO);
+  return (0u == failed) ? 0 : 1;
+}
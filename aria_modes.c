@@ -0,0 +1,1078 @@
+/* aria_modes.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* Block cipher modes of operation over aria_crypt_blocks()
+**
+** The modes work on byte buffers, with blocks in byte order as in
+** aria_block.h.
+*/
+
+#include <string.h>
+#include "aria.h"
+#include "aria_block.h"
+#include "aria_stats.h"
+#include "aria_arm.h"
+#include "aria_x86.h"
+
+/* Blocks per call to aria_crypt_blocks(); the widest SIMD kernels run 32 per
+** pass, so this is two passes. It costs 2 KB of stack for the block arrays.
+*/
+#define ARIA_MODE_BATCH 64u
+
+/* CTR mode (NIST SP 800-38A)
+**
+** The keystream is the encryption of successive counter blocks; the counter
+** is the whole 128-bit block, incremented modulo 2^128. Counter blocks are
+** built and encrypted ARIA_MODE_BATCH at a time, then XORed into the data 64
+** bits at a time. The keystream left over from a partial last block is kept
+** in the aria_ctr_t, so a message may be processed in pieces of any size.
+*/
+
+static inline aria_u128_t
+aria_ctr_next (aria_u128_t *counter)
+{
+  aria_u128_t c = *counter;
+
+  counter->right++;
+  if (0u == counter->right)
+  {
+    counter->left++;
+  }
+  return c;
+}
+
+aria_error_code_t
+aria_ctr_init (aria_ctr_t *ctr, aria_u128_t iv)
+{
+  if (NULL == ctr)
+  {
+    return ARG_BAD;
+  }
+  ctr->counter = iv;
+  ctr->used    = 16u;
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_ctr_xcrypt (aria_key_schedule_t *ks
+               , aria_ctr_t         *ctr
+               , const uint8_t      *in
+               , uint8_t            *out
+               , size_t              len)
+{
+  aria_u128_t stream[ARIA_MODE_BATCH];
+
+  if ((NULL == ks) || (NULL == ctr) || (((NULL == in) || (NULL == out)) && (0u != len)))
+  {
+    return ARG_BAD;
+  }
+  if (ENCRYPT != ks->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  ARIA_STAT_ADD(ctr_bytes, len);
+
+  /* the rest of the last partial block */
+  for (; (ctr->used < 16u) && (len > 0u); len--)
+  {
+    *out++ = *in++ ^ ctr->stream[ctr->used++];
+  }
+
+  while (len >= 16u)
+  {
+    size_t n = len / 16u;
+
+    if (n > ARIA_MODE_BATCH)
+    {
+      n = ARIA_MODE_BATCH;
+    }
+    for (size_t i = 0u; i < n; i++)
+    {
+      stream[i] = aria_ctr_next(&ctr->counter);
+    }
+    (void)aria_crypt_blocks(ks, stream, stream, n);
+    for (size_t i = 0u; i < n; i++)
+    {
+      aria_store_be64(out,     aria_load_be64(in)     ^ stream[i].left);
+      aria_store_be64(out + 8, aria_load_be64(in + 8) ^ stream[i].right);
+      in  += 16;
+      out += 16;
+    }
+    len -= n * 16u;
+  }
+
+  if (len > 0u)
+  {
+    stream[0] = aria_crypt(ks, aria_ctr_next(&ctr->counter));
+    aria_store_block(ctr->stream, stream[0]);
+    for (ctr->used = 0u; len > 0u; len--)
+    {
+      *out++ = *in++ ^ ctr->stream[ctr->used++];
+    }
+  }
+  return NO_ERROR;
+}
+
+/* ECB and CBC modes (NIST SP 800-38A)
+**
+** ECB is aria_crypt_bytes(). CBC decryption has no dependencies between
+** blocks, so it loads ARIA_MODE_BATCH blocks at a time and puts them through
+** the bulk engine together; the loaded ciphertext doubles as the XOR input
+** for the next block and the saved copy for in-place use. CBC encryption is
+** one dependent chain, one block at a time.
+*/
+
+aria_error_code_t
+aria_ecb_crypt (aria_key_schedule_t *ks
+              , const uint8_t      *in
+              , uint8_t            *out
+              , size_t              len)
+{
+  aria_error_code_t err = aria_crypt_bytes(ks, in, out, len);
+
+  if (NO_ERROR == err)
+  {
+    ARIA_STAT_ADD(ecb_bytes, len);
+  }
+  return err;
+}
+
+aria_error_code_t
+aria_cbc_encrypt (aria_key_schedule_t *ks
+                , aria_u128_t        *iv
+                , const uint8_t      *in
+                , uint8_t            *out
+                , size_t              len)
+{
+  if ((NULL == ks) || (NULL == iv) || (((NULL == in) || (NULL == out)) && (0u != len)) || (0u != (len % 16u)))
+  {
+    return ARG_BAD;
+  }
+  if (ENCRYPT != ks->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  ARIA_STAT_ADD(cbc_bytes, len);
+
+  aria_u128_t c = *iv;
+
+  for (; len > 0u; len -= 16u)
+  {
+    aria_u128_t p = aria_load_block(in);
+
+    c = aria_crypt(ks, (aria_u128_t ){ p.left ^ c.left, p.right ^ c.right });
+    aria_store_block(out, c);
+    in  += 16;
+    out += 16;
+  }
+  *iv = c;
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_cbc_decrypt (aria_key_schedule_t *ks
+                , aria_u128_t        *iv
+                , const uint8_t      *in
+                , uint8_t            *out
+                , size_t              len)
+{
+  aria_u128_t c[ARIA_MODE_BATCH + 1u];
+  aria_u128_t p[ARIA_MODE_BATCH];
+
+  if ((NULL == ks) || (NULL == iv) || (((NULL == in) || (NULL == out)) && (0u != len)) || (0u != (len % 16u)))
+  {
+    return ARG_BAD;
+  }
+  if (DECRYPT != ks->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  ARIA_STAT_ADD(cbc_bytes, len);
+  c[0] = *iv;
+  for (size_t n; len > 0u; len -= n * 16u)
+  {
+    n = len / 16u;
+    if (n > ARIA_MODE_BATCH)
+    {
+      n = ARIA_MODE_BATCH;
+    }
+    for (size_t i = 0u; i < n; i++)
+    {
+      c[i + 1u] = aria_load_block(&in[16u * i]);
+    }
+    (void)aria_crypt_blocks(ks, &c[1], p, n);
+    for (size_t i = 0u; i < n; i++)
+    {
+      aria_store_block(&out[16u * i], (aria_u128_t ){ p[i].left ^ c[i].left, p[i].right ^ c[i].right });
+    }
+    c[0] = c[n];
+    in  += n * 16u;
+    out += n * 16u;
+  }
+  *iv = c[0];
+  return NO_ERROR;
+}
+
+/* XTS (IEEE 1619)
+**
+** Each data unit (sector) has its own tweak T = E2(sector), the sector
+** number encrypted with the tweak key, and block j of the sector is
+** E1(P ^ T * alpha^j) ^ T * alpha^j. The tweak is a little-endian 128-bit
+** polynomial, first byte least significant, in the byte order of the
+** block, and multiplication by alpha is a one bit shift with a carry into
+** every byte. The tweaks for a batch are built in eight independent lanes,
+** each stepping by alpha^8, a byte shift, so there is no chain of dependent
+** shifts across the batch; the blocks, XORed with their tweaks, go through
+** the bulk engine ARIA_MODE_BATCH at a time, so a 4 KB sector is four bulk
+** calls. A partial last block takes the tail of the block before it
+** (ciphertext stealing), and those two blocks are done one at a time.
+*/
+
+#define ARIA_XTS_LANES 8u
+
+/* t * alpha; the bytes of each 64-bit half are most significant first, so a
+** byte's top bit carries into the bit 0 of the byte to its right
+*/
+static inline aria_u128_t
+aria_xts_double (aria_u128_t t)
+{
+  const uint64_t lo7 = 0x0101010101010101u;
+  uint64_t cl = (t.left >> 7) & lo7;
+  uint64_t cr = (t.right >> 7) & lo7;
+
+  return (aria_u128_t ){ ((t.left << 1) & ~lo7) ^ (cl >> 8) ^ ((0u - (cr & 1u)) & 0x8700000000000000u)
+                       , ((t.right << 1) & ~lo7) ^ (cr >> 8) ^ ((cl & 1u) << 56) };
+}
+
+/* t * alpha^8: every byte moves one place on, and the last byte comes back
+** times x^128 = x^7 + x^2 + x + 1
+*/
+static inline aria_u128_t
+aria_xts_mul8 (aria_u128_t t)
+{
+  uint64_t c = t.right & 0xffu;
+  uint64_t r = c ^ (c << 1) ^ (c << 2) ^ (c << 7);
+
+  return (aria_u128_t ){ (t.left >> 8) ^ ((r & 0xffu) << 56) ^ ((r >> 8) << 48)
+                       , (t.right >> 8) | (t.left << 56) };
+}
+
+static inline aria_u128_t
+aria_xts_block (aria_key_schedule_t *ks, aria_u128_t t, const uint8_t *in)
+{
+  aria_u128_t b = aria_load_block(in);
+
+  b = aria_crypt(ks, (aria_u128_t ){ b.left ^ t.left, b.right ^ t.right });
+  return (aria_u128_t ){ b.left ^ t.left, b.right ^ t.right };
+}
+
+static aria_error_code_t
+aria_xts_crypt (aria_key_schedule_t *ks
+              , aria_key_schedule_t *tweak_ks
+              , uint64_t             sector
+              , const uint8_t       *in
+              , uint8_t             *out
+              , size_t               len
+              , aria_cryto_mode_t    mode)
+{
+  aria_u128_t lane[ARIA_XTS_LANES];
+  aria_u128_t tweak[ARIA_MODE_BATCH];
+  aria_u128_t b[ARIA_MODE_BATCH];
+  uint8_t     t[16] = { 0u };
+
+  if ((NULL == ks) || (NULL == tweak_ks) || (NULL == in) || (NULL == out) || (len < 16u) || (len > ARIA_XTS_MAX_LEN))
+  {
+    return ARG_BAD;
+  }
+  if ((mode != ks->mode) || (ENCRYPT != tweak_ks->mode))
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  ARIA_STAT_ADD(xts_bytes, len);
+
+  /* the sector number as a little-endian 128-bit integer */
+  for (uint32_t i = 0u; i < 8u; i++)
+  {
+    t[i] = (uint8_t )(sector >> (8u * i));
+  }
+  lane[0] = aria_crypt(tweak_ks, aria_load_block(t));
+  for (uint32_t k = 1u; k < ARIA_XTS_LANES; k++)
+  {
+    lane[k] = aria_xts_double(lane[k - 1u]);
+  }
+
+  size_t     tail = len % 16u;
+  size_t     full = len / 16u - ((0u != tail) ? 1u : 0u); /* blocks before any stolen pair */
+  aria_u128_t next = lane[0];                             /* the tweak for block full */
+
+  for (size_t n; full > 0u; full -= n)
+  {
+    n = (full > ARIA_MODE_BATCH) ? ARIA_MODE_BATCH : full;
+    for (size_t i = 0u; i < n; i += ARIA_XTS_LANES)
+    {
+      for (uint32_t k = 0u; k < ARIA_XTS_LANES; k++)
+      {
+        tweak[i + k] = lane[k];
+        lane[k] = aria_xts_mul8(lane[k]);
+      }
+    }
+    for (size_t i = 0u; i < n; i++)
+    {
+      b[i] = aria_load_block(&in[16u * i]);
+      b[i] = (aria_u128_t ){ b[i].left ^ tweak[i].left, b[i].right ^ tweak[i].right };
+    }
+    (void)aria_crypt_blocks(ks, b, b, n);
+    for (size_t i = 0u; i < n; i++)
+    {
+      aria_store_block(&out[16u * i], (aria_u128_t ){ b[i].left ^ tweak[i].left, b[i].right ^ tweak[i].right });
+    }
+    next = aria_xts_double(tweak[n - 1u]);
+    in  += n * 16u;
+    out += n * 16u;
+  }
+
+  if (0u != tail)
+  {
+    /* the last whole block and the partial one after it; decryption uses
+    ** their tweaks in the other order
+    */
+    aria_u128_t first  = (ENCRYPT == mode) ? next : aria_xts_double(next);
+    aria_u128_t second = (ENCRYPT == mode) ? aria_xts_double(next) : next;
+    uint8_t     c[16];
+
+    aria_store_block(c, aria_xts_block(ks, first, in));
+    memcpy(t, c, 16u);
+    memcpy(t, &in[16], tail);
+    memcpy(&out[16], c, tail);
+    aria_store_block(out, aria_xts_block(ks, second, t));
+    aria_wipe(c, sizeof(c));
+  }
+  aria_wipe(t, sizeof(t));
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_xts_encrypt (aria_key_schedule_t *ks
+                , aria_key_schedule_t *tweak_ks
+                , uint64_t             sector
+                , const uint8_t       *in
+                , uint8_t             *out
+                , size_t               len)
+{
+  return aria_xts_crypt(ks, tweak_ks, sector, in, out, len, ENCRYPT);
+}
+
+aria_error_code_t
+aria_xts_decrypt (aria_key_schedule_t *ks
+                , aria_key_schedule_t *tweak_ks
+                , uint64_t             sector
+                , const uint8_t       *in
+                , uint8_t             *out
+                , size_t               len)
+{
+  return aria_xts_crypt(ks, tweak_ks, sector, in, out, len, DECRYPT);
+}
+
+/* CMAC (NIST SP 800-38B)
+**
+** Each message is one CBC chain, but the chains of different messages are
+** independent, so aria_cmac_batch() runs up to ARIA_MODE_BATCH of them in
+** lockstep: each step XORs the next block of every message in a lane into
+** its chain value, and the whole set goes through the bulk engine together.
+** When a message ends, its lane takes the next message, so messages of
+** ragged lengths keep the lanes full until the last few. The last block of
+** a message is XORed with K1 if it is whole, or padded with 10* and XORed
+** with K2, and the empty message is one padded block.
+*/
+
+/* x * 2 in GF(2^128), big-endian as in SP 800-38B */
+static inline aria_u128_t
+aria_cmac_double (aria_u128_t x)
+{
+  return (aria_u128_t ){ (x.left << 1) | (x.right >> 63)
+                       , (x.right << 1) ^ ((0u - (x.left >> 63)) & 0x87u) };
+}
+
+aria_error_code_t
+aria_cmac_batch (aria_key_schedule_t  *ks
+               , const uint8_t *const *msgs
+               , const size_t         *lens
+               , uint8_t              *tags
+               , size_t                count)
+{
+  aria_u128_t x[ARIA_MODE_BATCH];
+  size_t      msg[ARIA_MODE_BATCH];
+  size_t      off[ARIA_MODE_BATCH];
+  uint8_t     last[ARIA_MODE_BATCH];
+  uint8_t     pad[16];
+  size_t      n = 0u;
+  size_t      next = 0u;
+
+  if ((NULL == ks) || (((NULL == msgs) || (NULL == lens) || (NULL == tags)) && (0u != count)))
+  {
+    return ARG_BAD;
+  }
+  for (size_t m = 0u; m < count; m++)
+  {
+    if ((NULL == msgs[m]) && (0u != lens[m]))
+    {
+      return ARG_BAD;
+    }
+  }
+  if (ENCRYPT != ks->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+
+  aria_u128_t k1 = aria_cmac_double(aria_crypt(ks, (aria_u128_t ){ 0u, 0u }));
+  aria_u128_t k2 = aria_cmac_double(k1);
+
+  for (; (n < ARIA_MODE_BATCH) && (next < count); n++)
+  {
+    msg[n] = next++;
+    off[n] = 0u;
+    x[n]   = (aria_u128_t ){ 0u, 0u };
+  }
+  while (n > 0u)
+  {
+    for (size_t i = 0u; i < n; i++)
+    {
+      const uint8_t *p = &msgs[msg[i]][off[i]];
+      size_t         rest = lens[msg[i]] - off[i];
+      aria_u128_t    b;
+
+      last[i] = (rest <= 16u) ? 1u : 0u;
+      if (0u == last[i])
+      {
+        b = aria_load_block(p);
+      }
+      else if (16u == rest)
+      {
+        b = aria_load_block(p);
+        b = (aria_u128_t ){ b.left ^ k1.left, b.right ^ k1.right };
+      }
+      else
+      {
+        memset(pad, 0, sizeof(pad));
+        if (0u != rest)
+        {
+          memcpy(pad, p, rest);
+        }
+        pad[rest] = 0x80u;
+        b = aria_load_block(pad);
+        b = (aria_u128_t ){ b.left ^ k2.left, b.right ^ k2.right };
+      }
+      x[i] = (aria_u128_t ){ x[i].left ^ b.left, x[i].right ^ b.right };
+    }
+    (void)aria_crypt_blocks(ks, x, x, n);
+
+    /* downwards, so a finished lane can take the already advanced last one */
+    for (size_t i = n; i-- > 0u; )
+    {
+      if (0u == last[i])
+      {
+        off[i] += 16u;
+        continue;
+      }
+      ARIA_STAT_ADD(cmac_bytes, lens[msg[i]]);
+      aria_store_block(&tags[16u * msg[i]], x[i]);
+      if (next < count)
+      {
+        msg[i] = next++;
+        off[i] = 0u;
+        x[i]   = (aria_u128_t ){ 0u, 0u };
+      }
+      else
+      {
+        n--;
+        msg[i] = msg[n];
+        off[i] = off[n];
+        x[i]   = x[n];
+      }
+    }
+  }
+  aria_wipe(&k1, sizeof(k1));
+  aria_wipe(&k2, sizeof(k2));
+  aria_wipe(x, sizeof(x));
+  aria_wipe(pad, sizeof(pad));
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_cmac (aria_key_schedule_t *ks, const uint8_t *msg, size_t len, uint8_t tag[16])
+{
+  return aria_cmac_batch(ks, &msg, &len, tag, 1u);
+}
+
+/* GCM (NIST SP 800-38D), for the ARIA-GCM suites of RFC 6209
+**
+** GHASH multiplies by H = E(0) in GF(2^128). The portable multiply is
+** Shoup's 4-bit table method: gcm->hl, gcm->hh hold i * H for the 16 nibbles
+** i, and each nibble of the input costs a shift, a reduction lookup, and a
+** table lookup. Note that these lookups are indexed by secret data. With
+** PCLMULQDQ, GHASH folds eight blocks at a time using the powers H^1..H^8 in
+** gcm->h, and the tables go unused.
+**
+** Data is processed ARIA_MODE_BATCH blocks at a time: the whole batch of
+** counter blocks goes through the bulk engine, then the whole batch of
+** ciphertext through GHASH, each stage in its own tight loop.
+*/
+
+/* Message bytes allowed per IV, 2^39 - 256 bits */
+#define ARIA_GCM_TEXT_MAX ((((uint64_t )1u) << 36) - 32u)
+
+static const uint64_t aria_ghash_last4[16] =
+{
+  0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+  0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+static void
+aria_ghash_tables (aria_gcm_t *gcm, aria_u128_t h)
+{
+  uint64_t vh = h.left;
+  uint64_t vl = h.right;
+
+  gcm->hh[0] = 0u;
+  gcm->hl[0] = 0u;
+  gcm->hh[8] = vh;
+  gcm->hl[8] = vl;
+  for (unsigned i = 4u; i > 0u; i >>= 1)
+  {
+    uint64_t r = (0u != (vl & 1u)) ? 0xe100000000000000u : 0u;
+
+    vl = (vh << 63) | (vl >> 1);
+    vh = (vh >> 1) ^ r;
+    gcm->hh[i] = vh;
+    gcm->hl[i] = vl;
+  }
+  for (unsigned i = 2u; i <= 8u; i *= 2u)
+  {
+    for (unsigned j = 1u; j < i; j++)
+    {
+      gcm->hh[i + j] = gcm->hh[i] ^ gcm->hh[j];
+      gcm->hl[i + j] = gcm->hl[i] ^ gcm->hl[j];
+    }
+  }
+}
+
+/* x * H with the 4-bit tables */
+
+static aria_u128_t
+aria_ghash_mul (const aria_gcm_t *gcm, aria_u128_t x)
+{
+  uint64_t zh = 0u;
+  uint64_t zl = 0u;
+
+  for (int i = 15; i >= 0; i--)
+  {
+    unsigned b = (unsigned )(((i < 8) ? (x.left >> (56 - 8 * i)) : (x.right >> (120 - 8 * i))) & 0xffu);
+
+    for (int n = 0; n < 2; n++)
+    {
+      unsigned v = (0 == n) ? (b & 0x0fu) : (b >> 4);
+
+      if ((15 != i) || (0 != n))
+      {
+        unsigned rem = (unsigned )(zl & 0x0fu);
+
+        zl = (zh << 60) | (zl >> 4);
+        zh = (zh >> 4) ^ (aria_ghash_last4[rem] << 48);
+      }
+      zh ^= gcm->hh[v];
+      zl ^= gcm->hl[v];
+    }
+  }
+  return (aria_u128_t ){ zh, zl };
+}
+
+/* For each block, x = (x ^ block) * H */
+
+static void
+aria_ghash (aria_gcm_t *gcm, const aria_u128_t *blocks, size_t count)
+{
+#if ARIA_X86
+  if (gcm->pclmul)
+  {
+    aria_x86_pclmul_ghash(&gcm->x, gcm->h, blocks, count);
+    return;
+  }
+#elif ARIA_ARM64
+  if (gcm->pclmul)
+  {
+    aria_arm_pmull_ghash(&gcm->x, gcm->h, blocks, count);
+    return;
+  }
+#endif
+  for (; count > 0u; count--, blocks++)
+  {
+    gcm->x = aria_ghash_mul(gcm, (aria_u128_t ){ gcm->x.left ^ blocks->left, gcm->x.right ^ blocks->right });
+  }
+}
+
+/* Fold one data byte into the pending GHASH block, multiplying when full */
+
+static inline void
+aria_ghash_byte (aria_gcm_t *gcm, uint8_t b)
+{
+  uint32_t j = gcm->used++;
+
+  if (j < 8u)
+  {
+    gcm->x.left  ^= (uint64_t )b << (56u - 8u * j);
+  }
+  else
+  {
+    gcm->x.right ^= (uint64_t )b << (120u - 8u * j);
+  }
+  if (16u == gcm->used)
+  {
+    static const aria_u128_t zero = { 0u, 0u };
+
+    aria_ghash(gcm, &zero, 1u);
+    gcm->used = 0u;
+  }
+}
+
+static void
+aria_ghash_flush (aria_gcm_t *gcm)
+{
+  static const aria_u128_t zero = { 0u, 0u };
+
+  if (0u != gcm->used)
+  {
+    aria_ghash(gcm, &zero, 1u);
+    gcm->used = 0u;
+  }
+}
+
+static inline aria_u128_t
+aria_gcm_inc32 (aria_u128_t *counter)
+{
+  aria_u128_t c = *counter;
+
+  counter->right = (c.right & 0xffffffff00000000u) | (uint32_t )(c.right + 1u);
+  return c;
+}
+
+/* The GHASH engine, apart from the cipher's backend: carry-less multiply if
+** the CPU has it, unless aria_set_ghash() asked for the tables
+*/
+static aria_ghash_t aria_ghash_choice = GHASH_AUTO;
+
+static int
+aria_ghash_clmul_supported (void)
+{
+#if ARIA_X86
+  return aria_x86_has_pclmul();
+#elif ARIA_ARM64
+  return aria_arm_has_pmull();
+#else
+  return 0;
+#endif
+}
+
+aria_error_code_t
+aria_set_ghash (aria_ghash_t ghash)
+{
+  if (((unsigned )ghash >= GHASH_COUNT) || ((GHASH_CLMUL == ghash) && !aria_ghash_clmul_supported()))
+  {
+    return BACKEND_BAD;
+  }
+  aria_ghash_choice = ghash;
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_gcm_init (aria_gcm_t *gcm, aria_key_schedule_t *ks)
+{
+  if ((NULL == gcm) || (NULL == ks))
+  {
+    return ARG_BAD;
+  }
+  if (ENCRYPT != ks->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  memset(gcm, 0, sizeof(*gcm));
+  gcm->ks = ks;
+
+  aria_u128_t h = aria_crypt(ks, (aria_u128_t ){ 0u, 0u });
+
+  aria_ghash_tables(gcm, h);
+  gcm->h[0] = h;
+  for (unsigned i = 1u; i < 8u; i++)
+  {
+    gcm->h[i] = aria_ghash_mul(gcm, gcm->h[i - 1]);
+  }
+  gcm->pclmul = (GHASH_TABLE != aria_ghash_choice) ? aria_ghash_clmul_supported() : 0;
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_gcm_start (aria_gcm_t *gcm, const uint8_t *iv, size_t iv_len)
+{
+  if ((NULL == gcm) || (NULL == gcm->ks) || (NULL == iv) || (0u == iv_len))
+  {
+    return ARG_BAD;
+  }
+  gcm->x        = (aria_u128_t ){ 0u, 0u };
+  gcm->used     = 0u;
+  gcm->text     = 0;
+  gcm->aad_len  = 0u;
+  gcm->text_len = 0u;
+
+  if (12u == iv_len)
+  {
+    gcm->j0 = (aria_u128_t ){ aria_load_be64(iv)
+                            , ((uint64_t )iv[8] << 56) | ((uint64_t )iv[9] << 48)
+                            | ((uint64_t )iv[10] << 40) | ((uint64_t )iv[11] << 32) | 1u };
+  }
+  else
+  {
+    for (size_t i = 0u; i < iv_len; i++)
+    {
+      aria_ghash_byte(gcm, iv[i]);
+    }
+    aria_ghash_flush(gcm);
+
+    aria_u128_t lens = { 0u, (uint64_t )iv_len * 8u };
+
+    aria_ghash(gcm, &lens, 1u);
+    gcm->j0 = gcm->x;
+    gcm->x  = (aria_u128_t ){ 0u, 0u };
+  }
+  gcm->counter = gcm->j0;
+  (void)aria_gcm_inc32(&gcm->counter);
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_gcm_aad (aria_gcm_t *gcm, const uint8_t *aad, size_t len)
+{
+  if ((NULL == gcm) || (NULL == gcm->ks) || ((NULL == aad) && (0u != len)) || gcm->text)
+  {
+    return ARG_BAD;
+  }
+  gcm->aad_len += len;
+  ARIA_STAT_ADD(gcm_aad_bytes, len);
+  for (; (0u != gcm->used) && (len > 0u); len--)
+  {
+    aria_ghash_byte(gcm, *aad++);
+  }
+
+  aria_u128_t blocks[ARIA_MODE_BATCH];
+
+  while (len >= 16u)
+  {
+    size_t n = len / 16u;
+
+    if (n > ARIA_MODE_BATCH)
+    {
+      n = ARIA_MODE_BATCH;
+    }
+    for (size_t i = 0u; i < n; i++)
+    {
+      blocks[i] = aria_load_block(aad);
+      aad += 16;
+    }
+    aria_ghash(gcm, blocks, n);
+    len -= n * 16u;
+  }
+  for (; len > 0u; len--)
+  {
+    aria_ghash_byte(gcm, *aad++);
+  }
+  return NO_ERROR;
+}
+
+/* The first message byte ends the AAD: pad it to a whole block */
+
+static int
+aria_gcm_text (aria_gcm_t *gcm, size_t len)
+{
+  if (!gcm->text)
+  {
+    aria_ghash_flush(gcm);
+    gcm->text = 1;
+  }
+  if ((len > ARIA_GCM_TEXT_MAX) || ((gcm->text_len + len) > ARIA_GCM_TEXT_MAX))
+  {
+    return 0;
+  }
+  gcm->text_len += len;
+  return 1;
+}
+
+static aria_error_code_t
+aria_gcm_xcrypt (aria_gcm_t *gcm, const uint8_t *in, uint8_t *out, size_t len, int decrypt)
+{
+  aria_u128_t stream[ARIA_MODE_BATCH];
+  aria_u128_t blocks[ARIA_MODE_BATCH];
+
+  if ((NULL == gcm) || (NULL == gcm->ks) || (((NULL == in) || (NULL == out)) && (0u != len)))
+  {
+    return ARG_BAD;
+  }
+  if (!aria_gcm_text(gcm, len))
+  {
+    return ARG_BAD;
+  }
+  ARIA_STAT_ADD(gcm_bytes, len);
+
+  /* the rest of the last partial block */
+  for (; (0u != gcm->used) && (len > 0u); len--)
+  {
+    uint8_t c = *in++;
+    uint8_t p = c ^ gcm->stream[gcm->used];
+
+    *out++ = p;
+    aria_ghash_byte(gcm, decrypt ? c : p);
+  }
+
+  while (len >= 16u)
+  {
+    size_t n = len / 16u;
+
+    if (n > ARIA_MODE_BATCH)
+    {
+      n = ARIA_MODE_BATCH;
+    }
+    for (size_t i = 0u; i < n; i++)
+    {
+      stream[i] = aria_gcm_inc32(&gcm->counter);
+    }
+    (void)aria_crypt_blocks(gcm->ks, stream, stream, n);
+    for (size_t i = 0u; i < n; i++)
+    {
+      aria_u128_t d = aria_load_block(in);
+      aria_u128_t e = { d.left ^ stream[i].left, d.right ^ stream[i].right };
+
+      blocks[i] = decrypt ? d : e;
+      aria_store_block(out, e);
+      in  += 16;
+      out += 16;
+    }
+    aria_ghash(gcm, blocks, n);
+    len -= n * 16u;
+  }
+
+  if (len > 0u)
+  {
+    stream[0] = aria_crypt(gcm->ks, aria_gcm_inc32(&gcm->counter));
+    aria_store_block(gcm->stream, stream[0]);
+    for (; len > 0u; len--)
+    {
+      uint8_t c = *in++;
+      uint8_t p = c ^ gcm->stream[gcm->used];
+
+      *out++ = p;
+      aria_ghash_byte(gcm, decrypt ? c : p);
+    }
+  }
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_gcm_encrypt (aria_gcm_t *gcm, const uint8_t *in, uint8_t *out, size_t len)
+{
+  return aria_gcm_xcrypt(gcm, in, out, len, 0);
+}
+
+aria_error_code_t
+aria_gcm_decrypt (aria_gcm_t *gcm, const uint8_t *in, uint8_t *out, size_t len)
+{
+  return aria_gcm_xcrypt(gcm, in, out, len, 1);
+}
+
+aria_error_code_t
+aria_gcm_finish (aria_gcm_t *gcm, uint8_t *tag, size_t tag_len)
+{
+  if ((NULL == gcm) || (NULL == gcm->ks) || (NULL == tag) || (tag_len < 4u) || (tag_len > 16u))
+  {
+    return ARG_BAD;
+  }
+  (void)aria_gcm_text(gcm, 0u);
+  aria_ghash_flush(gcm);
+
+  aria_u128_t lens = { gcm->aad_len * 8u, gcm->text_len * 8u };
+  uint8_t t[16];
+
+  aria_ghash(gcm, &lens, 1u);
+
+  aria_u128_t s = aria_crypt(gcm->ks, gcm->j0);
+
+  aria_store_be64(t,     s.left  ^ gcm->x.left);
+  aria_store_be64(t + 8, s.right ^ gcm->x.right);
+  memcpy(tag, t, tag_len);
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_gcm_check (aria_gcm_t *gcm, const uint8_t *tag, size_t tag_len)
+{
+  uint8_t t[16];
+  uint8_t diff = 0u;
+
+  if (NULL == tag)
+  {
+    return ARG_BAD;
+  }
+  aria_error_code_t err = aria_gcm_finish(gcm, t, tag_len);
+
+  if (NO_ERROR != err)
+  {
+    return err;
+  }
+  for (size_t i = 0u; i < tag_len; i++)
+  {
+    diff |= t[i] ^ tag[i];
+  }
+  return (0u == diff) ? NO_ERROR : TAG_BAD;
+}
+
+/* Scatter/gather
+**
+** The walk hands the mode function the longest piece that lies within one
+** input and one output segment. The modes already carry a partial block
+** from one call to the next, so nothing is copied to make pieces whole
+** blocks.
+*/
+
+typedef aria_error_code_t (*aria_iov_piece_t) (void *ctx, const uint8_t *in, uint8_t *out, size_t len);
+
+static size_t
+aria_iov_total (const aria_iovec_t *iov, size_t count)
+{
+  size_t total = 0u;
+
+  for (size_t i = 0u; i < count; i++)
+  {
+    total += iov[i].len;
+  }
+  return total;
+}
+
+static aria_error_code_t
+aria_iov_walk (aria_iov_piece_t    piece
+             , void               *ctx
+             , const aria_iovec_t *in
+             , size_t              in_count
+             , const aria_iovec_t *out
+             , size_t              out_count)
+{
+  if (((NULL == in) && (0u != in_count)) || ((NULL == out) && (0u != out_count))
+      || (aria_iov_total(in, in_count) != aria_iov_total(out, out_count)))
+  {
+    return ARG_BAD;
+  }
+
+  /* check the other arguments even when there is no data */
+  aria_error_code_t err = piece(ctx, NULL, NULL, 0u);
+  size_t i = 0u;
+  size_t j = 0u;
+  size_t in_off  = 0u;
+  size_t out_off = 0u;
+
+  while ((NO_ERROR == err) && (i < in_count) && (j < out_count))
+  {
+    size_t len = in[i].len - in_off;
+
+    if (len > (out[j].len - out_off))
+    {
+      len = out[j].len - out_off;
+    }
+    if (len > 0u)
+    {
+      err = piece(ctx, (const uint8_t *)in[i].base + in_off, (uint8_t *)out[j].base + out_off, len);
+    }
+    in_off  += len;
+    out_off += len;
+    if (in_off == in[i].len)
+    {
+      i++;
+      in_off = 0u;
+    }
+    if (out_off == out[j].len)
+    {
+      j++;
+      out_off = 0u;
+    }
+  }
+  return err;
+}
+
+typedef struct aria_iov_ctr_s
+{
+  aria_key_schedule_t *ks;
+  aria_ctr_t          *ctr;
+} aria_iov_ctr_t;
+
+static aria_error_code_t
+aria_iov_ctr_piece (void *ctx, const uint8_t *in, uint8_t *out, size_t len)
+{
+  aria_iov_ctr_t *c = ctx;
+
+  return aria_ctr_xcrypt(c->ks, c->ctr, in, out, len);
+}
+
+static aria_error_code_t
+aria_iov_gcm_encrypt_piece (void *ctx, const uint8_t *in, uint8_t *out, size_t len)
+{
+  return aria_gcm_encrypt(ctx, in, out, len);
+}
+
+static aria_error_code_t
+aria_iov_gcm_decrypt_piece (void *ctx, const uint8_t *in, uint8_t *out, size_t len)
+{
+  return aria_gcm_decrypt(ctx, in, out, len);
+}
+
+aria_error_code_t
+aria_ctr_xcrypt_iov (aria_key_schedule_t *ks
+                   , aria_ctr_t          *ctr
+                   , const aria_iovec_t  *in
+                   , size_t               in_count
+                   , const aria_iovec_t  *out
+                   , size_t               out_count)
+{
+  aria_iov_ctr_t c = { ks, ctr };
+
+  return aria_iov_walk(aria_iov_ctr_piece, &c, in, in_count, out, out_count);
+}
+
+aria_error_code_t
+aria_gcm_aad_iov (aria_gcm_t *gcm, const aria_iovec_t *aad, size_t count)
+{
+  aria_error_code_t err = ((NULL == aad) && (0u != count)) ? ARG_BAD : aria_gcm_aad(gcm, NULL, 0u);
+
+  for (size_t i = 0u; (NO_ERROR == err) && (i < count); i++)
+  {
+    err = aria_gcm_aad(gcm, aad[i].base, aad[i].len);
+  }
+  return err;
+}
+
+aria_error_code_t
+aria_gcm_encrypt_iov (aria_gcm_t         *gcm
+                    , const aria_iovec_t *in
+                    , size_t              in_count
+                    , const aria_iovec_t *out
+                    , size_t              out_count)
+{
+  return aria_iov_walk(aria_iov_gcm_encrypt_piece, gcm, in, in_count, out, out_count);
+}
+
+aria_error_code_t
+aria_gcm_decrypt_iov (aria_gcm_t         *gcm
+                    , const aria_iovec_t *in
+                    , size_t              in_count
+                    , const aria_iovec_t *out
+                    , size_t              out_count)
+{
+  return aria_iov_walk(aria_iov_gcm_decrypt_piece, gcm, in, in_count, out, out_count);
+}
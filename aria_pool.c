@@ -0,0 +1,395 @@
+/* aria_pool.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* Worker pool for large buffers
+**
+** A job is a buffer cut into ARIA_POOL_CHUNK byte chunks, small enough to
+** stay in a core's L2 cache. The workers and the calling thread take chunks
+** one at a time until there are none left; each chunk is an independent
+** call to the single threaded mode function, started at the right counter
+** block (CTR) or with the preceding ciphertext block as its IV (CBC). So
+** the only shared state the threads touch is the pool lock, once per chunk.
+**
+** CBC chunk IVs are copied out before any chunk starts, since in place, an
+** earlier chunk overwrites them.
+**
+** aria_pool_run_tasks() hands out the chunks the same way for other modules
+** (the job queue), with the chunk index as the task number.
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for pthread_setaffinity_np */
+#endif
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "aria.h"
+#include "aria_block.h"
+#include "aria_pool.h"
+
+#define ARIA_POOL_CHUNK       65536u
+#define ARIA_POOL_MAX_THREADS 256u
+
+typedef struct aria_pool_job_s aria_pool_job_t;
+
+struct aria_pool_job_s
+{
+  void (*run) (const aria_pool_job_t *job, size_t chunk, const uint8_t *in, uint8_t *out, size_t len);
+  void (*task) (void *arg, size_t i); /* for aria_pool_run_tasks(), with no buffer */
+  void                *arg;
+  aria_key_schedule_t *ks;
+  const uint8_t       *in;
+  uint8_t             *out;
+  size_t               len;
+  size_t               chunks;
+  aria_u128_t          counter; /* CTR: the counter block for in[0] */
+  const aria_u128_t   *ivs;     /* CBC: the IV for each chunk */
+};
+
+struct aria_pool_s
+{
+  pthread_mutex_t        lock;
+  pthread_cond_t         work;    /* a job was posted, or stop */
+  pthread_cond_t         done;    /* a job's last chunk finished */
+  const aria_pool_job_t *job;     /* the current job, or NULL */
+  size_t                 next;    /* its next chunk */
+  size_t                 pending; /* its chunks not yet finished */
+  int                    stop;
+  unsigned               workers;
+  pthread_t              thread[];
+};
+
+/* Run chunks of pool->job until none are left to take; called and returns
+** with the lock held
+*/
+
+static void
+aria_pool_run_chunks (aria_pool_t *pool)
+{
+  while ((NULL != pool->job) && (pool->next < pool->job->chunks))
+  {
+    const aria_pool_job_t *job = pool->job;
+    size_t chunk = pool->next++;
+    size_t off   = chunk * ARIA_POOL_CHUNK;
+    size_t len   = job->len - off;
+
+    (void)pthread_mutex_unlock(&pool->lock);
+    if (NULL != job->task)
+    {
+      job->task(job->arg, chunk);
+    }
+    else
+    {
+      job->run(job, chunk, &job->in[off], &job->out[off], (len < ARIA_POOL_CHUNK) ? len : ARIA_POOL_CHUNK);
+    }
+    (void)pthread_mutex_lock(&pool->lock);
+
+    if (0u == --pool->pending)
+    {
+      (void)pthread_cond_broadcast(&pool->done);
+    }
+  }
+}
+
+static void *
+aria_pool_worker (void *arg)
+{
+  aria_pool_t *pool = arg;
+
+  (void)pthread_mutex_lock(&pool->lock);
+  while (!pool->stop)
+  {
+    aria_pool_run_chunks(pool);
+    if (!pool->stop)
+    {
+      (void)pthread_cond_wait(&pool->work, &pool->lock);
+    }
+  }
+  (void)pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+/* Run a job on the pool and the calling thread, one job at a time */
+
+static void
+aria_pool_run (aria_pool_t *pool, const aria_pool_job_t *job)
+{
+  if (job->chunks <= 1u)
+  {
+    if (NULL != job->task)
+    {
+      job->task(job->arg, 0u);
+    }
+    else
+    {
+      job->run(job, 0u, job->in, job->out, job->len);
+    }
+    return;
+  }
+  (void)pthread_mutex_lock(&pool->lock);
+  while (NULL != pool->job)
+  {
+    (void)pthread_cond_wait(&pool->done, &pool->lock);
+  }
+  pool->job     = job;
+  pool->next    = 0u;
+  pool->pending = job->chunks;
+  (void)pthread_cond_broadcast(&pool->work);
+
+  aria_pool_run_chunks(pool);
+  while (0u != pool->pending)
+  {
+    (void)pthread_cond_wait(&pool->done, &pool->lock);
+  }
+  pool->job = NULL;
+  (void)pthread_cond_broadcast(&pool->done);
+  (void)pthread_mutex_unlock(&pool->lock);
+}
+
+aria_error_code_t
+aria_pool_create (aria_pool_t **pool, unsigned threads, int pin)
+{
+  if (NULL == pool)
+  {
+    return ARG_BAD;
+  }
+  *pool = NULL;
+  if (0u == threads)
+  {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    threads = (n > 0) ? (unsigned )n : 1u;
+  }
+  if (threads > ARIA_POOL_MAX_THREADS)
+  {
+    return ARG_BAD;
+  }
+
+  /* resolve the backend now, rather than in the first job */
+  (void)aria_get_backend();
+
+  aria_pool_t *p = calloc(1u, sizeof(aria_pool_t) + (threads - 1u) * sizeof(pthread_t));
+
+  if (NULL == p)
+  {
+    return RESOURCE_BAD;
+  }
+  (void)pthread_mutex_init(&p->lock, NULL);
+  (void)pthread_cond_init(&p->work, NULL);
+  (void)pthread_cond_init(&p->done, NULL);
+
+  for (; p->workers < (threads - 1u); p->workers++)
+  {
+    if (0 != pthread_create(&p->thread[p->workers], NULL, aria_pool_worker, p))
+    {
+      aria_pool_destroy(p);
+      return RESOURCE_BAD;
+    }
+#ifdef __linux__
+    if (pin)
+    {
+      long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+      cpu_set_t cpus;
+
+      CPU_ZERO(&cpus);
+      CPU_SET((p->workers + 1u) % (unsigned )((ncpu > 0) ? ncpu : 1), &cpus);
+      (void)pthread_setaffinity_np(p->thread[p->workers], sizeof(cpus), &cpus);
+    }
+#else
+    (void)pin;
+#endif
+  }
+  *pool = p;
+  return NO_ERROR;
+}
+
+void
+aria_pool_destroy (aria_pool_t *pool)
+{
+  if (NULL == pool)
+  {
+    return;
+  }
+  (void)pthread_mutex_lock(&pool->lock);
+  pool->stop = 1;
+  (void)pthread_cond_broadcast(&pool->work);
+  (void)pthread_mutex_unlock(&pool->lock);
+
+  for (unsigned i = 0u; i < pool->workers; i++)
+  {
+    (void)pthread_join(pool->thread[i], NULL);
+  }
+  (void)pthread_cond_destroy(&pool->done);
+  (void)pthread_cond_destroy(&pool->work);
+  (void)pthread_mutex_destroy(&pool->lock);
+  free(pool);
+}
+
+unsigned
+aria_pool_threads (const aria_pool_t *pool)
+{
+  return (NULL == pool) ? 0u : (pool->workers + 1u);
+}
+
+static void
+aria_pool_ctr_chunk (const aria_pool_job_t *job, size_t chunk, const uint8_t *in, uint8_t *out, size_t len)
+{
+  uint64_t blocks = (uint64_t )chunk * (ARIA_POOL_CHUNK / 16u);
+  aria_u128_t c   = job->counter;
+  aria_ctr_t ctr;
+
+  c.right += blocks;
+  if (c.right < blocks)
+  {
+    c.left++;
+  }
+  (void)aria_ctr_init(&ctr, c);
+  (void)aria_ctr_xcrypt(job->ks, &ctr, in, out, len);
+}
+
+static void
+aria_pool_ecb_chunk (const aria_pool_job_t *job, size_t chunk, const uint8_t *in, uint8_t *out, size_t len)
+{
+  (void)chunk;
+  (void)aria_ecb_crypt(job->ks, in, out, len);
+}
+
+static void
+aria_pool_cbc_chunk (const aria_pool_job_t *job, size_t chunk, const uint8_t *in, uint8_t *out, size_t len)
+{
+  aria_u128_t iv = job->ivs[chunk];
+
+  (void)aria_cbc_decrypt(job->ks, &iv, in, out, len);
+}
+
+aria_error_code_t
+aria_pool_ctr_xcrypt (aria_pool_t         *pool
+                    , aria_key_schedule_t *ks
+                    , aria_ctr_t          *ctr
+                    , const uint8_t       *in
+                    , uint8_t             *out
+                    , size_t               len)
+{
+  if ((NULL == pool) || (NULL == ks) || (NULL == ctr) || (((NULL == in) || (NULL == out)) && (0u != len)))
+  {
+    return ARG_BAD;
+  }
+  if (ENCRYPT != ks->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+
+  /* the rest of a partial block, then whole blocks on the pool, then the
+  ** tail, leaving the keystream of a partial last block in ctr
+  */
+  size_t head = (16u - ctr->used) % 16u;
+
+  if (head > len)
+  {
+    head = len;
+  }
+  (void)aria_ctr_xcrypt(ks, ctr, in, out, head);
+  in  += head;
+  out += head;
+  len -= head;
+
+  aria_pool_job_t job = { aria_pool_ctr_chunk, NULL, NULL, ks, in, out, len & ~(size_t )15u, 0u, ctr->counter, NULL };
+
+  if (job.len > 0u)
+  {
+    uint64_t blocks = (uint64_t )(job.len / 16u);
+
+    job.chunks = (job.len + ARIA_POOL_CHUNK - 1u) / ARIA_POOL_CHUNK;
+    aria_pool_run(pool, &job);
+    ctr->counter.right += blocks;
+    if (ctr->counter.right < blocks)
+    {
+      ctr->counter.left++;
+    }
+  }
+  return aria_ctr_xcrypt(ks, ctr, &in[job.len], &out[job.len], len - job.len);
+}
+
+aria_error_code_t
+aria_pool_ecb_crypt (aria_pool_t         *pool
+                   , aria_key_schedule_t *ks
+                   , const uint8_t       *in
+                   , uint8_t             *out
+                   , size_t               len)
+{
+  if ((NULL == pool) || (NULL == ks) || (((NULL == in) || (NULL == out)) && (0u != len)) || (0u != (len % 16u)))
+  {
+    return ARG_BAD;
+  }
+  aria_pool_job_t job = { aria_pool_ecb_chunk, NULL, NULL, ks, in, out, len, 0u, { 0u, 0u }, NULL };
+
+  job.chunks = (len + ARIA_POOL_CHUNK - 1u) / ARIA_POOL_CHUNK;
+  aria_pool_run(pool, &job);
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_pool_cbc_decrypt (aria_pool_t         *pool
+                     , aria_key_schedule_t *ks
+                     , aria_u128_t         *iv
+                     , const uint8_t       *in
+                     , uint8_t             *out
+                     , size_t               len)
+{
+  if ((NULL == pool) || (NULL == ks) || (NULL == iv) || (((NULL == in) || (NULL == out)) && (0u != len)) || (0u != (len % 16u)))
+  {
+    return ARG_BAD;
+  }
+  if (DECRYPT != ks->mode)
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  if (0u == len)
+  {
+    return NO_ERROR;
+  }
+  aria_pool_job_t job = { aria_pool_cbc_chunk, NULL, NULL, ks, in, out, len, 0u, { 0u, 0u }, NULL };
+
+  job.chunks = (len + ARIA_POOL_CHUNK - 1u) / ARIA_POOL_CHUNK;
+
+  aria_u128_t *ivs = malloc(job.chunks * sizeof(aria_u128_t));
+
+  if (NULL == ivs)
+  {
+    return RESOURCE_BAD;
+  }
+  ivs[0] = *iv;
+  for (size_t k = 1u; k < job.chunks; k++)
+  {
+    ivs[k] = aria_load_block(&in[k * ARIA_POOL_CHUNK - 16u]);
+  }
+  *iv = aria_load_block(&in[len - 16u]);
+  job.ivs = ivs;
+  aria_pool_run(pool, &job);
+  free(ivs);
+  return NO_ERROR;
+}
+
+void
+aria_pool_run_tasks (aria_pool_t *pool, void (*task) (void *arg, size_t i), void *arg, size_t count)
+{
+  aria_pool_job_t job = { NULL, task, arg, NULL, NULL, NULL, 0u, count, { 0u, 0u }, NULL };
+
+  if (NULL == pool)
+  {
+    for (size_t i = 0u; i < count; i++)
+    {
+      task(arg, i);
+    }
+    return;
+  }
+  if (0u != count)
+  {
+    aria_pool_run(pool, &job);
+  }
+}
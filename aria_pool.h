@@ -0,0 +1,28 @@
+/* aria_pool.h
+**
+** Internal interface between aria_pool.c and the other modules that use
+** the worker pool
+*/
+
+#ifndef ARIA_POOL_H
+#define ARIA_POOL_H
+
+#include "aria.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Call task(arg, i) for i from 0 to count - 1, spread over the pool's
+** threads and the calling thread, and return when all are done; with a NULL
+** pool, in order on the calling thread. Tasks must be independent.
+*/
+void aria_pool_run_tasks (aria_pool_t *pool, void (*task) (void *arg, size_t i), void *arg, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARIA_POOL_H */
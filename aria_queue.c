@@ -0,0 +1,353 @@
+/* aria_queue.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* Job queue
+**
+** A flush sorts the pending jobs in two. A large job, ARIA_QUEUE_DIRECT
+** bytes or more, fills the SIMD kernels on its own, so it goes whole through
+** aria_ecb_crypt() or aria_ctr_xcrypt(). The small jobs are cut into lanes,
+** one block of one job each, and the lanes are sorted by key size, since a
+** pass of a kernel takes one round count; then ARIA_QUEUE_BATCH lanes at a
+** time, whatever their jobs and keys, go through aria_crypt_blocks_lanes().
+** So 64 messages of one block under 64 keys cost two passes of a 32-block
+** kernel rather than 64 single block calls.
+**
+** The work is a list of tasks: one per large job, then one per span of
+** about ARIA_QUEUE_SPAN lanes of one key size, whole jobs each, so a job's
+** status is set by one task. Tasks are independent, so with a pool they are
+** spread over its threads by aria_pool_run_tasks(); the lane and span arrays
+** are built before, and only read by, the tasks.
+**
+** Jobs are kept in submission order in one array: [head, done) finished and
+** not yet polled, [done, count) pending.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "aria.h"
+#include "aria_block.h"
+#include "aria_pool.h"
+
+#define ARIA_QUEUE_DIRECT 1024u  /* bytes: 64 blocks */
+#define ARIA_QUEUE_BATCH  64u    /* lanes per aria_crypt_blocks_lanes() call */
+#define ARIA_QUEUE_SPAN   1024u  /* lanes per task, 16 KB of text */
+#define ARIA_QUEUE_SIZES  3u     /* 12, 14 and 16 rounds */
+
+typedef struct aria_queue_lane_s
+{
+  uint32_t job;    /* index in queue->job */
+  uint32_t block;  /* block of the job */
+} aria_queue_lane_t;
+
+typedef struct aria_queue_span_s
+{
+  size_t start;    /* in queue->lane */
+  size_t count;
+} aria_queue_span_t;
+
+struct aria_queue_s
+{
+  aria_pool_t        *pool;       /* NULL for the calling thread */
+  uint32_t            capacity;
+  uint32_t            head;
+  uint32_t            done;
+  uint32_t            count;
+  aria_job_t        **job;
+  uint32_t           *direct;     /* the large jobs of a flush */
+  uint32_t            ndirect;
+  aria_queue_lane_t  *lane;
+  size_t              lane_cap;
+  aria_queue_span_t  *span;
+  size_t              span_cap;
+};
+
+static inline uint32_t
+aria_queue_size (const aria_key_schedule_t *ks)
+{
+  uint32_t i = (ks->rounds - 12u) / 2u;
+
+  return (i < ARIA_QUEUE_SIZES) ? i : (ARIA_QUEUE_SIZES - 1u);
+}
+
+static void
+aria_queue_run_direct (aria_job_t *job)
+{
+  if (JOB_ECB == job->op)
+  {
+    job->status = aria_ecb_crypt(job->ks, job->in, job->out, job->len);
+  }
+  else
+  {
+    aria_ctr_t ctr;
+
+    (void)aria_ctr_init(&ctr, job->iv);
+    job->status = aria_ctr_xcrypt(job->ks, &ctr, job->in, job->out, job->len);
+    aria_wipe(&ctr, sizeof(ctr));
+  }
+}
+
+static void
+aria_queue_run_lanes (const aria_queue_t *q, const aria_queue_lane_t *lane, size_t count)
+{
+  const aria_key_schedule_t *ks[ARIA_QUEUE_BATCH];
+  aria_u128_t b[ARIA_QUEUE_BATCH];
+
+  for (size_t n; count > 0u; count -= n, lane += n)
+  {
+    n = (count > ARIA_QUEUE_BATCH) ? ARIA_QUEUE_BATCH : count;
+    for (size_t i = 0u; i < n; i++)
+    {
+      const aria_job_t *job = q->job[lane[i].job];
+      uint64_t          k   = lane[i].block;
+
+      ks[i] = job->ks;
+      if (JOB_ECB == job->op)
+      {
+        b[i] = aria_load_block(&job->in[16u * k]);
+      }
+      else
+      {
+        b[i] = (aria_u128_t ){ job->iv.left + (((job->iv.right + k) < k) ? 1u : 0u), job->iv.right + k };
+      }
+    }
+    aria_error_code_t err = aria_crypt_blocks_lanes(ks, b, b, n);
+
+    for (size_t i = 0u; i < n; i++)
+    {
+      aria_job_t *job = q->job[lane[i].job];
+      size_t      off = 16u * (size_t )lane[i].block;
+
+      if (NO_ERROR != err)
+      {
+        job->status = err; /* and its out is left alone */
+      }
+      else if (JOB_ECB == job->op)
+      {
+        aria_store_block(&job->out[off], b[i]);
+      }
+      else
+      {
+        uint8_t stream[16];
+        size_t  len = job->len - off;
+
+        aria_store_block(stream, b[i]);
+        for (size_t j = 0u; j < ((len < 16u) ? len : 16u); j++)
+        {
+          job->out[off + j] = job->in[off + j] ^ stream[j];
+        }
+        aria_wipe(stream, sizeof(stream));
+      }
+    }
+  }
+  aria_wipe(b, sizeof(b));
+}
+
+static void
+aria_queue_task (void *arg, size_t i)
+{
+  aria_queue_t *q = arg;
+
+  if (i < q->ndirect)
+  {
+    aria_queue_run_direct(q->job[q->direct[i]]);
+  }
+  else
+  {
+    const aria_queue_span_t *s = &q->span[i - q->ndirect];
+
+    aria_queue_run_lanes(q, &q->lane[s->start], s->count);
+  }
+}
+
+/* Grow *p to hold at least n elements of size bytes */
+
+static int
+aria_queue_grow (void **p, size_t *cap, size_t n, size_t size)
+{
+  if (n <= *cap)
+  {
+    return 1;
+  }
+
+  void *r = realloc(*p, n * size);
+
+  if (NULL == r)
+  {
+    return 0;
+  }
+  *p   = r;
+  *cap = n;
+  return 1;
+}
+
+aria_error_code_t
+aria_queue_create (aria_queue_t **queue, aria_pool_t *pool, uint32_t capacity)
+{
+  if ((NULL == queue) || (0u == capacity) || (capacity > (1u << 24)))
+  {
+    return ARG_BAD;
+  }
+  *queue = NULL;
+
+  aria_queue_t *q = calloc(1u, sizeof(aria_queue_t));
+
+  if (NULL != q)
+  {
+    q->job    = malloc(capacity * sizeof(aria_job_t *));
+    q->direct = malloc(capacity * sizeof(uint32_t));
+  }
+  if ((NULL == q) || (NULL == q->job) || (NULL == q->direct))
+  {
+    aria_queue_destroy(q);
+    return RESOURCE_BAD;
+  }
+  q->pool     = pool;
+  q->capacity = capacity;
+  *queue = q;
+  return NO_ERROR;
+}
+
+void
+aria_queue_destroy (aria_queue_t *queue)
+{
+  if (NULL == queue)
+  {
+    return;
+  }
+  free(queue->span);
+  free(queue->lane);
+  free(queue->direct);
+  free(queue->job);
+  free(queue);
+}
+
+aria_error_code_t
+aria_queue_submit (aria_queue_t *queue, aria_job_t *job)
+{
+  if ((NULL == queue) || (NULL == job) || (NULL == job->ks)
+      || (((NULL == job->in) || (NULL == job->out)) && (0u != job->len))
+      || ((JOB_ECB != job->op) && (JOB_CTR != job->op))
+      || ((JOB_ECB == job->op) && (0u != (job->len % 16u))))
+  {
+    return ARG_BAD;
+  }
+  if ((12u != job->ks->rounds) && (14u != job->ks->rounds) && (16u != job->ks->rounds))
+  {
+    return KEY_SIZE_BAD;
+  }
+  if ((JOB_CTR == job->op) && (ENCRYPT != job->ks->mode))
+  {
+    return CRYPTO_MODE_BAD;
+  }
+  if ((queue->count == queue->capacity) && (0u != queue->head))
+  {
+    memmove(queue->job, &queue->job[queue->head], (queue->count - queue->head) * sizeof(aria_job_t *));
+    queue->done  -= queue->head;
+    queue->count -= queue->head;
+    queue->head   = 0u;
+  }
+  if (queue->count == queue->capacity)
+  {
+    return RESOURCE_BAD;
+  }
+  job->status = NO_ERROR;
+  queue->job[queue->count++] = job;
+  return NO_ERROR;
+}
+
+aria_error_code_t
+aria_queue_flush (aria_queue_t *queue)
+{
+  size_t lanes[ARIA_QUEUE_SIZES] = { 0u };
+  size_t at[ARIA_QUEUE_SIZES];
+  size_t total = 0u;
+  size_t spans = 0u;
+
+  if (NULL == queue)
+  {
+    return ARG_BAD;
+  }
+
+  /* count, then place, the lanes of the small jobs, by key size */
+  queue->ndirect = 0u;
+  for (uint32_t j = queue->done; j < queue->count; j++)
+  {
+    const aria_job_t *job = queue->job[j];
+
+    if (job->len >= ARIA_QUEUE_DIRECT)
+    {
+      queue->direct[queue->ndirect++] = j;
+    }
+    else
+    {
+      lanes[aria_queue_size(job->ks)] += (job->len + 15u) / 16u;
+    }
+  }
+  for (uint32_t k = 0u; k < ARIA_QUEUE_SIZES; k++)
+  {
+    at[k]  = total;
+    total += lanes[k];
+    spans += (lanes[k] + ARIA_QUEUE_SPAN - 1u) / ARIA_QUEUE_SPAN;
+  }
+  if (!aria_queue_grow((void **)&queue->lane, &queue->lane_cap, total, sizeof(aria_queue_lane_t))
+      || !aria_queue_grow((void **)&queue->span, &queue->span_cap, spans, sizeof(aria_queue_span_t)))
+  {
+    return RESOURCE_BAD;
+  }
+  for (uint32_t j = queue->done; j < queue->count; j++)
+  {
+    const aria_job_t *job = queue->job[j];
+    size_t           *p   = &at[aria_queue_size(job->ks)];
+
+    for (uint32_t b = 0u; (job->len < ARIA_QUEUE_DIRECT) && ((16u * b) < job->len); b++)
+    {
+      queue->lane[(*p)++] = (aria_queue_lane_t ){ j, b };
+    }
+  }
+
+  /* spans of one key size each, of ARIA_QUEUE_SPAN lanes or more to the end
+  ** of a job, so each job is in one task, which alone sets its status
+  */
+  spans = 0u;
+  for (uint32_t k = 0u; k < ARIA_QUEUE_SIZES; k++)
+  {
+    size_t end = at[k]; /* at[k] is now the end of size k */
+
+    for (size_t start = end - lanes[k], stop; start < end; start = stop)
+    {
+      stop = ((end - start) > ARIA_QUEUE_SPAN) ? (start + ARIA_QUEUE_SPAN) : end;
+      while ((stop < end) && (queue->lane[stop].job == queue->lane[stop - 1u].job))
+      {
+        stop++;
+      }
+      queue->span[spans++] = (aria_queue_span_t ){ start, stop - start };
+    }
+  }
+  aria_pool_run_tasks(queue->pool, aria_queue_task, queue, queue->ndirect + spans);
+  queue->done = queue->count;
+  return NO_ERROR;
+}
+
+size_t
+aria_queue_poll (aria_queue_t *queue, aria_job_t **done, size_t max)
+{
+  size_t n = 0u;
+
+  if ((NULL == queue) || (NULL == done))
+  {
+    return 0u;
+  }
+  for (; (n < max) && (queue->head < queue->done); n++)
+  {
+    done[n] = queue->job[queue->head++];
+  }
+  if (queue->head == queue->count)
+  {
+    queue->head = queue->done = queue->count = 0u;
+  }
+  return n;
+}
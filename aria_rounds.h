@@ -0,0 +1,96 @@
+/* aria_rounds.h
+**
+** Scalar round loops for one key size, fully unrolled. This file is included
+** by aria.c once per round count, after defining
+**
+**   ARIA_R_NAME(x)     paste the engine name and round count onto x
+**   ARIA_R_ROUNDS      12, 14 or 16
+**   ARIA_R_FO          the engine's odd round function
+**   ARIA_R_FE          the engine's even round function
+**
+** With the round count a constant, there is no loop counter, and the final
+** round keys are at fixed offsets in ks->ek.
+*/
+
+#define ARIA_R_PAIRS(PAIR) \
+  PAIR(2) PAIR(4) PAIR(6) PAIR(8) PAIR(10) ARIA_R_PAIRS_14(PAIR) ARIA_R_PAIRS_16(PAIR)
+
+#if ARIA_R_ROUNDS >= 14
+#define ARIA_R_PAIRS_14(PAIR) PAIR(12)
+#else
+#define ARIA_R_PAIRS_14(PAIR)
+#endif
+
+#if ARIA_R_ROUNDS >= 16
+#define ARIA_R_PAIRS_16(PAIR) PAIR(14)
+#else
+#define ARIA_R_PAIRS_16(PAIR)
+#endif
+
+static aria_u128_t
+ARIA_R_NAME(crypt) (const aria_key_schedule_t *ks, aria_u128_t text)
+{
+  const aria_u128_t *ek = ks->ek;
+  aria_u128_t p = ARIA_R_FO(text, ek[1]);
+
+#define ARIA_R_PAIR(k) \
+  p = ARIA_R_FE(p, ek[k]); \
+  p = ARIA_R_FO(p, ek[(k) + 1]);
+
+  ARIA_R_PAIRS(ARIA_R_PAIR)
+
+#undef ARIA_R_PAIR
+
+  return xor(aria_SL2(xor(p, ek[ARIA_R_ROUNDS])), ek[ARIA_R_ROUNDS + 1]);
+}
+
+static inline void
+ARIA_R_NAME(crypt_lanes) (const aria_key_schedule_t *ks, const aria_u128_t *in, aria_u128_t *out)
+{
+  const aria_u128_t *ek = ks->ek;
+  aria_u128_t p0 = ARIA_R_FO(in[0], ek[1]);
+  aria_u128_t p1 = ARIA_R_FO(in[1], ek[1]);
+  aria_u128_t p2 = ARIA_R_FO(in[2], ek[1]);
+  aria_u128_t p3 = ARIA_R_FO(in[3], ek[1]);
+
+#define ARIA_R_PAIR(k) \
+  p0 = ARIA_R_FE(p0, ek[k]); \
+  p1 = ARIA_R_FE(p1, ek[k]); \
+  p2 = ARIA_R_FE(p2, ek[k]); \
+  p3 = ARIA_R_FE(p3, ek[k]); \
+  p0 = ARIA_R_FO(p0, ek[(k) + 1]); \
+  p1 = ARIA_R_FO(p1, ek[(k) + 1]); \
+  p2 = ARIA_R_FO(p2, ek[(k) + 1]); \
+  p3 = ARIA_R_FO(p3, ek[(k) + 1]);
+
+  ARIA_R_PAIRS(ARIA_R_PAIR)
+
+#undef ARIA_R_PAIR
+
+  out[0] = xor(aria_SL2(xor(p0, ek[ARIA_R_ROUNDS])), ek[ARIA_R_ROUNDS + 1]);
+  out[1] = xor(aria_SL2(xor(p1, ek[ARIA_R_ROUNDS])), ek[ARIA_R_ROUNDS + 1]);
+  out[2] = xor(aria_SL2(xor(p2, ek[ARIA_R_ROUNDS])), ek[ARIA_R_ROUNDS + 1]);
+  out[3] = xor(aria_SL2(xor(p3, ek[ARIA_R_ROUNDS])), ek[ARIA_R_ROUNDS + 1]);
+}
+
+static void
+ARIA_R_NAME(crypt_blocks) (const aria_key_schedule_t *ks
+                         , const aria_u128_t *in
+                         , aria_u128_t       *out
+                         , size_t             count)
+{
+  for (; count >= ARIA_LANES; count -= ARIA_LANES)
+  {
+    ARIA_R_NAME(crypt_lanes)(ks, in, out);
+    in  += ARIA_LANES;
+    out += ARIA_LANES;
+  }
+  for (; count > 0u; count--)
+  {
+    *out++ = ARIA_R_NAME(crypt)(ks, *in++);
+  }
+}
+
+#undef ARIA_R_PAIRS
+#undef ARIA_R_PAIRS_14
+#undef ARIA_R_PAIRS_16
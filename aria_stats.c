@@ -0,0 +1,261 @@
+/* aria_stats.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* Usage counters
+**
+** Each thread increments its own block of counters, found through a
+** thread-local pointer, so counting takes no lock and shares no cache line.
+** A thread's first count allocates its block and links it into a list under
+** a mutex; when the thread exits, a pthread key destructor folds its counts
+** into the retired totals and frees the block. A snapshot sums the list and
+** the retired totals under the mutex, reading the live blocks with relaxed
+** atomic loads, so its counts may lag those threads slightly.
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for syscall */
+#endif
+
+#include <string.h>
+#include "aria_stats.h"
+
+#if ARIA_STATS
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#if ARIA_STATS_PERF_EVENT
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+typedef struct aria_stats_thread_s aria_stats_thread_t;
+
+struct aria_stats_thread_s
+{
+  aria_stats_counters_t c;     /* first, so a counters pointer is the block */
+  aria_stats_thread_t  *next;
+  aria_stats_thread_t  *prev;
+  int                   perf_fd[3]; /* the perf_event group, leader first, or -1 */
+};
+
+__thread aria_stats_counters_t *aria_stats_mine;
+
+static pthread_mutex_t       aria_stats_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t        aria_stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t         aria_stats_key;
+static aria_stats_thread_t  *aria_stats_threads;
+static aria_stats_counters_t aria_stats_retired;
+static int                   aria_stats_perf_ok;
+
+static void
+aria_stats_exit (void *arg)
+{
+  aria_stats_thread_t *t = arg;
+
+  (void)pthread_mutex_lock(&aria_stats_lock);
+#define ARIA_STATS_RETIRE(f) aria_stats_retired.f += ARIA_STATS_LOAD(t->c.f);
+  ARIA_STATS_FIELDS(ARIA_STATS_RETIRE)
+#undef ARIA_STATS_RETIRE
+  if (NULL != t->prev)
+  {
+    t->prev->next = t->next;
+  }
+  else
+  {
+    aria_stats_threads = t->next;
+  }
+  if (NULL != t->next)
+  {
+    t->next->prev = t->prev;
+  }
+  (void)pthread_mutex_unlock(&aria_stats_lock);
+#if ARIA_STATS_PERF_EVENT
+  for (unsigned i = 0u; i < 3u; i++)
+  {
+    if (t->perf_fd[i] >= 0)
+    {
+      (void)close(t->perf_fd[i]);
+    }
+  }
+#endif
+  aria_stats_mine = NULL;
+  free(t);
+}
+
+static void
+aria_stats_init (void)
+{
+  (void)pthread_key_create(&aria_stats_key, aria_stats_exit);
+}
+
+#if ARIA_STATS_PERF_EVENT
+
+static int
+aria_stats_perf_open (uint32_t type, uint64_t config, int group)
+{
+  struct perf_event_attr attr;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.size           = sizeof(attr);
+  attr.type           = type;
+  attr.config         = config;
+  attr.disabled       = (group < 0) ? 1u : 0u;
+  attr.exclude_kernel = 1u;
+  attr.exclude_hv     = 1u;
+  attr.read_format    = PERF_FORMAT_GROUP;
+  return (int )syscall(__NR_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+/* A group of cycles, instructions and L1D read misses for this thread; all
+** three or none
+*/
+
+static void
+aria_stats_perf_group (int fd[3])
+{
+  fd[0] = aria_stats_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+  fd[1] = (fd[0] < 0) ? -1 : aria_stats_perf_open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, fd[0]);
+  fd[2] = (fd[1] < 0) ? -1 : aria_stats_perf_open(PERF_TYPE_HW_CACHE
+                                                , PERF_COUNT_HW_CACHE_L1D
+                                                  | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                                  | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)
+                                                , fd[0]);
+  if ((fd[2] < 0) || (0 != ioctl(fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP)))
+  {
+    for (unsigned i = 0u; i < 3u; i++)
+    {
+      if (fd[i] >= 0)
+      {
+        (void)close(fd[i]);
+      }
+      fd[i] = -1;
+    }
+  }
+}
+
+#endif /* ARIA_STATS_PERF_EVENT */
+
+aria_stats_counters_t *
+aria_stats_register (void)
+{
+  aria_stats_thread_t *t;
+
+  (void)pthread_once(&aria_stats_once, aria_stats_init);
+  t = calloc(1u, sizeof(aria_stats_thread_t));
+  if (NULL == t)
+  {
+    static __thread aria_stats_counters_t lost; /* counted, never reported */
+
+    return &lost;
+  }
+  t->perf_fd[0] = t->perf_fd[1] = t->perf_fd[2] = -1;
+#if ARIA_STATS_PERF_EVENT
+  aria_stats_perf_group(t->perf_fd);
+#endif
+  (void)pthread_mutex_lock(&aria_stats_lock);
+  t->next = aria_stats_threads;
+  if (NULL != t->next)
+  {
+    t->next->prev = t;
+  }
+  aria_stats_threads = t;
+  if (t->perf_fd[0] >= 0)
+  {
+    aria_stats_perf_ok = 1;
+  }
+  (void)pthread_mutex_unlock(&aria_stats_lock);
+  (void)pthread_setspecific(aria_stats_key, t);
+  aria_stats_mine = &t->c;
+  return aria_stats_mine;
+}
+
+#if ARIA_STATS_PERF_EVENT
+
+static void
+aria_stats_perf_read (uint64_t v[3])
+{
+  (void)aria_stats_local();
+
+  aria_stats_thread_t *t = (aria_stats_thread_t *)aria_stats_mine; /* NULL if out of memory */
+  uint64_t group[4] = { 0u, 0u, 0u, 0u };                         /* nr, then the values in order */
+
+  if ((NULL == t) || (t->perf_fd[0] < 0) || (read(t->perf_fd[0], group, sizeof(group)) != (ssize_t )sizeof(group)))
+  {
+    group[1] = group[2] = group[3] = 0u;
+  }
+  v[0] = group[1];
+  v[1] = group[2];
+  v[2] = group[3];
+}
+
+void
+aria_stats_perf_begin (uint64_t v[3])
+{
+  aria_stats_perf_read(v);
+}
+
+void
+aria_stats_perf_end (const uint64_t v[3])
+{
+  aria_stats_counters_t *c = aria_stats_local();
+  uint64_t e[3];
+
+  aria_stats_perf_read(e);
+  ARIA_STATS_INC(c->cycles,       e[0] - v[0]);
+  ARIA_STATS_INC(c->instructions, e[1] - v[1]);
+  ARIA_STATS_INC(c->l1d_misses,   e[2] - v[2]);
+}
+
+#endif /* ARIA_STATS_PERF_EVENT */
+
+#endif /* ARIA_STATS */
+
+aria_error_code_t
+aria_stats_snapshot (aria_stats_t *stats)
+{
+  if (NULL == stats)
+  {
+    return ARG_BAD;
+  }
+  memset(stats, 0, sizeof(*stats));
+  stats->backend = aria_get_backend();
+#if ARIA_STATS
+  stats->enabled = 1;
+  (void)pthread_mutex_lock(&aria_stats_lock);
+  stats->perf = aria_stats_perf_ok;
+#define ARIA_STATS_SUM(f) stats->f = aria_stats_retired.f;
+  ARIA_STATS_FIELDS(ARIA_STATS_SUM)
+#undef ARIA_STATS_SUM
+  for (const aria_stats_thread_t *t = aria_stats_threads; NULL != t; t = t->next)
+  {
+#define ARIA_STATS_SUM(f) stats->f += ARIA_STATS_LOAD(t->c.f);
+    ARIA_STATS_FIELDS(ARIA_STATS_SUM)
+#undef ARIA_STATS_SUM
+  }
+  (void)pthread_mutex_unlock(&aria_stats_lock);
+#endif
+  return NO_ERROR;
+}
+
+void
+aria_stats_reset (void)
+{
+#if ARIA_STATS
+  (void)pthread_mutex_lock(&aria_stats_lock);
+  memset(&aria_stats_retired, 0, sizeof(aria_stats_retired));
+  for (aria_stats_thread_t *t = aria_stats_threads; NULL != t; t = t->next)
+  {
+#define ARIA_STATS_CLEAR(f) ARIA_STATS_STORE(t->c.f, 0u);
+    ARIA_STATS_FIELDS(ARIA_STATS_CLEAR)
+#undef ARIA_STATS_CLEAR
+  }
+  (void)pthread_mutex_unlock(&aria_stats_lock);
+#endif
+}
@@ -0,0 +1,91 @@
+/* aria_stats.h
+**
+** Internal: the counters behind aria_stats_snapshot(). With ARIA_STATS 0 (the
+** default) the hooks are empty macros and cost nothing.
+*/
+
+#ifndef ARIA_STATS_H
+#define ARIA_STATS_H
+
+#include "aria.h"
+
+#ifndef ARIA_STATS
+#define ARIA_STATS 0
+#endif
+
+#if ARIA_STATS && defined(ARIA_STATS_PERF) && defined(__linux__)
+#define ARIA_STATS_PERF_EVENT 1
+#else
+#define ARIA_STATS_PERF_EVENT 0
+#endif
+
+/* The counters each thread keeps, named as in aria_stats_t */
+#define ARIA_STATS_FIELDS(X) \
+  X(crypt_calls) X(bulk_calls) X(blocks) X(key_inits) X(key_to_decrypt) \
+  X(ecb_bytes) X(cbc_bytes) X(ctr_bytes) X(xts_bytes) X(cmac_bytes) \
+  X(gcm_bytes) X(gcm_aad_bytes) \
+  X(cache_hits) X(cache_misses) X(cycles) X(instructions) X(l1d_misses)
+
+#define ARIA_STATS_FIELD(f) uint64_t f;
+
+typedef struct aria_stats_counters_s
+{
+  ARIA_STATS_FIELDS(ARIA_STATS_FIELD)
+} aria_stats_counters_t;
+
+#if ARIA_STATS
+
+extern __thread aria_stats_counters_t *aria_stats_mine;
+
+aria_stats_counters_t *aria_stats_register (void);
+
+static inline aria_stats_counters_t *
+aria_stats_local (void)
+{
+  aria_stats_counters_t *c = aria_stats_mine;
+
+  return (NULL != c) ? c : aria_stats_register();
+}
+
+/* A counter is written only by its thread, but snapshot and reset read and
+** clear it from others, so every access is a relaxed atomic: no ordering is
+** needed, only freedom from torn or racing accesses
+*/
+#if defined(__GNUC__)
+#define ARIA_STATS_INC(c, n)   ((void)__atomic_fetch_add(&(c), (uint64_t )(n), __ATOMIC_RELAXED))
+#define ARIA_STATS_LOAD(c)     __atomic_load_n(&(c), __ATOMIC_RELAXED)
+#define ARIA_STATS_STORE(c, v) __atomic_store_n(&(c), (uint64_t )(v), __ATOMIC_RELAXED)
+#else
+#define ARIA_STATS_INC(c, n)   ((void)((c) += (uint64_t )(n)))
+#define ARIA_STATS_LOAD(c)     (c)
+#define ARIA_STATS_STORE(c, v) ((void)((c) = (uint64_t )(v)))
+#endif
+
+#define ARIA_STAT_ADD(field, n) ARIA_STATS_INC(aria_stats_local()->field, n)
+
+#else
+
+#define ARIA_STAT_ADD(field, n) ((void)0)
+
+#endif /* ARIA_STATS */
+
+/* perf_event counts over a bulk call: begin fills v[3] (cycles,
+** instructions, L1D read misses), end adds the difference to the thread's
+** counters
+*/
+#if ARIA_STATS_PERF_EVENT
+
+void aria_stats_perf_begin (uint64_t v[3]);
+void aria_stats_perf_end (const uint64_t v[3]);
+
+#define ARIA_STAT_PERF_BEGIN(v) uint64_t v[3]; aria_stats_perf_begin(v)
+#define ARIA_STAT_PERF_END(v)   aria_stats_perf_end(v)
+
+#else
+
+#define ARIA_STAT_PERF_BEGIN(v) ((void)0)
+#define ARIA_STAT_PERF_END(v)   ((void)0)
+
+#endif
+
+#endif /* ARIA_STATS_H */
@@ -0,0 +1,55 @@
+/* aria_vperm.h
+**
+** Internal: the 16-entry lookup tables shared by the byte-sliced kernels in
+** aria_x86.c (pshufb) and aria_arm.c (tbl). Both instructions return 0 for
+** an index of 0x80, which the inversion tables rely on.
+*/
+
+#ifndef ARIA_VPERM_H
+#define ARIA_VPERM_H
+
+#include <stdint.h>
+
+#define ARIA_ALIGN16 __attribute__((aligned(16)))
+
+/* vperm S-box tables, see aria_byteslice.h
+**
+** Nibble inversion in GF(2^4) and multiplication of the inverse by a; plus,
+** per S-box, the input lookups (standard basis to nibble pair, with SB3 and
+** SB4's input affine maps folded in) and output lookups (nibble pair back to
+** standard basis, with SB1 and SB2's output affine maps folded in, less their
+** constants 0x63 and 0xe2).
+*/
+
+static const uint8_t ARIA_ALIGN16 VP_INV[16]     = { 0x80, 0x01, 0x08, 0x0d, 0x0f, 0x06, 0x05, 0x0e, 0x02, 0x0c, 0x0b, 0x0a, 0x09, 0x03, 0x07, 0x04 };
+static const uint8_t ARIA_ALIGN16 VP_AK[16]      = { 0x80, 0x02, 0x01, 0x0c, 0x08, 0x0b, 0x0d, 0x0a, 0x04, 0x0e, 0x07, 0x05, 0x03, 0x06, 0x09, 0x0f };
+static const uint8_t ARIA_ALIGN16 VP_PHI_LO[16]  = { 0x00, 0x01, 0x37, 0x36, 0xd0, 0xd1, 0xe7, 0xe6, 0xd2, 0xd3, 0xe5, 0xe4, 0x02, 0x03, 0x35, 0x34 };
+static const uint8_t ARIA_ALIGN16 VP_PHI_HI[16]  = { 0x00, 0xbb, 0x7b, 0xc0, 0xbf, 0x04, 0xc4, 0x7f, 0xc8, 0x73, 0xb3, 0x08, 0x77, 0xcc, 0x0c, 0xb7 };
+static const uint8_t ARIA_ALIGN16 VP_IN3_LO[16]  = { 0xd1, 0x8b, 0x72, 0x28, 0x79, 0x23, 0xda, 0x80, 0xe2, 0xb8, 0x41, 0x1b, 0x4a, 0x10, 0xe9, 0xb3 };
+static const uint8_t ARIA_ALIGN16 VP_IN3_HI[16]  = { 0x00, 0x63, 0x6c, 0x0f, 0x44, 0x27, 0x28, 0x4b, 0xaa, 0xc9, 0xc6, 0xa5, 0xee, 0x8d, 0x82, 0xe1 };
+static const uint8_t ARIA_ALIGN16 VP_IN4_LO[16]  = { 0x79, 0x67, 0x6b, 0x75, 0xe3, 0xfd, 0xf1, 0xef, 0x0f, 0x11, 0x1d, 0x03, 0x95, 0x8b, 0x87, 0x99 };
+static const uint8_t ARIA_ALIGN16 VP_IN4_HI[16]  = { 0x00, 0xae, 0x33, 0x9d, 0x86, 0x28, 0xb5, 0x1b, 0xde, 0x70, 0xed, 0x43, 0x58, 0xf6, 0x6b, 0xc5 };
+static const uint8_t ARIA_ALIGN16 VP_OUT1_IO[16] = { 0x00, 0xfa, 0x6a, 0x35, 0xbb, 0x2b, 0x5f, 0x41, 0x8e, 0xcf, 0x1e, 0xe4, 0x90, 0x74, 0xd1, 0xa5 };
+static const uint8_t ARIA_ALIGN16 VP_OUT1_JO[16] = { 0x00, 0x81, 0x76, 0x99, 0xfd, 0x0a, 0xef, 0x7c, 0x64, 0x18, 0x93, 0x12, 0xf7, 0xe5, 0x8b, 0x6e };
+static const uint8_t ARIA_ALIGN16 VP_OUT2_IO[16] = { 0x00, 0x3c, 0xcf, 0xe7, 0x3d, 0xce, 0x28, 0x01, 0xda, 0xdb, 0x29, 0x15, 0xf3, 0xe6, 0xf2, 0x14 };
+static const uint8_t ARIA_ALIGN16 VP_OUT2_JO[16] = { 0x00, 0x48, 0x59, 0x56, 0x8e, 0x9f, 0x0f, 0xc6, 0xd8, 0x1e, 0xc9, 0x81, 0x11, 0x90, 0xd7, 0x47 };
+static const uint8_t ARIA_ALIGN16 VP_INV_IO[16]  = { 0x00, 0x9c, 0x1d, 0x8e, 0x44, 0xc5, 0x93, 0xd8, 0xca, 0x12, 0x4b, 0xd7, 0x81, 0x56, 0x59, 0x0f };
+static const uint8_t ARIA_ALIGN16 VP_INV_JO[16]  = { 0x00, 0x6f, 0xc2, 0x99, 0x6b, 0xc6, 0x5b, 0x04, 0xf2, 0xf6, 0x5f, 0x30, 0xad, 0x9d, 0xa9, 0x34 };
+
+/* Swap the bytes of each 64-bit half: byte order to aria_u128_t and back */
+
+static const uint8_t ARIA_ALIGN16 BS_BSWAP64[16] = { 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00, 0x0f, 0x0e, 0x0d, 0x0c, 0x0b, 0x0a, 0x09, 0x08 };
+
+/* AES S-box kernels: the permutations that cancel ShiftRows and InvShiftRows,
+** and the affine maps, as nibble lookups, that turn the AES S-box into SB2 and
+** its inverse into SB4
+*/
+
+static const uint8_t ARIA_ALIGN16 AES_SR[16]    = { 0x00, 0x05, 0x0a, 0x0f, 0x04, 0x09, 0x0e, 0x03, 0x08, 0x0d, 0x02, 0x07, 0x0c, 0x01, 0x06, 0x0b };
+static const uint8_t ARIA_ALIGN16 AES_ISR[16]   = { 0x00, 0x0d, 0x0a, 0x07, 0x04, 0x01, 0x0e, 0x0b, 0x08, 0x05, 0x02, 0x0f, 0x0c, 0x09, 0x06, 0x03 };
+static const uint8_t ARIA_ALIGN16 AES_M2_LO[16] = { 0x88, 0x0d, 0x37, 0xb2, 0x00, 0x85, 0xbf, 0x3a, 0xa8, 0x2d, 0x17, 0x92, 0x20, 0xa5, 0x9f, 0x1a };
+static const uint8_t ARIA_ALIGN16 AES_M2_HI[16] = { 0x00, 0x3e, 0xd4, 0xea, 0x84, 0xba, 0x50, 0x6e, 0xcd, 0xf3, 0x19, 0x27, 0x49, 0x77, 0x9d, 0xa3 };
+static const uint8_t ARIA_ALIGN16 AES_M4_LO[16] = { 0x04, 0x45, 0xee, 0xaf, 0x17, 0x56, 0xfd, 0xbc, 0x53, 0x12, 0xb9, 0xf8, 0x40, 0x01, 0xaa, 0xeb };
+static const uint8_t ARIA_ALIGN16 AES_M4_HI[16] = { 0x00, 0xb6, 0x08, 0xbe, 0xd6, 0x60, 0xde, 0x68, 0x53, 0xe5, 0x5b, 0xed, 0x85, 0x33, 0x8d, 0x3b };
+
+#endif /* ARIA_VPERM_H */
@@ -0,0 +1,289 @@
+/* aria_x86.c
+**
+** Copyright (C) 2016 Doug Currie, Londonderry, NH, USA
+**
+** Same license as aria.c
+*/
+
+/* x86 SIMD kernels for ARIA
+**
+** The kernels are compiled with per-function target attributes, so the rest
+** of the library builds for the baseline instruction set, and aria.c only
+** calls a kernel after checking that the CPU supports it.
+*/
+
+#include "aria_x86.h"
+
+#if ARIA_X86
+
+#include <immintrin.h>
+
+#include "aria_vperm.h"
+
+int aria_x86_has_ssse3 (void)
+{
+  return __builtin_cpu_supports("ssse3") ? 1 : 0;
+}
+
+int aria_x86_has_avx2 (void)
+{
+  return __builtin_cpu_supports("avx2") ? 1 : 0;
+}
+
+int aria_x86_has_aesni (void)
+{
+  return (__builtin_cpu_supports("aes") && __builtin_cpu_supports("ssse3")) ? 1 : 0;
+}
+
+int aria_x86_has_gfni (void)
+{
+  return (__builtin_cpu_supports("gfni") && __builtin_cpu_supports("avx2")) ? 1 : 0;
+}
+
+int aria_x86_has_pclmul (void)
+{
+  return __builtin_cpu_supports("pclmul") ? 1 : 0;
+}
+
+/* 128-bit vectors, 16 blocks per pass; BS_LOAD and BS_STORE take byte
+** pointers
+*/
+
+#define ARIA_BS_BLOCKS   16u
+#define BS_V             __m128i
+#define BS_XOR(a, b)     _mm_xor_si128((a), (b))
+#define BS_AND(a, b)     _mm_and_si128((a), (b))
+#define BS_ANDNOT(a, b)  _mm_andnot_si128((a), (b))
+#define BS_SHUF(t, x)    _mm_shuffle_epi8((t), (x))
+#define BS_SRL4(x)       _mm_srli_epi16((x), 4)
+#define BS_SET1(c)       _mm_set1_epi8((char )(c))
+#define BS_TAB(p)        _mm_load_si128((const __m128i *)(p))
+#define BS_UNPACKLO8     _mm_unpacklo_epi8
+#define BS_UNPACKHI8     _mm_unpackhi_epi8
+#define BS_LOAD(p, m)    _mm_loadu_si128((const __m128i *)&(p)[16 * (m)])
+#define BS_STORE(p, m, v) _mm_storeu_si128((__m128i *)&(p)[16 * (m)], (v))
+#define BS_KEY(rk)       _mm_loadu_si128((const __m128i *)(rk))
+
+/* SSSE3 */
+
+#define ARIA_BS_NAME(x)  aria_x86_ssse3_##x
+#define ARIA_BS_TARGET   __attribute__((target("ssse3")))
+
+#include "aria_byteslice.h"
+
+#undef ARIA_BS_NAME
+#undef ARIA_BS_TARGET
+
+/* AES-NI
+**
+** SB1 is the AES S-box and SB3 its inverse, so aesenclast and aesdeclast with
+** a zero round key do a whole vector of them, once the input is permuted to
+** cancel the ShiftRows or InvShiftRows those instructions include. SB2 is an
+** affine map of SB1's output and SB4 is SB3 of an affine map of its input;
+** the affine maps take two nibble lookups each.
+*/
+
+static inline __attribute__((target("aes,ssse3"))) __m128i
+aria_x86_aesni_affine (__m128i x, const uint8_t *lo, const uint8_t *hi)
+{
+  const __m128i m0f = _mm_set1_epi8(0x0f);
+
+  return _mm_xor_si128(_mm_shuffle_epi8(_mm_load_si128((const __m128i *)lo), _mm_and_si128(m0f, x))
+                     , _mm_shuffle_epi8(_mm_load_si128((const __m128i *)hi), _mm_srli_epi16(_mm_andnot_si128(m0f, x), 4)));
+}
+
+#define AES_SB1(x) _mm_aesenclast_si128(_mm_shuffle_epi8((x), _mm_load_si128((const __m128i *)AES_ISR)), _mm_setzero_si128())
+#define AES_SB3(x) _mm_aesdeclast_si128(_mm_shuffle_epi8((x), _mm_load_si128((const __m128i *)AES_SR)), _mm_setzero_si128())
+
+#define BS_SB1(x) AES_SB1(x)
+#define BS_SB2(x) aria_x86_aesni_affine(AES_SB1(x), AES_M2_LO, AES_M2_HI)
+#define BS_SB3(x) AES_SB3(x)
+#define BS_SB4(x) AES_SB3(aria_x86_aesni_affine((x), AES_M4_LO, AES_M4_HI))
+
+#define ARIA_BS_NAME(x)  aria_x86_aesni_##x
+#define ARIA_BS_TARGET   __attribute__((target("aes,ssse3")))
+
+#include "aria_byteslice.h"
+
+#undef ARIA_BS_NAME
+#undef ARIA_BS_TARGET
+
+#undef ARIA_BS_BLOCKS
+#undef BS_V
+#undef BS_XOR
+#undef BS_AND
+#undef BS_ANDNOT
+#undef BS_SHUF
+#undef BS_SRL4
+#undef BS_SET1
+#undef BS_TAB
+#undef BS_UNPACKLO8
+#undef BS_UNPACKHI8
+#undef BS_LOAD
+#undef BS_STORE
+#undef BS_KEY
+
+/* 256-bit vectors, 32 blocks per pass: lane 0 holds blocks 0..15, lane 1 
+** blocks 16..31
+*/
+
+#define ARIA_BS_BLOCKS   32u
+#define BS_V             __m256i
+#define BS_XOR(a, b)     _mm256_xor_si256((a), (b))
+#define BS_AND(a, b)     _mm256_and_si256((a), (b))
+#define BS_ANDNOT(a, b)  _mm256_andnot_si256((a), (b))
+#define BS_SHUF(t, x)    _mm256_shuffle_epi8((t), (x))
+#define BS_SRL4(x)       _mm256_srli_epi16((x), 4)
+#define BS_SET1(c)       _mm256_set1_epi8((char )(c))
+#define BS_TAB(p)        _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i *)(p)))
+#define BS_UNPACKLO8     _mm256_unpacklo_epi8
+#define BS_UNPACKHI8     _mm256_unpackhi_epi8
+#define BS_LOAD(p, m)    _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)&(p)[16 * (m)])) \
+                                                , _mm_loadu_si128((const __m128i *)&(p)[16 * ((m) + 16)]), 1)
+#define BS_STORE(p, m, v) \
+  do { \
+    _mm_storeu_si128((__m128i *)&(p)[16 * (m)], _mm256_castsi256_si128(v)); \
+    _mm_storeu_si128((__m128i *)&(p)[16 * ((m) + 16)], _mm256_extracti128_si256((v), 1)); \
+  } while (0)
+#define BS_KEY(rk)       _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(rk)))
+
+/* AVX2 */
+
+#define ARIA_BS_NAME(x)  aria_x86_avx2_##x
+#define ARIA_BS_TARGET   __attribute__((target("avx2")))
+
+#include "aria_byteslice.h"
+
+#undef ARIA_BS_NAME
+#undef ARIA_BS_TARGET
+
+/* GFNI
+**
+** vgf2p8affineinvqb computes A(x^-1) ^ b for any 8x8 bit matrix A, in the
+** same field as ARIA, so SB1 and SB2 are one instruction each, and SB3 and
+** SB4 are their input affine map (vgf2p8affineqb) followed by inversion.
+** Each matrix has row i in byte 7-i.
+*/
+
+#define GF_OUT1  0xf1e3c78f1f3e7cf8ll  /* SB1 = GF_OUT1 * x^-1 + 0x63, the AES affine map */
+#define GF_OUT2  0xeafcb7c3c273c66fll  /* SB2 = GF_OUT2 * x^-1 + 0xe2 */
+#define GF_IN3   0xa44992254a942952ll  /* SB3 = (GF_IN3 * x + 0x05)^-1 */
+#define GF_IN4   0x186450c737d6bdc9ll  /* SB4 = (GF_IN4 * x + 0x2c)^-1 */
+#define GF_IDENT 0x0102040810204080ll
+
+#define BS_SB1(x) _mm256_gf2p8affineinv_epi64_epi8((x), _mm256_set1_epi64x(GF_OUT1), 0x63)
+#define BS_SB2(x) _mm256_gf2p8affineinv_epi64_epi8((x), _mm256_set1_epi64x(GF_OUT2), 0xe2)
+#define BS_SB3(x) _mm256_gf2p8affineinv_epi64_epi8(_mm256_gf2p8affine_epi64_epi8((x), _mm256_set1_epi64x(GF_IN3), 0x05) \
+                                                  , _mm256_set1_epi64x(GF_IDENT), 0)
+#define BS_SB4(x) _mm256_gf2p8affineinv_epi64_epi8(_mm256_gf2p8affine_epi64_epi8((x), _mm256_set1_epi64x(GF_IN4), 0x2c) \
+                                                  , _mm256_set1_epi64x(GF_IDENT), 0)
+
+#define ARIA_BS_NAME(x)  aria_x86_gfni_##x
+#define ARIA_BS_TARGET   __attribute__((target("gfni,avx2")))
+
+#include "aria_byteslice.h"
+
+#undef ARIA_BS_NAME
+#undef ARIA_BS_TARGET
+
+#undef ARIA_BS_BLOCKS
+#undef BS_V
+#undef BS_XOR
+#undef BS_AND
+#undef BS_ANDNOT
+#undef BS_SHUF
+#undef BS_SRL4
+#undef BS_SET1
+#undef BS_TAB
+#undef BS_UNPACKLO8
+#undef BS_UNPACKHI8
+#undef BS_LOAD
+#undef BS_STORE
+#undef BS_KEY
+
+/* GHASH with carry-less multiplication
+**
+** As in Gueron and Kounavis, "Intel Carry-Less Multiplication Instruction and
+** its Usage for Computing the GCM Mode": an aria_u128_t loads as the byte
+** reflected block, the 256-bit product is shifted left one bit to account for
+** GCM's bit reflection, then reduced modulo x^128 + x^7 + x^2 + x + 1. Eight
+** blocks at a time are multiplied by H^8..H^1, summed, and reduced once.
+*/
+
+#define ARIA_GHASH_TARGET __attribute__((target("pclmul,sse2")))
+
+static inline ARIA_GHASH_TARGET __m128i
+aria_x86_ghash_load (const aria_u128_t *p)
+{
+  return _mm_set_epi64x((long long )p->left, (long long )p->right);
+}
+
+/* Accumulate the unreduced product a * b into lo, mid, hi */
+
+static inline ARIA_GHASH_TARGET void
+aria_x86_ghash_mul (__m128i a, __m128i b, __m128i *lo, __m128i *mid, __m128i *hi)
+{
+  *lo  = _mm_xor_si128(*lo, _mm_clmulepi64_si128(a, b, 0x00));
+  *hi  = _mm_xor_si128(*hi, _mm_clmulepi64_si128(a, b, 0x11));
+  *mid = _mm_xor_si128(*mid, _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x01), _mm_clmulepi64_si128(a, b, 0x10)));
+}
+
+static inline ARIA_GHASH_TARGET __m128i
+aria_x86_ghash_reduce (__m128i lo, __m128i mid, __m128i hi)
+{
+  lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+  hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+  /* shift hi:lo left by one bit */
+  __m128i clo = _mm_srli_epi32(lo, 31);
+  __m128i chi = _mm_srli_epi32(hi, 31);
+  lo  = _mm_slli_epi32(lo, 1);
+  hi  = _mm_slli_epi32(hi, 1);
+  hi  = _mm_or_si128(hi, _mm_srli_si128(clo, 12));
+  hi  = _mm_or_si128(hi, _mm_slli_si128(chi, 4));
+  lo  = _mm_or_si128(lo, _mm_slli_si128(clo, 4));
+
+  /* reduce */
+  __m128i a = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(lo, 31), _mm_slli_epi32(lo, 30)), _mm_slli_epi32(lo, 25));
+  __m128i b = _mm_srli_si128(a, 4);
+  lo = _mm_xor_si128(lo, _mm_slli_si128(a, 12));
+  a  = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(lo, 1), _mm_srli_epi32(lo, 2)), _mm_srli_epi32(lo, 7));
+  return _mm_xor_si128(hi, _mm_xor_si128(lo, _mm_xor_si128(a, b)));
+}
+
+void ARIA_GHASH_TARGET
+aria_x86_pclmul_ghash (aria_u128_t *x, const aria_u128_t h[8], const aria_u128_t *blocks, size_t count)
+{
+  __m128i y = aria_x86_ghash_load(x);
+
+  for (; count >= 8u; count -= 8u)
+  {
+    __m128i lo  = _mm_setzero_si128();
+    __m128i mid = _mm_setzero_si128();
+    __m128i hi  = _mm_setzero_si128();
+
+    aria_x86_ghash_mul(_mm_xor_si128(y, aria_x86_ghash_load(&blocks[0])), aria_x86_ghash_load(&h[7]), &lo, &mid, &hi);
+    for (int j = 1; j < 8; j++)
+    {
+      aria_x86_ghash_mul(aria_x86_ghash_load(&blocks[j]), aria_x86_ghash_load(&h[7 - j]), &lo, &mid, &hi);
+    }
+    y = aria_x86_ghash_reduce(lo, mid, hi);
+    blocks += 8;
+  }
+  for (; count > 0u; count--)
+  {
+    __m128i lo  = _mm_setzero_si128();
+    __m128i mid = _mm_setzero_si128();
+    __m128i hi  = _mm_setzero_si128();
+
+    aria_x86_ghash_mul(_mm_xor_si128(y, aria_x86_ghash_load(blocks++)), aria_x86_ghash_load(&h[0]), &lo, &mid, &hi);
+    y = aria_x86_ghash_reduce(lo, mid, hi);
+  }
+  uint64_t ARIA_ALIGN16 r[2];
+
+  _mm_store_si128((__m128i *)r, y);
+  x->left  = r[1];
+  x->right = r[0];
+}
+
+#endif /* ARIA_X86 */
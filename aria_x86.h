@@ -0,0 +1,109 @@
+/* aria_x86.h
+**
+** Internal interface between aria.c and the x86 SIMD kernels in aria_x86.c
+*/
+
+#ifndef ARIA_X86_H
+#define ARIA_X86_H
+
+#include "aria.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(ARIA_NO_SIMD)
+#define ARIA_X86 1
+#else
+#define ARIA_X86 0
+#endif
+
+#if ARIA_X86
+
+/* CPU feature tests, all return 0 or 1 */
+int aria_x86_has_ssse3 (void);
+int aria_x86_has_avx2 (void);
+int aria_x86_has_aesni (void);
+int aria_x86_has_gfni (void);
+int aria_x86_has_pclmul (void);
+
+/* The kernels process as many whole groups of 16 (SSSE3, AES-NI) or 32
+** (AVX2, GFNI) blocks as fit in count, and return the number of blocks done;
+** the caller handles the rest. in and out may be the same array.
+*/
+size_t aria_x86_ssse3_crypt_blocks (const aria_key_schedule_t *ks
+                                  , const aria_u128_t *in
+                                  , aria_u128_t       *out
+                                  , size_t             count);
+
+size_t aria_x86_avx2_crypt_blocks (const aria_key_schedule_t *ks
+                                 , const aria_u128_t *in
+                                 , aria_u128_t       *out
+                                 , size_t             count);
+
+size_t aria_x86_aesni_crypt_blocks (const aria_key_schedule_t *ks
+                                  , const aria_u128_t *in
+                                  , aria_u128_t       *out
+                                  , size_t             count);
+
+size_t aria_x86_gfni_crypt_blocks (const aria_key_schedule_t *ks
+                                 , const aria_u128_t *in
+                                 , aria_u128_t       *out
+                                 , size_t             count);
+
+/* The same kernels on count blocks at in and out in byte order (see
+** aria_crypt_bytes()), with no alignment needed
+*/
+size_t aria_x86_ssse3_crypt_bytes (const aria_key_schedule_t *ks
+                                 , const uint8_t *in
+                                 , uint8_t       *out
+                                 , size_t         count);
+
+size_t aria_x86_avx2_crypt_bytes (const aria_key_schedule_t *ks
+                                , const uint8_t *in
+                                , uint8_t       *out
+                                , size_t         count);
+
+size_t aria_x86_aesni_crypt_bytes (const aria_key_schedule_t *ks
+                                 , const uint8_t *in
+                                 , uint8_t       *out
+                                 , size_t         count);
+
+size_t aria_x86_gfni_crypt_bytes (const aria_key_schedule_t *ks
+                                , const uint8_t *in
+                                , uint8_t       *out
+                                , size_t         count);
+
+/* The same kernels with a key schedule per block: block i under ks[i], all
+** of them with the same round count
+*/
+size_t aria_x86_ssse3_crypt_lanes (const aria_key_schedule_t *const *ks
+                                 , const aria_u128_t *in
+                                 , aria_u128_t       *out
+                                 , size_t             count);
+
+size_t aria_x86_avx2_crypt_lanes (const aria_key_schedule_t *const *ks
+                                , const aria_u128_t *in
+                                , aria_u128_t       *out
+                                , size_t             count);
+
+size_t aria_x86_aesni_crypt_lanes (const aria_key_schedule_t *const *ks
+                                 , const aria_u128_t *in
+                                 , aria_u128_t       *out
+                                 , size_t             count);
+
+size_t aria_x86_gfni_crypt_lanes (const aria_key_schedule_t *const *ks
+                                , const aria_u128_t *in
+                                , aria_u128_t       *out
+                                , size_t             count);
+
+/* GHASH: for each block, x = (x ^ block) * H, with h[i] = H^(i+1) */
+void aria_x86_pclmul_ghash (aria_u128_t *x, const aria_u128_t h[8], const aria_u128_t *blocks, size_t count);
+
+#endif /* ARIA_X86 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARIA_X86_H */
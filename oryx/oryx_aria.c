@@ -41,6 +41,7 @@
 //#include "aria.h"
 //#include "debug.h"
 #include <stdint.h>
+#include "oryx_aria.h"
 
 #define BETOH32(value) _SWAP32(value)
 #define _SWAP32(x) ( \
@@ -63,14 +64,6 @@ typedef int error_t;
 
 typedef unsigned uint_t;
 
-typedef struct
-{
-   uint_t nr;
-   uint32_t k[16];
-   uint32_t ek[68];
-   uint32_t dk[68];
-} AriaContext;
-
 //Check crypto library configuration
 //#if (ARIA_SUPPORT == ENABLED)
 
@@ -585,6 +578,8 @@ void ariaDecryptBlock(AriaContext *context, const uint8_t *input, uint8_t *outpu
 
 // e testing hack
 
+#ifndef ORYX_ARIA_LIB
+
 #include <stdio.h>
 #include <inttypes.h>
 #include <stdlib.h>
@@ -681,7 +676,7 @@ int main (int argc, char **argv)
  
       union { uint8_t Cb[16]; aria_u128_t C; } ud;
  
-      ariaDecryptBlock(&ac, (const uint8_t *)&Plaintext, ud.Cb);
+      ariaDecryptBlock(&ac, ue.Cb, ud.Cb);
  
       if (0 != memcmp((const void *)&Plaintext, (const void *)&ud.C, sizeof(aria_u128_t)))
       {
@@ -700,3 +695,4 @@ int main (int argc, char **argv)
 
 }
 
+#endif /* ORYX_ARIA_LIB */
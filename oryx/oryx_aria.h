@@ -0,0 +1,28 @@
+/* oryx_aria.h
+**
+** The interface to oryx_aria.c, for linking it into ariabench; that file
+** carries its own license. Built with ORYX_ARIA_LIB, oryx_aria.c leaves out
+** its test main.
+*/
+
+#ifndef ORYX_ARIA_H
+#define ORYX_ARIA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+   unsigned nr;
+   uint32_t k[16];
+   uint32_t ek[68];
+   uint32_t dk[68];
+} AriaContext;
+
+/* keyLength is in bytes: 16, 24 or 32; returns 0, or -1 for a bad length */
+int ariaInit(AriaContext *context, const uint8_t *key, size_t keyLength);
+
+void ariaEncryptBlock(AriaContext *context, const uint8_t *input, uint8_t *output);
+void ariaDecryptBlock(AriaContext *context, const uint8_t *input, uint8_t *output);
+
+#endif /* ORYX_ARIA_H */
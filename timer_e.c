@@ -1,9 +1,23 @@
 /* timer_e.c
 */
 
+#if !__APPLE__ && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L /* for clock_gettime */
+#endif
+
 #include "timer_e.h"
 
+#include <stddef.h>
 #include <sys/time.h>
+#include <time.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TIMER_E_TSC 1
+#include <cpuid.h>
+#include <x86intrin.h>
+#else
+#define TIMER_E_TSC 0
+#endif
 
 #if __APPLE__
 
@@ -33,13 +47,150 @@ double timer_e_nanoseconds_gtod (void)
 
 #else
 
+/* CLOCK_MONOTONIC_RAW is not slewed by NTP, so intervals are the hardware's */
+
+#ifndef CLOCK_MONOTONIC_RAW
+#define CLOCK_MONOTONIC_RAW CLOCK_MONOTONIC
+#endif
+
 double timer_e_nanoseconds (void)
 {
-    struct timeval tv;
+    struct timespec ts;
 
-    gettimeofday(&tv, NULL);
+    if (0 != clock_gettime(CLOCK_MONOTONIC_RAW, &ts))
+    {
+        struct timeval tv;
 
-    return (tv.tv_sec * 1000000000.0) + (tv.tv_usec * 1000.0);
+        gettimeofday(&tv, NULL);
+
+        return (tv.tv_sec * 1000000000.0) + (tv.tv_usec * 1000.0);
+    }
+    return (ts.tv_sec * 1000000000.0) + (double)ts.tv_nsec;
+}
+
+#endif
+
+/* Cycle counter */
+
+#if TIMER_E_TSC
+
+static int timer_e_has_rdtscp (void)
+{
+    static int has = -1;
+    if (has < 0)
+    {
+        unsigned a, b, c, d;
+        has = (__get_cpuid(0x80000001u, &a, &b, &c, &d) && (0u != (d & (1u << 27)))) ? 1 : 0;
+    }
+    return has;
+}
+
+uint64_t timer_e_cycles (void)
+{
+    uint64_t t;
+
+    _mm_lfence();
+    t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+uint64_t timer_e_cycles_end (void)
+{
+    uint64_t t;
+
+    if (timer_e_has_rdtscp())
+    {
+        unsigned aux;
+        t = __rdtscp(&aux);
+    }
+    else
+    {
+        _mm_lfence();
+        t = __rdtsc();
+    }
+    _mm_lfence();
+    return t;
+}
+
+double timer_e_cycles_hz (void)
+{
+    static double hz = 0.0;
+    if (hz == 0.0)
+    {
+        /* the best of a few 5 ms windows, each bracketed tightly by the clock */
+        double best = 0.0;
+
+        for (int i = 0; i < 4; i++)
+        {
+            double   t0 = timer_e_nanoseconds();
+            uint64_t c0 = timer_e_cycles();
+            double   t1;
+
+            while ((t1 = timer_e_nanoseconds()) < (t0 + 5e6))
+            {
+            }
+
+            uint64_t c1 = timer_e_cycles_end();
+            double   r  = (double)(c1 - c0) * 1e9 / (t1 - t0);
+
+            if ((0 == i) || (r < best))
+            {
+                best = r;
+            }
+        }
+        hz = best;
+    }
+    return hz;
+}
+
+#else
+
+uint64_t timer_e_cycles (void)
+{
+    return (uint64_t)timer_e_nanoseconds();
+}
+
+uint64_t timer_e_cycles_end (void)
+{
+    return (uint64_t)timer_e_nanoseconds();
+}
+
+double timer_e_cycles_hz (void)
+{
+    return 1e9;
 }
 
 #endif
+
+uint64_t timer_e_cycles_overhead (void)
+{
+    static int measured = 0;
+    static uint64_t overhead = 0u;
+    if (!measured)
+    {
+        uint64_t best = UINT64_MAX;
+
+        for (int i = 0; i < 1000; i++)
+        {
+            uint64_t start = timer_e_cycles();
+            uint64_t end   = timer_e_cycles_end();
+
+            if ((end - start) < best)
+            {
+                best = end - start;
+            }
+        }
+        overhead = best;
+        measured = 1;
+    }
+    return overhead;
+}
+
+uint64_t timer_e_cycles_elapsed (uint64_t start, uint64_t end)
+{
+    uint64_t d = end - start;
+    uint64_t o = timer_e_cycles_overhead();
+
+    return (d > o) ? (d - o) : 0u;
+}
@@ -1,6 +1,8 @@
 /* timer_e.h
 */
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -10,8 +12,26 @@ extern "C" {
 double timer_e_nanoseconds_gtod (void);
 #endif
 
+/* Monotonic: mach_absolute_time on macOS, CLOCK_MONOTONIC_RAW elsewhere */
 double timer_e_nanoseconds (void);
 
+/* Cycle counter, for timing short stretches of code
+**
+** On x86 this is the TSC, which counts at a fixed rate whatever the core
+** clock; timer_e_cycles() reads it after earlier instructions finish and
+** before later ones start, and timer_e_cycles_end() (rdtscp) after the
+** timed instructions finish, so neither end of the stretch leaks out of it. Elsewhere both count
+** nanoseconds. timer_e_cycles_hz() is the rate, calibrated against
+** timer_e_nanoseconds() on first use (about 20 ms). timer_e_cycles_elapsed()
+** is end - start less the cost of the two reads themselves, measured on
+** first use.
+*/
+uint64_t timer_e_cycles (void);
+uint64_t timer_e_cycles_end (void);
+double   timer_e_cycles_hz (void);
+uint64_t timer_e_cycles_overhead (void);
+uint64_t timer_e_cycles_elapsed (uint64_t start, uint64_t end);
+
 
 #ifdef __cplusplus
 }
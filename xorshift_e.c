@@ -16,6 +16,8 @@ See <http://creativecommons.org/publicdomain/zero/1.0/>. */
 
 #include "xorshift_e.h"
 
+#include <string.h>
+
 uint64_t murmurhash3_avalanche (uint64_t x)
 {
     x ^= x >> 33;
@@ -25,23 +27,37 @@ uint64_t murmurhash3_avalanche (uint64_t x)
     return x ^= x >> 33;
 }
 
+/* Each generator has a context, so threads can each have their own; the
+   functions without one use a context of their own, and are not thread
+   safe. The seed functions leave no state behind besides the context. */
+
 /* xorshift64* is a good generator if you're short on memory, but otherwise we
    rather suggest to use a xorshift128+ (for maximum speed) or
    xorshift1024* (for speed and very long period) generator. */
 
-static uint64_t xorshift64star_x; /* The state must be seeded with a nonzero value. */
+static xorshift64star_t xorshift64star_g; /* The state must be seeded with a nonzero value. */
+
+uint64_t xorshift64star_next_r (xorshift64star_t *ctx)
+{
+    ctx->x ^= ctx->x >> 12; // a
+    ctx->x ^= ctx->x << 25; // b
+    ctx->x ^= ctx->x >> 27; // c
+    return ctx->x * 2685821657736338717LL;
+}
+
+void xorshift64star_seed_r (xorshift64star_t *ctx, uint64_t x)
+{
+    ctx->x = murmurhash3_avalanche((x == 0) ? 42 : x);
+}
 
 uint64_t xorshift64star_next (void)
 {
-    xorshift64star_x ^= xorshift64star_x >> 12; // a
-    xorshift64star_x ^= xorshift64star_x << 25; // b
-    xorshift64star_x ^= xorshift64star_x >> 27; // c
-    return xorshift64star_x * 2685821657736338717LL;
+    return xorshift64star_next_r(&xorshift64star_g);
 }
 
 void xorshift64star_seed (uint64_t x)
 {
-    xorshift64star_x = murmurhash3_avalanche((x == 0) ? 42 : x);
+    xorshift64star_seed_r(&xorshift64star_g, x);
 }
 
 /* xorshift128+ is the fastest generator passing BigCrush without systematic
@@ -53,24 +69,121 @@ void xorshift64star_seed (uint64_t x)
    a 64-bit seed, we suggest to pass it twice through MurmurHash3's
    avalanching function. */
 
-static uint64_t xorshift128plus_s[2];
+static xorshift128plus_t xorshift128plus_g;
 
-uint64_t xorshift128plus_next (void)
+uint64_t xorshift128plus_next_r (xorshift128plus_t *ctx)
 { 
-    uint64_t s1 = xorshift128plus_s[0];
-    const uint64_t s0 = xorshift128plus_s[1];
-    xorshift128plus_s[0] = s0;
+    uint64_t s1 = ctx->s[0];
+    const uint64_t s0 = ctx->s[1];
+    ctx->s[0] = s0;
     s1 ^= s1 << 23; // a
-    return (xorshift128plus_s[1] = (s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26))) + s0; // b, c
+    return (ctx->s[1] = (s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26))) + s0; // b, c
 }
 
-void xorshift128plus_seed (uint64_t x)
+void xorshift128plus_seed_r (xorshift128plus_t *ctx, uint64_t x)
 {
     uint64_t s0 = murmurhash3_avalanche(murmurhash3_avalanche((x == 0) ? 42 : x));
-    xorshift128plus_s[0] = s0;
-    xorshift128plus_s[1] = murmurhash3_avalanche(s0);
+    ctx->s[0] = s0;
+    ctx->s[1] = murmurhash3_avalanche(s0);
 }
 
+/* The jump function is equivalent to 2^64 calls to next; it can be used to
+   generate 2^64 non-overlapping subsequences for parallel computations.
+   The polynomial is x^(2^64) modulo the characteristic polynomial of this
+   (23, 17, 26) recurrence, bit i of the table being the coefficient of x^i. */
+
+void xorshift128plus_jump (xorshift128plus_t *ctx)
+{
+    static const uint64_t JUMP[] = { 0x8c405782bca686adULL, 0xc44f35946fef49c6ULL };
+
+    uint64_t s0 = 0;
+    uint64_t s1 = 0;
+    for (unsigned i = 0; i < sizeof JUMP / sizeof *JUMP; i++)
+        for (int b = 0; b < 64; b++)
+        {
+            if (JUMP[i] & 1ULL << b)
+            {
+                s0 ^= ctx->s[0];
+                s1 ^= ctx->s[1];
+            }
+            (void)xorshift128plus_next_r(ctx);
+        }
+    ctx->s[0] = s0;
+    ctx->s[1] = s1;
+}
+
+uint64_t xorshift128plus_next (void)
+{
+    return xorshift128plus_next_r(&xorshift128plus_g);
+}
+
+void xorshift128plus_seed (uint64_t x)
+{
+    xorshift128plus_seed_r(&xorshift128plus_g, x);
+}
+
+/* Filling a buffer from XORSHIFT128PLUS_LANES xorshift128+ streams at once:
+   out[L * j + i] is the j-th output of lane i, so each fill of n values
+   steps every lane (n + L - 1) / L times, and fills of multiples of L
+   join up into one long fill. The lanes are the same recurrence as
+   xorshift128plus_next(), in the vector types of GCC and Clang, which
+   compile to SSE2 or AVX2 as the target allows, or to scalar code. Lane 0
+   starts where xorshift128plus_seed_r() does, and each lane after it 2^64
+   steps on, so the lanes never overlap. */
+
+void xorshift128plus_lanes_seed (xorshift128plus_lanes_t *state, uint64_t x)
+{
+    xorshift128plus_t ctx;
+    xorshift128plus_seed_r(&ctx, x);
+    for (int i = 0; i < XORSHIFT128PLUS_LANES; i++)
+    {
+        state->s[0][i] = ctx.s[0];
+        state->s[1][i] = ctx.s[1];
+        xorshift128plus_jump(&ctx);
+    }
+}
+
+#if defined(__GNUC__)
+
+typedef uint64_t xorshift128plus_v __attribute__ ((vector_size (8 * XORSHIFT128PLUS_LANES)));
+
+void xorshift128plus_fill (xorshift128plus_lanes_t *state, uint64_t *out, size_t n)
+{
+    xorshift128plus_v s1, s0, r;
+    memcpy(&s1, state->s[0], sizeof(s1));
+    memcpy(&s0, state->s[1], sizeof(s0));
+    for (size_t i = 0; i < n; i += XORSHIFT128PLUS_LANES)
+    {
+        xorshift128plus_v t = s1 ^ (s1 << 23); // a
+        s1 = s0;
+        s0 = t ^ s0 ^ (t >> 17) ^ (s0 >> 26); // b, c
+        r = s0 + s1;
+        memcpy(&out[i], &r, ((n - i) < XORSHIFT128PLUS_LANES) ? (8 * (n - i)) : sizeof(r));
+    }
+    memcpy(state->s[0], &s1, sizeof(s1));
+    memcpy(state->s[1], &s0, sizeof(s0));
+}
+
+#else
+
+void xorshift128plus_fill (xorshift128plus_lanes_t *state, uint64_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i += XORSHIFT128PLUS_LANES)
+    {
+        for (int l = 0; l < XORSHIFT128PLUS_LANES; l++)
+        {
+            uint64_t s1 = state->s[0][l];
+            const uint64_t s0 = state->s[1][l];
+            state->s[0][l] = s0;
+            s1 ^= s1 << 23; // a
+            state->s[1][l] = s1 ^ s0 ^ (s1 >> 17) ^ (s0 >> 26); // b, c
+            if ((i + l) < n) out[i + l] = state->s[1][l] + s0;
+        }
+    }
+}
+
+#endif
+
 /* xorshift1024* is a fast, top-quality generator. If 1024 bits of state are too
    much, try a xorshift128+ or a xorshift64* generator. */
 
@@ -78,24 +191,61 @@ void xorshift128plus_seed (uint64_t x)
    a 64-bit seed,  we suggest to seed a xorshift64* generator and use its
    output to fill s. */
 
-static uint64_t xorshift1024star_s[16]; 
-static int xorshift1024star_p = 0;
+static xorshift1024star_t xorshift1024star_g;
 
-uint64_t xorshift1024star_next (void)
+uint64_t xorshift1024star_next_r (xorshift1024star_t *ctx)
 { 
-    uint64_t s0 = xorshift1024star_s[xorshift1024star_p];
-    uint64_t s1 = xorshift1024star_s[xorshift1024star_p = (xorshift1024star_p + 1) & 15];
+    uint64_t s0 = ctx->s[ctx->p];
+    uint64_t s1 = ctx->s[ctx->p = (ctx->p + 1) & 15];
     s1 ^= s1 << 31; // a
     s1 ^= s1 >> 11; // b
     s0 ^= s0 >> 30; // c
-    return (xorshift1024star_s[xorshift1024star_p] = s0 ^ s1 ) * 1181783497276652981LL; 
+    return (ctx->s[ctx->p] = s0 ^ s1 ) * 1181783497276652981LL; 
 }
 
-void xorshift1024star_seed (uint64_t x)
+void xorshift1024star_seed_r (xorshift1024star_t *ctx, uint64_t x)
 {
     int i;
-    xorshift64star_seed(x);
-    for (i = 0; i < 16; i++) xorshift1024star_s[i] = xorshift64star_next();
+    xorshift64star_t seeder;
+    xorshift64star_seed_r(&seeder, x);
+    for (i = 0; i < 16; i++) ctx->s[i] = xorshift64star_next_r(&seeder);
+    ctx->p = 0;
+}
+
+/* The jump function is equivalent to 2^512 calls to next; it can be used to
+   generate 2^512 non-overlapping subsequences for parallel computations. */
+
+void xorshift1024star_jump (xorshift1024star_t *ctx)
+{
+    static const uint64_t JUMP[] = { 0x84242f96eca9c41dULL,
+        0xa3c65b8776f96855ULL, 0x5b34a39f070b5837ULL, 0x4489affce4f31a1eULL,
+        0x2ffeeb0a48316f40ULL, 0xdc2d9891fe68c022ULL, 0x3659132bb12fea70ULL,
+        0xaac17d8efa43cab8ULL, 0xc4cb815590989b13ULL, 0x5ee975283d71c93bULL,
+        0x691548c86c1bd540ULL, 0x7910c41d10a1e6a5ULL, 0x0b5fc64563b3e2a8ULL,
+        0x047f7684e9fc949dULL, 0xb99181f2d8f685caULL, 0x284600e3f30e38c3ULL
+    };
+
+    uint64_t t[16] = { 0 };
+    for (unsigned i = 0; i < sizeof JUMP / sizeof *JUMP; i++)
+        for (int b = 0; b < 64; b++)
+        {
+            if (JUMP[i] & 1ULL << b)
+                for (int j = 0; j < 16; j++)
+                    t[j] ^= ctx->s[(j + ctx->p) & 15];
+            (void)xorshift1024star_next_r(ctx);
+        }
+    for (int j = 0; j < 16; j++)
+        ctx->s[(j + ctx->p) & 15] = t[j];
+}
+
+uint64_t xorshift1024star_next (void)
+{
+    return xorshift1024star_next_r(&xorshift1024star_g);
+}
+
+void xorshift1024star_seed (uint64_t x)
+{
+    xorshift1024star_seed_r(&xorshift1024star_g, x);
 }
 
 /* ************************ testing code below ************************** */
@@ -135,20 +285,20 @@ double xorshift01 (void *unused0, void *unused1)
 
 void write_state_64 (void *unused) 
 {
-    printf( "%llu\n", (unsigned long long)xorshift64star_x);
+    printf( "%llu\n", (unsigned long long)xorshift64star_g.x);
 }
 
 void write_state_128 (void *unused) 
 {
     for( int i = 0; i < 2; i++ )
-        printf("%s%llu", i ? " " : "", (unsigned long long)xorshift128plus_s[i]);
+        printf("%s%llu", i ? " " : "", (unsigned long long)xorshift128plus_g.s[i]);
     printf("\n");
 }
 
 void write_state_1024 (void *unused) 
 {
     for( int i = 0; i < 16; i++ )
-        printf("%s%llu", i ? " " : "", (unsigned long long)xorshift1024star_s[i]);
+        printf("%s%llu", i ? " " : "", (unsigned long long)xorshift1024star_g.s[i]);
     printf("\n");
 }
 
@@ -4,16 +4,62 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
 #include <stdint.h>
 
 uint64_t murmurhash3_avalanche (uint64_t x);
 
+/* Each generator's state is a context; the functions without one share a
+   single static context per generator, so are not thread safe. A jump
+   moves a context as far on as a great many calls to next, so contexts
+   jumped 1, 2, ... times from one seed give non-overlapping streams. */
+
+typedef struct xorshift64star_s
+{
+    uint64_t x;
+} xorshift64star_t;
+
+typedef struct xorshift128plus_s
+{
+    uint64_t s[2];
+} xorshift128plus_t;
+
+typedef struct xorshift1024star_s
+{
+    uint64_t s[16];
+    int      p;
+} xorshift1024star_t;
+
+uint64_t xorshift64star_next_r (xorshift64star_t *ctx);
+void     xorshift64star_seed_r (xorshift64star_t *ctx, uint64_t x);
+
+uint64_t xorshift128plus_next_r (xorshift128plus_t *ctx);
+void     xorshift128plus_seed_r (xorshift128plus_t *ctx, uint64_t x);
+void     xorshift128plus_jump (xorshift128plus_t *ctx); /* 2^64 steps */
+
+uint64_t xorshift1024star_next_r (xorshift1024star_t *ctx);
+void     xorshift1024star_seed_r (xorshift1024star_t *ctx, uint64_t x);
+void     xorshift1024star_jump (xorshift1024star_t *ctx); /* 2^512 steps */
+
 uint64_t xorshift64star_next (void);
 void     xorshift64star_seed (uint64_t x);
 
 uint64_t xorshift128plus_next (void);
 void     xorshift128plus_seed (uint64_t x);
 
+/* XORSHIFT128PLUS_LANES xorshift128+ streams a jump apart, stepped
+   together; the caller owns the state, so each thread can have its own */
+
+#define XORSHIFT128PLUS_LANES 4
+
+typedef struct xorshift128plus_lanes_s
+{
+    uint64_t s[2][XORSHIFT128PLUS_LANES];
+} xorshift128plus_lanes_t;
+
+void     xorshift128plus_lanes_seed (xorshift128plus_lanes_t *state, uint64_t x);
+void     xorshift128plus_fill (xorshift128plus_lanes_t *state, uint64_t *out, size_t n);
+
 uint64_t xorshift1024star_next (void);
 void     xorshift1024star_seed (uint64_t x);
 